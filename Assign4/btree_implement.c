@@ -1,4 +1,5 @@
 #include "btree_implement.h"
+#include "dblog.h"
 #include "dt.h"
 #include "string.h"
 #include "stdlib.h"
@@ -9,7 +10,7 @@ Value* createIntValue(int num);
 Value * createIntValue(int num) {
     Value * valueNum = (Value *)calloc(1, sizeof(Value));
     if (valueNum == NULL) {
-        printf("\n NULL | ERROR : unable to allocate memery for value. check it. \n");
+        DB_LOG_ERROR("NULL | ERROR : unable to allocate memery for value. check it.");
         exit(EXIT_FAILURE);
     }
 
@@ -21,7 +22,7 @@ Value * createIntValue(int num) {
 NodeRecordData * makeRecord(RID * rid) {
     NodeRecordData * record = (NodeRecordData *) calloc(1, sizeof(NodeRecordData));
     if (record == NULL) {
-        printf("\n NULL | ERROR : Memory allocation for records failed. \n");
+        DB_LOG_ERROR("NULL | ERROR : Memory allocation for records failed.");
         exit(RC_INSERT_ERROR);
     } 
 
@@ -31,24 +32,24 @@ NodeRecordData * makeRecord(RID * rid) {
 
 BpTNode * createNewTree(BPTreeManagement * treeManager, Value* key, NodeRecordData* pointer) {
     if (treeManager == NULL) {
-        printf("\n NULL | ERROR : function Parameter - treeManager is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - treeManager is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\n NULL | ERROR : function Parameter - key is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - key is NULL.");
         exit(EXIT_FAILURE);
     } if (pointer == NULL) {
-        printf("\n NULL | ERROR : function Parameter - pointer is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - pointer is NULL.");
         exit(EXIT_FAILURE);
     }
 
     if (treeManager->orderType <= 0) {
-        printf("NULL | Error: The orderType is invalid and is <= 0. The value presented here is : %d \n", treeManager->orderType);
+        DB_LOG_ERROR("NULL | Error: The orderType is invalid and is <= 0. The value presented here is : %d", treeManager->orderType);
         return NULL;
     }
 
     BpTNode * bpTree = createLeaf(treeManager);
     if (bpTree == NULL) {
-        printf("Error: Failed to create a new leaf node in createNewTree.\n");
+        DB_LOG_ERROR("Error: Failed to create a new leaf node in createNewTree.");
         return NULL;
     }
 
@@ -67,19 +68,19 @@ BpTNode * createNewTree(BPTreeManagement * treeManager, Value* key, NodeRecordDa
 
 BpTNode * insertIntoLeaf(BPTreeManagement * treeManager, BpTNode * leafNode, Value* key, NodeRecordData* pointer) {
     if (treeManager == NULL) {
-        printf("\n NULL | ERROR : function Parameter - treeManager is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - treeManager is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\n NULL | ERROR : function Parameter - key is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - key is NULL.");
         exit(EXIT_FAILURE);
     } if (pointer == NULL) {
-        printf("\n NULL | ERROR : function Parameter - pointer is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - pointer is NULL.");
         exit(EXIT_FAILURE);
     } if (leafNode == NULL) {
-        printf("\n NULL | ERROR : function Parameter - leaf is NULL. \n");
+        DB_LOG_ERROR("NULL | ERROR : function Parameter - leaf is NULL.");
         exit(EXIT_FAILURE);
     } if (leafNode->totalKeys >= (treeManager->orderType - 1)) {
-        fprintf(stderr, "Error: Leaf node is full, cannot insert new key.\n");
+        DB_LOG_ERROR("Error: Leaf node is full, cannot insert new key.");
         return NULL;
     }
 
@@ -109,23 +110,23 @@ BpTNode * insertIntoLeaf(BPTreeManagement * treeManager, BpTNode * leafNode, Val
 BpTNode * insertIntoLeafAfterSplitting(BPTreeManagement * treeManager, BpTNode * leaf, Value* key, NodeRecordData* pointer) {
   
     if (treeManager == NULL) {
-        printf("\n Error: treeManager is NULL. \n");
+        DB_LOG_ERROR("Error: treeManager is NULL.");
         exit(EXIT_FAILURE);
     } if (leaf == NULL) {
-        printf("\n Error: leaf is NULL. \n");
+        DB_LOG_ERROR("Error: leaf is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\n Error: key is NULL. \n");
+        DB_LOG_ERROR("Error: key is NULL.");
         exit(EXIT_FAILURE);
     } if (pointer == NULL) {
-        printf("\n Error: pointer is NULL. \n");
+        DB_LOG_ERROR("Error: pointer is NULL.");
         exit(EXIT_FAILURE);
     }
     
     int ithInsert = 0, orderType = treeManager->orderType;
     BpTNode * newNode = createLeaf(treeManager);
     if (newNode == NULL) {
-        printf("Error: Memory Allocation for new leaf node failed.\n");
+        DB_LOG_ERROR("Error: Memory Allocation for new leaf node failed.");
         exit(EXIT_FAILURE);
     }
 
@@ -197,33 +198,33 @@ BpTNode * insertIntoLeafAfterSplitting(BPTreeManagement * treeManager, BpTNode *
 
 BpTNode * insertIntoNodeAfterSplitting(BPTreeManagement * treeManager, BpTNode * prevNode, int leftI, Value* key, BpTNode * right) {
    if (treeManager == NULL) {
-        printf("\nError: treeManager struct is NULL and cannot be used further\n");
+        DB_LOG_ERROR("Error: treeManager struct is NULL and cannot be used further");
         exit(EXIT_FAILURE);
     } if (prevNode == NULL) {
-        printf("\nError: oldNode struct is NULL and cannot be used further\n");
+        DB_LOG_ERROR("Error: oldNode struct is NULL and cannot be used further");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\nError: key is NULL and cannot be used further\n");
+        DB_LOG_ERROR("Error: key is NULL and cannot be used further");
         exit(EXIT_FAILURE);
     } if (right == NULL) {
-        printf("\nError: right Node is NULL and cannot be used further\n");
+        DB_LOG_ERROR("Error: right Node is NULL and cannot be used further");
         exit(EXIT_FAILURE);
     }
 
     int orderType = treeManager->orderType;
     BpTNode * newBTNode = createNode(treeManager);
     if (newBTNode == NULL) {
-        printf("\nError: A new node is not created.\n");
+        DB_LOG_ERROR("Error: A new node is not created.");
         exit(EXIT_FAILURE);
     }
 
     BpTNode ** newPtr = malloc((orderType + 1) * sizeof(BpTNode *));
     Value ** newKeys = malloc (orderType * sizeof(Value*));
     if (newPtr == NULL) {
-        printf("\nError: Memory allocation for ptrs went wrong.\n");
+        DB_LOG_ERROR("Error: Memory allocation for ptrs went wrong.");
         exit(EXIT_FAILURE);
     } if (newKeys == NULL) {
-        printf("\nError: Memory allocation for keys went wrong.\n");
+        DB_LOG_ERROR("Error: Memory allocation for keys went wrong.");
         exit(EXIT_FAILURE);
     }
 
@@ -282,16 +283,16 @@ BpTNode * insertIntoNodeAfterSplitting(BPTreeManagement * treeManager, BpTNode *
 BpTNode * insertIntoParent(BPTreeManagement * treeManager, BpTNode * left, Value* key, BpTNode * right) {
 
     if (treeManager == NULL) {
-        printf("\nError: tree manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: tree manager struct is NULL.");
         exit(EXIT_FAILURE);
     } if (left == NULL) {
-        printf("\nError: left struct is NULL.\n");
+        DB_LOG_ERROR("Error: left struct is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\nError: key struct is NULL.\n");
+        DB_LOG_ERROR("Error: key struct is NULL.");
         exit(EXIT_FAILURE);
     } if (right == NULL) {
-        printf("\nError: right struct is NULL.\n");
+        DB_LOG_ERROR("Error: right struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
@@ -312,10 +313,10 @@ int getLeftIndex(BpTNode * parent, BpTNode * left) {
     int leftI = 0;
 
     if (parent == NULL ) {
-        printf("Error: The parent struct is NULL.\n");
+        DB_LOG_ERROR("Error: The parent struct is NULL.");
         return -1;
     } if (left == NULL) {
-        printf("Error: The parent struct is NULL.\n");
+        DB_LOG_ERROR("Error: The parent struct is NULL.");
         return -1;
     }
 
@@ -324,7 +325,7 @@ int getLeftIndex(BpTNode * parent, BpTNode * left) {
     }
 
     if (leftI > parent->totalKeys) {
-        printf("\nThe left index is greater than parents total keys in getLeftIndex().\n");
+        DB_LOG_ERROR("The left index is greater than parents total keys in getLeftIndex().");
         return -1;
     } else {
         return leftI;
@@ -333,21 +334,21 @@ int getLeftIndex(BpTNode * parent, BpTNode * left) {
 
 BpTNode * insertIntoNode(BPTreeManagement * treeManager, BpTNode * parent, int prevIndex, Value * key, BpTNode * right) {
     if (treeManager == NULL) {
-        printf("\nError: The tree Manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: The tree Manager struct is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\nError: The key struct is NULL.\n");
+        DB_LOG_ERROR("Error: The key struct is NULL.");
         exit(EXIT_FAILURE);
     } if (parent == NULL) {
-        printf("\nError: The parent struct is NULL.\n");
+        DB_LOG_ERROR("Error: The parent struct is NULL.");
         exit(EXIT_FAILURE);
     } if (right == NULL) {
-        printf("\nError: The right struct is NULL.\n");
+        DB_LOG_ERROR("Error: The right struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
     if (prevIndex < 0 || prevIndex > parent->totalKeys) {
-        printf("\nError: Cannot be inserted because previous index is greater than or less than zero total keys present. \n");
+        DB_LOG_ERROR("Error: Cannot be inserted because previous index is greater than or less than zero total keys present.");
         exit(EXIT_FAILURE);
     }
 
@@ -368,23 +369,23 @@ BpTNode * insertIntoNode(BPTreeManagement * treeManager, BpTNode * parent, int p
 
 BpTNode * insertIntoNewRoot(BPTreeManagement * treeManager, BpTNode * left, Value* key, BpTNode * right) {
     if (treeManager == NULL) {
-        printf("\nError: The tree Manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: The tree Manager struct is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\nError: The key struct is NULL.\n");
+        DB_LOG_ERROR("Error: The key struct is NULL.");
         exit(EXIT_FAILURE);
     } if (left == NULL) {
-        printf("\nError: The left struct is NULL.\n");
+        DB_LOG_ERROR("Error: The left struct is NULL.");
         exit(EXIT_FAILURE);
     } if (right == NULL) {
-        printf("\nError: The right struct is NULL.\n");
+        DB_LOG_ERROR("Error: The right struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
     // BpTNode *createNode(BPTreeManagement *treeManager)
     BpTNode * root = createNode(treeManager);
     if (root == NULL) {
-        printf("\n The new Node is not created properly. \n");
+        DB_LOG_ERROR("The new Node is not created properly.");
         exit(EXIT_FAILURE);
     }
 
@@ -414,7 +415,7 @@ void safeAssignParent(BpTNode * childrenNode, BpTNode * parentNode) {
 
 BpTNode * createNode(BPTreeManagement * treeManager) {
     if (treeManager == NULL) {
-        printf("\nError: The tree Manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: The tree Manager struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
@@ -422,7 +423,7 @@ BpTNode * createNode(BPTreeManagement * treeManager) {
 
     BpTNode * tempNode = (BpTNode *) malloc(sizeof(BpTNode));
     if (tempNode == NULL) {
-        printf("\n Error! The MEMORY ALLOCATION failed for BpTNode. \n");
+        DB_LOG_ERROR("Error! The MEMORY ALLOCATION failed for BpTNode.");
         return NULL;
     }
 
@@ -436,7 +437,7 @@ BpTNode * createNode(BPTreeManagement * treeManager) {
 
     tempNode->ptr = (void**) malloc(treeManager->orderType * sizeof(void*));
     if (!tempNode->ptr) {
-        printf("\n Error! The MEMORY ALLOCATION failed for void **. \n");
+        DB_LOG_ERROR("Error! The MEMORY ALLOCATION failed for void **.");
         
         tempNode->keyNode = NULL;
         free(tempNode->keyNode); 
@@ -458,14 +459,14 @@ BpTNode * createNode(BPTreeManagement * treeManager) {
 
 BpTNode * createLeaf(BPTreeManagement * treeManager) {
      if (treeManager == NULL) {
-        printf("\nError: The tree Manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: The tree Manager struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
     // BpTNode *createNode(BPTreeManagement *treeManager)
     BpTNode * leafNode = createNode(treeManager);
     if (leafNode == NULL) {
-        printf("\n The new Node is not created properly. \n");
+        DB_LOG_ERROR("The new Node is not created properly.");
         exit(EXIT_FAILURE);
     }
 
@@ -474,10 +475,8 @@ BpTNode * createLeaf(BPTreeManagement * treeManager) {
 }
 
 BpTNode * findLeafHelper(BpTNode * node, Value * key, int index) {
-    bool isgreater = isGreater(key, node->keyNode [index]);
-    bool isequal = isEqual(key, node->keyNode [index]);
-
-    if (index < node->totalKeys && (isgreater || isequal)) {
+    // keyNode [totalKeys] is not initialized, only compare within the keys of the node
+    if (index < node->totalKeys && (isGreater(key, node->keyNode [index]) || isEqual(key, node->keyNode [index]))) {
         return findLeafHelper(node, key, index + 1);
     } else {
         return findLeaf((BpTNode *)node->ptr[index], key);
@@ -494,10 +493,10 @@ BpTNode * findLeaf(BpTNode * root, Value * key) {
 
 NodeRecordData * findRecordHelper(BpTNode * node, Value * key, int index) {
     if (node == NULL ) {
-        printf("ERROR! The node is NULL.");
+        DB_LOG_ERROR("ERROR! The node is NULL.");
         return NULL;
     } if (index >= node->totalKeys) {
-        printf("ERROR! Index is greater than total keys");
+        DB_LOG_DEBUG("Index is greater than total keys, the key is not in the leaf");
         return NULL;
     }
 
@@ -522,10 +521,10 @@ NodeRecordData * findRecord(BpTNode * root, Value * key) {
 
 int getNeighborIndex(BpTNode * n) {
     if (n == NULL) {
-        printf("ERROR: The BpTNode is NULL. \n");
+        DB_LOG_ERROR("ERROR: The BpTNode is NULL.");
         return -1; 
     } if (n->internalNode == NULL) {
-        printf("\n ERROR! The Internal Node is NULL. \n");
+        DB_LOG_ERROR("ERROR! The Internal Node is NULL.");
         return -1;
     }
 
@@ -537,22 +536,22 @@ int getNeighborIndex(BpTNode * n) {
         i++;
     }
 
-    printf(stderr, "ERROR! Node is not available in any of the nodes.\n");
+    DB_LOG_ERROR("ERROR! Node is not available in any of the nodes.");
     return -1; 
 }
 
 BpTNode * removeEntryFromNode(BPTreeManagement * treeManager, BpTNode * bpTreeNode, Value * key, BpTNode * pointer) {
     if (treeManager == NULL) {
-        printf("\nError: The tree Manager struct is NULL.\n");
+        DB_LOG_ERROR("Error: The tree Manager struct is NULL.");
         exit(EXIT_FAILURE);
     } if (bpTreeNode == NULL) {
-        printf("\nError: The bpTreeNode struct is NULL.\n");
+        DB_LOG_ERROR("Error: The bpTreeNode struct is NULL.");
         exit(EXIT_FAILURE);
     } if (key == NULL) {
-        printf("\nError: The key value struct is NULL.\n");
+        DB_LOG_ERROR("Error: The key value struct is NULL.");
         exit(EXIT_FAILURE);
     } if (pointer == NULL) {
-        printf("\nError: The bpTreeNode-pointer struct is NULL.\n");
+        DB_LOG_ERROR("Error: The bpTreeNode-pointer struct is NULL.");
         exit(EXIT_FAILURE);
     }
 
@@ -600,7 +599,7 @@ BpTNode * removeEntryFromNode(BPTreeManagement * treeManager, BpTNode * bpTreeNo
 
 BpTNode * adjustRoot(BpTNode * bpTreeNode) {
     if (bpTreeNode == NULL) {
-        printf("Error: The bpTreeNode struct is NULL.\n");
+        DB_LOG_ERROR("Error: The bpTreeNode struct is NULL.");
         return NULL;
     }
 
@@ -634,13 +633,13 @@ BpTNode * adjustRoot(BpTNode * bpTreeNode) {
 
 BpTNode * mergeNodes(BPTreeManagement * treeManager, BpTNode * allbptNode, BpTNode * neighbor, int neighbor_index, int value) {
     if (treeManager == NULL) {
-        printf("\n Error: The given treeManager struct is Null\n");
+        DB_LOG_ERROR("Error: The given treeManager struct is Null");
         return NULL;
     } if (allbptNode == NULL) {
-        printf("\n Error: The given allbptNode struct is Null\n");
+        DB_LOG_ERROR("Error: The given allbptNode struct is Null");
         return NULL;
     } if (neighbor == NULL) {
-        printf("\n Error: The given neighbor struct is Null\n");
+        DB_LOG_ERROR("Error: The given neighbor struct is Null");
         return NULL;
     }
 
@@ -715,16 +714,16 @@ BpTNode * mergeNodes(BPTreeManagement * treeManager, BpTNode * allbptNode, BpTNo
 
 BpTNode * deleteEntry(BPTreeManagement * treeManager, BpTNode * allbptNode, Value* key, void* pointer) {
     if (treeManager == NULL) {
-        printf("\n Error: The given treeManager struct is Null\n");
+        DB_LOG_ERROR("Error: The given treeManager struct is Null");
         return NULL;
     } if (allbptNode == NULL) {
-        printf("\n Error: The given allbptNode struct is Null\n");
+        DB_LOG_ERROR("Error: The given allbptNode struct is Null");
         return NULL;
     } if (key == NULL) {
-        printf("\n Error: The given key struct is Null\n");
+        DB_LOG_ERROR("Error: The given key struct is Null");
         return NULL;
     } if (pointer == NULL) {
-        printf("\n Error: The given key struct is Null\n");
+        DB_LOG_ERROR("Error: The given key struct is Null");
         return NULL;
     }
 
@@ -782,10 +781,10 @@ BpTNode * deleteEntry(BPTreeManagement * treeManager, BpTNode * allbptNode, Valu
 
 BpTNode * delete(BPTreeManagement * treeManager, Value * key) {
     if (treeManager == NULL) {
-        printf("\n Error: The given treeManager struct is Null\n");
+        DB_LOG_ERROR("Error: The given treeManager struct is Null");
         return NULL;
     } if (key == NULL) {
-        printf("\n Error: The given key Value struct is Null\n");
+        DB_LOG_ERROR("Error: The given key Value struct is Null");
         return NULL;
     } 
 
@@ -796,10 +795,10 @@ BpTNode * delete(BPTreeManagement * treeManager, Value * key) {
     BpTNode * searchedRecord = findRecord(treeManager->rootNode, key);
     
     if (searchedRecord == NULL) {
-        printf("Error: The searched record is not found (or) not available in the B+Tree\n");
+        DB_LOG_DEBUG("The searched record is not found (or) not available in the B+Tree");
         return treeManager->rootNode; 
     } if (searchedLeafNode == NULL) {
-        printf("Error: The searched leafNode is not found (or) not available in the B+Tree\n");
+        DB_LOG_DEBUG("The searched leafNode is not found (or) not available in the B+Tree");
         return treeManager->rootNode; 
     }
 
@@ -817,13 +816,13 @@ BpTNode * delete(BPTreeManagement * treeManager, Value * key) {
 
 BpTNode * redistributeNodes(BpTNode * mainBPTree, BpTNode * allBPTree, BpTNode * neighbor, int neighbor_index, int k_prime_index, int k_prime) {
     if (mainBPTree == NULL) {
-        printf("\n Error: The given mainBPTree struct is Null\n");
+        DB_LOG_ERROR("Error: The given mainBPTree struct is Null");
         return NULL;
     } if (allBPTree == NULL) {
-        printf("\n Error: The given allBPTree struct is Null\n");
+        DB_LOG_ERROR("Error: The given allBPTree struct is Null");
         return NULL;
     } if (neighbor == NULL) {
-        printf("\n Error: The given neighbor struct is Null\n");
+        DB_LOG_ERROR("Error: The given neighbor struct is Null");
         return NULL;
     } 
 
@@ -897,13 +896,13 @@ void enqueue(BPTreeManagement * treeManager, BpTNode * tempNode) {
 
 BpTNode * dequeue_helper(BPTreeManagement * treeManager) {
     if (treeManager == NULL) {
-        printf("\n Error: The given treeManager struct is Null\n");
+        DB_LOG_ERROR("Error: The given treeManager struct is Null");
         return NULL;
     } 
 
     BpTNode * tempNode = treeManager->queueNode;
     if (tempNode == NULL) {
-        printf("\n Error: The given treeManager->queueNode variable is NULL. \n");
+        DB_LOG_ERROR("Error: The given treeManager->queueNode variable is NULL.");
         return NULL;
     } 
 
@@ -914,7 +913,7 @@ BpTNode * dequeue_helper(BPTreeManagement * treeManager) {
 
 BpTNode * dequeue(BPTreeManagement * treeManager) {
     if (treeManager == NULL) {
-        printf("\n Error: The given treeManager struct is Null\n");
+        DB_LOG_ERROR("Error: The given treeManager struct is Null");
         return NULL;
     } 
     if (treeManager->queueNode == NULL) 
@@ -926,7 +925,7 @@ BpTNode * dequeue(BPTreeManagement * treeManager) {
 
 int pathForRoot(BpTNode * root, BpTNode * child) {
     if (child == NULL) {
-        printf("\n The child BpTNode is NULL.\n");
+        DB_LOG_ERROR("The child BpTNode is NULL.");
         return -1;
     }
 
@@ -937,10 +936,10 @@ int pathForRoot(BpTNode * root, BpTNode * child) {
 
 bool isLess(Value * K1, Value * K2) {
     if (K1 == NULL) {
-        printf("\nError: The K1 is NULL. \n");
+        DB_LOG_ERROR("Error: The K1 is NULL.");
         return FALSE; 
     } if (K2 == NULL) {
-        printf("\nError: The K2 is NULL. \n");
+        DB_LOG_ERROR("Error: The K2 is NULL.");
         return FALSE; 
     }
 
@@ -968,15 +967,15 @@ bool isLess(Value * K1, Value * K2) {
 
 bool isGreater(Value * key1, Value * key2) {
     if (key1 == NULL) {
-        printf("\nError: The key1 is NULL. \n");
+        DB_LOG_ERROR("Error: The key1 is NULL.");
         return FALSE; 
     } if (key2 == NULL) {
-        printf("\nError: The key2 is NULL. \n");
+        DB_LOG_ERROR("Error: The key2 is NULL.");
         return FALSE; 
     }
 
     if (key1->dt != key2->dt) {
-        printf("\n In isGreater() .The both datatypes are not same. \n");
+        DB_LOG_ERROR("In isGreater() .The both datatypes are not same.");
         return FALSE;  
     }
 
@@ -1008,15 +1007,15 @@ bool isGreater(Value * key1, Value * key2) {
 
 bool isEqual(Value * key1, Value * key2) {
     if (key1 == NULL) {
-        printf("\nError: The key1 is NULL. \n");
+        DB_LOG_ERROR("Error: The key1 is NULL.");
         return FALSE; 
     } if (key2 == NULL) {
-        printf("\nError: The key2 is NULL. \n");
+        DB_LOG_ERROR("Error: The key2 is NULL.");
         return FALSE; 
     }
 
     if (key1->dt != key2->dt) {
-        printf("\n In isEqual(). The both datatypes are not same. \n");
+        DB_LOG_ERROR("In isEqual(). The both datatypes are not same.");
         return FALSE;  
     }
     
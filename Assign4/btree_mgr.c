@@ -4,6 +4,7 @@
 #include "buffer_mgr.h"
 #include "tables.h"
 #include "btree_implement.h"
+#include "dblog.h"
 #include "stdlib.h"
 /* ============== FUNCTION DECLARATIONS STARTED ============== */
 
@@ -40,13 +41,13 @@ BPTreeManagement * treeTracker = NULL;
 
 RC initIndexManager (void * mgmtData) {
     initStorageManager();
-    printf("Index manager initialized.");
+    DB_LOG_INFO("Index manager initialized.");
     return RC_OK;
 }
 
 RC shutdownIndexManager () {
     treeTracker = NULL;
-    printf("Operation shut down index manager successful.");
+    DB_LOG_INFO("Operation shut down index manager successful.");
     return RC_OK;
 }
 
@@ -59,7 +60,7 @@ RC createBtree(char *idxId, DataType keyType, int n) {
     RC status = RC_OK;
 
     if (n > capacity) {
-        printf("\nThe n has reached maximum nodes with n = %d & maximum nodes = %d, now you cannot add anything.\n", n, capacity);
+        DB_LOG_ERROR("The n has reached maximum nodes with n = %d & maximum nodes = %d, now you cannot add anything.", n, capacity);
         return RC_ORDER_TOO_HIGH_FOR_PAGE;
     }
 
@@ -80,7 +81,7 @@ RC createBtree(char *idxId, DataType keyType, int n) {
     BM_BufferPool * bufferPoolManager = (BM_BufferPool *) malloc(sizeof(BM_BufferPool));
     if (!bufferPoolManager) {
         free(treeTracker);
-        printf("\n Memory Allocation for bufferPoolManager FAILED. \n");
+        DB_LOG_ERROR("Memory Allocation for bufferPoolManager FAILED.");
         return RC_MEMORY_ALLOCATION_MANAGER_ERROR;
     }
 
@@ -122,7 +123,11 @@ RC openBtree(BTreeHandle **tree, char *idxId) {
 
     (*tree)->mgmtData = treeTracker;
 
-    RC initStatus = initBufferPool(&treeTracker->buffer, tree, 1000, RS_FIFO, NULL);
+    BM_SharedPool *sharedPool;
+    RC initStatus = getGlobalSharedPool(&sharedPool);
+    if (initStatus == RC_OK) {
+        initStatus = openSharedBufferPool(&treeTracker->buffer, sharedPool, idxId, 0);
+    }
     if (initStatus != RC_OK) {
         *tree = NULL;
         free(*tree);  
@@ -134,13 +139,13 @@ RC openBtree(BTreeHandle **tree, char *idxId) {
 
 RC closeBtree(BTreeHandle *tree) {
 	if (!tree) {
-        printf("\n tree is NULL. \n");
+        DB_LOG_ERROR("tree is NULL.");
         return RC_MANAGER_NULL_ERROR;
     }
 
 	BPTreeManagement * manager = (BPTreeManagement*) tree->mgmtData;
 	if (!manager) {
-        printf("\nInvalid Exception on tree. Error on closing BTree.\n");
+        DB_LOG_ERROR("Invalid Exception on tree. Error on closing BTree.");
         return RC_MANAGER_NULL_ERROR;
     }
 
@@ -160,18 +165,18 @@ RC closeBtree(BTreeHandle *tree) {
 
 RC deleteBtree(char *fileName) {
     if (fileName == NULL) {
-        printf("\n Tree is NULL. \n");        
+        DB_LOG_ERROR("Tree is NULL.");        
         return RC_INVALID_FILENAME;
     }
 
     // RC destroyPageFile(char *fileName)
     RC opStatus = destroyPageFile(fileName);
     if(opStatus != RC_OK) {
-        printf("\n Some issue while deleting BTree \n");
+        DB_LOG_ERROR("Some issue while deleting BTree");
         return RC_B_PLUS_TREE_NOT_DELETING;
     }
 
-    printf("\n B + Tree deleted SUCCESSFULLY.\n");
+    DB_LOG_INFO("B + Tree deleted SUCCESSFULLY.");
 
     return RC_OK;
 }
@@ -184,7 +189,7 @@ RC insertKey(BTreeHandle *tree, Value *key, RID rid) {
     
     NodeRecordData * records = findRecord(treeManager->rootNode, key);
     if (records != NULL) {
-        printf("The key that is going to be INSERTED is EXISTS already.");
+        DB_LOG_DEBUG("The key that is going to be INSERTED is EXISTS already.");
         return RC_ALREADY_EXISTED_KEY;
     } else if (treeManager->rootNode == NULL) {
 
@@ -229,18 +234,18 @@ RC findKey(BTreeHandle *tree, Value *key, RID *result) {
 RC getNumNodes(BTreeHandle *tree, int *result) {
 
     if (tree == NULL) {
-        printf("\nBTreeHandle is NULL.\n");
+        DB_LOG_ERROR("BTreeHandle is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     if (result == NULL) {
-        printf("\result is NULL.\n");
+        DB_LOG_ERROR("result is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     BPTreeManagement * treeManager = (BPTreeManagement *) tree->mgmtData;
     if (treeManager == NULL) {
-        printf("\n Cannot get the Number of nodes. \n");
+        DB_LOG_ERROR("Cannot get the Number of nodes.");
         return RC_NULL_FOR_TREE_MANAGER;
     }
 
@@ -251,18 +256,18 @@ RC getNumNodes(BTreeHandle *tree, int *result) {
 
 RC getNumEntries(BTreeHandle *tree, int *result) {
      if (tree == NULL) {
-        printf("\nBTreeHandle is NULL.\n");
+        DB_LOG_ERROR("BTreeHandle is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     if (result == NULL) {
-        printf("\result is NULL.\n");
+        DB_LOG_ERROR("result is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     BPTreeManagement * treePManager = (BPTreeManagement *) tree->mgmtData;
     if (treePManager == NULL) {
-        printf("\n Cannot get the Number of nodes. \n");
+        DB_LOG_ERROR("Cannot get the Number of nodes.");
         return RC_NULL_FOR_TREE_MANAGER;
     }
 
@@ -273,18 +278,18 @@ RC getNumEntries(BTreeHandle *tree, int *result) {
 
 RC getKeyType(BTreeHandle *tree, DataType *result) {
     if (tree == NULL) {
-        printf("\nBTreeHandle is NULL.\n");
+        DB_LOG_ERROR("BTreeHandle is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     if (result == NULL) {
-        printf("\result is NULL.\n");
+        DB_LOG_ERROR("result is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     BPTreeManagement * treePManager = (BPTreeManagement *)tree->mgmtData;
     if (treePManager == NULL) {
-        printf("\n Cannot get the Number of nodes. \n");
+        DB_LOG_ERROR("Cannot get the Number of nodes.");
         return RC_NULL_FOR_TREE_MANAGER;
     }
 
@@ -295,24 +300,24 @@ RC getKeyType(BTreeHandle *tree, DataType *result) {
  
 RC deleteKey(BTreeHandle *tree, Value *key) {
     if (tree == NULL) {
-        printf("\nBTreeHandle is NULL.\n");
+        DB_LOG_ERROR("BTreeHandle is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     if (key == NULL) {
-        printf("\nkey is NULL.\n");
+        DB_LOG_ERROR("key is NULL.");
         return RC_NULL_FOR_TREE_MANAGER; 
     }
 
     BPTreeManagement * managerData = (BPTreeManagement *) tree->mgmtData;
     if (managerData == NULL) {
-        printf("\n NULL - Cannot get the Number of nodes. \n");
+        DB_LOG_ERROR("NULL - Cannot get the Number of nodes.");
         return RC_NULL_FOR_TREE_MANAGER;    
     }
 
     void *flag = delete(managerData, key); 
     if (flag == NULL) {
-        printf("\n NULL - The RC for deletion is NULL. \n");
+        DB_LOG_ERROR("NULL - The RC for deletion is NULL.");
         return RC_BTREE_DELETE_FAILED; 
     }
 
@@ -349,22 +354,22 @@ BpTNode *findLeftmostLeafNode (BpTNode *node) {
 
 RC nextEntry(BT_ScanHandle *handle, RID *result) {
     if (handle == NULL) {
-        printf("NULL ERROR: Null pointer for Scan handler structure.\n");
+        DB_LOG_ERROR("NULL ERROR: Null pointer for Scan handler structure.");
         return RC_ERROR;
     }
 
     if (result == NULL) {
-        printf("NULL ERROR: Null pointer for RID structure .\n");
+        DB_LOG_ERROR("NULL ERROR: Null pointer for RID structure .");
         return RC_ERROR; 
     }
 
     NodeSearchManagement * searchStruct = (NodeSearchManagement *) handle->mgmtData;
     if (!searchStruct) {
-        printf("NULL EXCEPTION: If search manager structure is null.");
+        DB_LOG_ERROR("NULL EXCEPTION: If search manager structure is null.");
         return RC_IM_NO_MORE_ENTRIES;
     }
     if (!searchStruct->node) {
-        printf("NULL EXCEPTION: If search manager struct's nodes is null.");
+        DB_LOG_ERROR("NULL EXCEPTION: If search manager struct's nodes is null.");
         return RC_IM_NO_MORE_ENTRIES;
     }
 
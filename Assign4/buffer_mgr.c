@@ -1,567 +1,4809 @@
 #include<stdio.h>
 #include<stdlib.h>
+#include<string.h>
+#include<pthread.h>
+#include<stdatomic.h>
+#include<sched.h>
+#include<time.h>
+#include<sys/mman.h>
+#include<poll.h>
+#include<fcntl.h>
+#include<unistd.h>
 #include "buffer_mgr.h"
 #include "storage_mgr.h"
+#include "page_trace.h"
+#include "page_compress.h"
+#include "dblog.h"
 #include <math.h>
 
-int clockPointerCount = 0;
+#define NO_FRAME -1
 
-int lfuPointerCount = 0;
+#define MAX_PAGE_TABLE_SHARDS 64 // upper bound on the number of page table shards
+#define FRAMES_PER_SHARD 4 // a shard is only split off when it covers at least this many frames
 
-int sizeOfBuffer = 0; // total buffer size
+#define CLEANER_IDLE_WAIT_MS 100 // how long the page cleaner sleeps when there is nothing to write
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024) // alignment of the frame arena when huge pages are requested
+#define PREFETCH_QUEUE_SIZE 256 // pages waiting for the prefetch thread, further requests are dropped
+#define PREFETCH_BATCH_PAGES 16 // consecutive queued pages the prefetch thread reads as one batch
+#define SEQUENTIAL_RUN_TRIGGER 3 // consecutive pages pinned in order before read ahead starts
+#define STAT_STRIPES 16 // copies of the statistics counters, threads are spread over them
 
-int indexForRear = 0; // present rear index
+#define MAX_POOL_FILES 1024 // page files one pool can cache at the same time, e.g. the open tables
+#define NO_FILE -1
+#define ANY_FILE -1 // replacement candidates may belong to any file
+#define PIN_CHECK_ROUNDS 1000 // looks at a file's fix counts before a pin counts as held, see filePagesPinned()
 
-int hitCount = 0; // count of hits 
+#define GLOBAL_POOL_PAGES 1024 // frames of the pool shared by all tables and indexes
+#define GLOBAL_POOL_PREFETCH_WINDOW 8 // read ahead of sequential scans in that pool
 
-int writeCount = 0; // count for write operations
+#define DEFAULT_POOL_GROWTH 4 // without BM_PoolOptions.maxPages a pool can grow to this many times its initial size
+#define RESIZE_WAIT_MS 1000 // how long a shrink waits for pages pinned in the frames it gives up
+#define PRESSURE_POLL_MS 100 // how often the memory pressure watcher checks whether it has to stop
+#define PRESSURE_SHRINK_INTERVAL_MS 2000 // least time between two shrinks caused by memory pressure
+#define PRESSURE_SHRINK_DIVISOR 4 // a memory pressure event gives up this part (1/4) of the frames
+#define COMPRESSED_PAGE_LIMIT (PAGE_SIZE * 3 / 4) // replaced pages that do not compress below this are not kept
+#define COMPRESSED_PAGES_PER_BUCKET 4 // expected chain length of the compressed tier's hash table
+#define VICTIM_QUEUE_PAGES 64 // replaced pages waiting to be written to the victim cache, more are not cached
+#define NO_SLOT -1
+#define WARM_BATCH_PAGES 32 // pages a warm-up reads as one batch
+#define MANIFEST_VERSION 1
+#define MANIFEST_LINE_SIZE 4096 // longest line of a pool manifest, i.e. of a file name
+#define PSI_MEMORY_FILE "/proc/pressure/memory"
+#define PSI_MEMORY_TRIGGER "some 150000 2000000" // 150ms of memory stalls within 2s, allowed without privileges
 
+#define FLUSH_WRITERS 4 // threads forceFlushPool() writes with
+#define FLUSH_RUN_PAGES 64 // longest run of adjacent pages forceFlushPool() writes at once
+
+#define BULK_READ_RING_PAGES 16 // frames a bulk read cycles through, at most an eighth of the pool
+#define KEEP_HIT_STAMP -1 // a pin that leaves the frame's LRU position alone
+#define LRU_STALE_FRACTION 8 // a hit restamps its frame only once an eighth of the pool was stamped after it
+#define HIGH_PRIORITY_SWEEPS 3 // times a BM_PRIORITY_HIGH page is passed over before it can be replaced
+
+/*
+ * The storage manager keeps a single process wide FILE pointer, so every call into it
+ * from the buffer manager is serialized by this lock. Lookups and pins never take it.
+ */
+static pthread_mutex_t storageLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * The `FramesInPage` struct represents a page in memory with attributes such as dirty bit, fix count,
+ * data, page number, hit number, and reference number.
+ *
+ * dirtyBit - The `dirtyBit` property in the `FramesInPage` struct typically represents
+ * whether the page has been changed since it was last read from or written to the disk.
+ *
+ * fixCountInfo - The `fixCountInfo` property in the `FramesInPage` struct represents
+ * the number of times the page has been pinned in memory.
+ *
+ * {SM_PageHandle} data - This property is used to store the actual data or contents of the page.
+ *
+ * {PageNumber} pageNumber - The `pageNumber` property represents the page number of the page in memory.
+ *
+ * fileId - the page file the page belongs to, an index into the pool's file table. A page is
+ * identified by (fileId, pageNumber), the page table and all lookups compare both.
+ *
+ * hitNumber - The `hitNumber` property in the `FramesInPage` struct represents the
+ * number of times a page has been accessed or "hit" in the memory.
+ *
+ * refNumber - The `refNumber` property in the `FramesInPage` struct represents the
+ * reference number of the page.
+ *
+ * loadNumber - sequence number of the read that brought the page into the frame (FIFO order).
+ *
+ * ioInProgress - set while the page is being read from disk. Other threads asking for the
+ * same page wait on the shard's `ioDone` condition until it is cleared.
+ *
+ * nextInChain - index of the next frame in the same page table bucket, NO_FRAME at the end.
+ *
+ * onDirtyList - set while the frame is queued on the page cleaner's dirty frame list.
+ *
+ * latch - reader/writer latch protecting the page content, see latchPage().
+ *
+ * version - even while nobody holds the latch exclusively, odd while somebody does. Every
+ * exclusive latch moves it forward by two, which is what optimistic readers validate against.
+ *
+ * dirtyMarks - counts the calls of setFrameDirty(). An eviction that copies the page notices
+ * through it that the page was changed (and maybe written back) while it copied.
+ *
+ * retired - the frame is beyond the pool's current size, or being given up by a shrink. It is
+ * then neither on the free list nor a replacement candidate, see resizeBufferPool().
+ *
+ * priority - the BM_PagePriority of the last pinPageWithPriority() of the page, BM_PRIORITY_NORMAL
+ * when it is read in. spareSweeps - how often a BM_PRIORITY_HIGH page may still be passed over
+ * by the replacement strategy, see replacementCandidate().
+ *
+ * The page table links, ioInProgress, fileId and pageNumber only change while holding the lock of
+ * the shard the page hashes to. fixCountInfo is changed with atomic operations only: a pin adds one
+ * and then checks that the frame still holds the page, while a thread that takes a page out of
+ * a frame first sets pageNumber to NO_PAGE and then checks that the fix count did not move.
+ * Whichever of the two comes second sees the other and backs off.
+ */
+typedef struct PageStructure
+{
+    atomic_int dirtyBit;
+	atomic_int fixCountInfo;
+
+    SM_PageHandle data;
+	atomic_int pageNumber;
+	atomic_int fileId;
+
+	atomic_int hitNumber;
+	int refNumber;
+	atomic_int loadNumber;
+
+	atomic_bool ioInProgress;
+	atomic_int nextInChain;
+	atomic_bool onDirtyList;
+
+	pthread_rwlock_t latch;
+	atomic_ulong version;
+	atomic_uint generation;
+	atomic_uint dirtyMarks;
+
+	atomic_bool retired;
+
+	atomic_int priority;
+	atomic_int spareSweeps;
+} FramesInPage;
+
+/**
+ * One slice of the page table. A page always hashes to the same shard, and the shard's lock
+ * serializes changes to its buckets and to the frames chained into them. Lookups of pinned
+ * pages walk the chains without the lock, see findFrameUnlocked().
+ * Shards are cache line aligned so that threads working on different shards do not
+ * share a line.
+ */
+typedef struct PageTableShard
+{
+	pthread_mutex_t lock;
+	pthread_cond_t ioDone;
+	atomic_int *buckets;
+	int numBuckets;
+} __attribute__((aligned(64))) PageTableShard;
+
+/**
+ * The statistics counters of a pool, see BM_PoolStats.
+ */
+typedef enum PoolCounter {
+	STAT_HITS,
+	STAT_MISSES,
+	STAT_READS,
+	STAT_WRITES,
+	STAT_EVICTIONS,
+	STAT_DIRTY_EVICTIONS,
+	STAT_PIN_WAIT_NANOS,
+	STAT_VICTIM_SEARCHES,
+	STAT_VICTIM_RETRIES,
+	STAT_PREFETCH_READS,
+	STAT_CLEANER_WRITES,
+	STAT_COMPRESSED_STORES,
+	STAT_COMPRESSED_HITS,
+	STAT_VICTIM_CACHE_WRITES,
+	STAT_VICTIM_CACHE_HITS,
+	NUM_POOL_COUNTERS
+} PoolCounter;
+
+/**
+ * One copy of the statistics counters. Every thread adds to the stripe it was assigned to,
+ * so busy threads do not fight over the same cache line, and readers sum all stripes.
+ */
+typedef struct StatStripe
+{
+	atomic_long counters[NUM_POOL_COUNTERS];
+} __attribute__((aligned(64))) StatStripe;
+
+/**
+ * A page file opened on a pool, see openSharedBufferPool(). The slot is free while `fileName`
+ * is NULL. Taking and freeing slots is guarded by the pool's `filesLock`.
+ *
+ * quota - the most frames the file's pages may take, 0 for no limit.
+ * numResident - frames holding (or claimed for) a page of the file.
+ * lastPinnedPage, sequentialRun, prefetchedUpTo - read ahead state, see detectSequentialAccess().
+ */
+typedef struct PoolFile
+{
+	char *fileName;
+	int quota;
+	atomic_int numResident;
+
+	atomic_int lastPinnedPage;
+	atomic_int sequentialRun;
+	atomic_int prefetchedUpTo;
+} PoolFile;
+
+/**
+ * A replaced page kept compressed in the pool's second tier, see insertCompressedPage().
+ * Entries are chained into the tier's hash buckets and into one list from the newest to the
+ * oldest stored page, which is dropped first when the tier runs out of room.
+ */
+typedef struct CompressedPage
+{
+	int fileId;
+	PageNumber pageNum;
+	int size;
+	struct CompressedPage *nextInBucket;
+	struct CompressedPage *newer;
+	struct CompressedPage *older;
+	char data[];
+} CompressedPage;
+
+// states of a page slot in the victim cache file
+typedef enum VictimSlotState {
+	VICTIM_SLOT_FREE,
+	VICTIM_SLOT_WRITING, // the writer is copying a page into it
+	VICTIM_SLOT_VALID,
+	VICTIM_SLOT_STALE // invalidated while written or read, free once that is done
+} VictimSlotState;
+
+/**
+ * A page slot of the victim cache file, see queueVictimPage(). Slots that are being written or
+ * valid are chained into the victim cache's hash buckets by their page. `readers` counts the
+ * misses reading the slot right now.
+ */
+typedef struct VictimSlot
+{
+	int fileId;
+	PageNumber pageNum;
+	VictimSlotState state;
+	int readers;
+	int nextInBucket;
+} VictimSlot;
+
+// a replaced page waiting for the victim cache writer, its copy is in the pool's victimBuffers
+typedef struct VictimWrite
+{
+	int fileId;
+	PageNumber pageNum;
+	bool cancelled;
+} VictimWrite;
+
+// the pages warmBufferPool() reads for a file, sorted
+typedef struct WarmUpJob
+{
+	int fileId;
+	PageNumber *pageNums;
+	int numPages;
+	struct WarmUpJob *next;
+} WarmUpJob;
+
+// a page waiting for the prefetch thread
+typedef struct PrefetchRequest
+{
+	int fileId;
+	PageNumber pageNum;
+} PrefetchRequest;
+
+/**
+ * The bookkeeping of a buffer pool. A pool caches the pages of every file registered in `files`
+ * and is reached through the BufferPoolView of each BM_BufferPool opened on it.
+ *
+ * frames - the page frames of the pool, `frameCapacity` of them are allocated up front and
+ * `numFrames` are in use. Frames from `frameLimit` on take no new pages, which is below
+ * `numFrames` only while a shrink gives the frames above it up, see resizeBufferPool().
+ * shards - the page table, split into `numShards` independently locked parts.
+ * freeFrames - stack of frames that have never held a page (or were given back), guarded by `freeLock`.
+ * numClosingFiles - files whose pages are being handed back to the free list, see dropFilePages().
+ * hitCount - logical clock used to stamp frames for LRU. Hits on recently stamped frames leave it
+ *            alone, see stampHit(), so pins on a hot set of pages only read it.
+ * loadCount - sequence number handed to each newly read page for FIFO.
+ * numDirty - number of dirty frames.
+ * stats - striped statistics counters, see countEvent().
+ *
+ * The page cleaner fields are only used while a cleaner runs, see startPageCleaner().
+ * cleanerLock guards dirtyList (frames that became dirty since the cleaner last looked).
+ *
+ * The prefetch thread is started by the first prefetchPages() call. prefetchLock guards its
+ * request ring (prefetchQueue, prefetchHead, numPrefetchQueued) and `prefetchingFile`, the file
+ * of the page it is reading right now. readAheadFrames counts the frames it holds pinned for the
+ * pages it is reading, a pin that finds no frame waits for them on prefetchDone, see claimFrame().
+ * prefetchWindow is the read ahead of sequential scans, see detectSequentialAccess(), limited
+ * to half the pool. requestedPrefetchWindow is what the pool options asked for.
+ *
+ * The memory pressure watcher is started by startMemoryPressureWatch() and waits on
+ * `pressureFd`, a PSI trigger or a cgroup's memory.events file.
+ *
+ * A page trace is started by startPageTrace(). traceHeader maps the trace file (see page_trace.h)
+ * while `tracing` is set, and traceWriters counts the threads adding an event right now.
+ *
+ * The compressed tier keeps clean pages the pool replaced, up to `tierBudget` bytes (0 when the
+ * pool options left it off). tierLock guards the buckets, the newest to oldest list and tierBytes.
+ *
+ * The victim cache is a local file of `numVictimSlots` page slots that replaced clean pages are
+ * written to by a writer thread, see queueVictimPage(). victimFd is -1 if the pool has none.
+ * victimLock guards the slots, their hash buckets, the slot hand and the writer's queue
+ * (victimQueue, victimHead, numVictimQueued, with the page copies in victimBuffers).
+ *
+ * warmBufferPool() queues its jobs in `warmJobs` for the warm-up thread, which runs while
+ * `warmerActive` is set and ends when no job is left. warmLock guards the job list, the thread
+ * state and `warmingFile`, the file of the job the thread works on. manifestFile is the
+ * manifest a pool made by initBufferPoolWithOptions() is warmed from and dumped to.
+ */
+typedef struct BufferPoolManagement
+{
+	FramesInPage *frames;
+	atomic_int numFrames;
+	atomic_int frameLimit;
+	int frameCapacity;
+	pthread_mutex_t resizeLock;
+	ReplacementStrategy strategy;
+
+	pthread_mutex_t filesLock;
+	PoolFile files[MAX_POOL_FILES];
+
+	char *arena; // page data of all frames, frame i starts at arena + i * PAGE_SIZE
+	size_t arenaSize;
+
+	PageTableShard *shards;
+	int numShards;
+
+	pthread_mutex_t freeLock;
+	int *freeFrames;
+	int numFreeFrames;
+	atomic_int numClosingFiles;
+
+	atomic_int hitCount;
+	atomic_int loadCount;
+	atomic_int numDirty;
+
+	pthread_t cleanerThread;
+	atomic_bool cleanerRunning;
+	double cleanTarget;
+	pthread_mutex_t cleanerLock;
+	pthread_cond_t cleanerWakeup;
+	int *dirtyList;
+	int numDirtyListed;
+
+	pthread_t prefetchThread;
+	bool prefetcherStarted;
+	atomic_bool prefetcherRunning;
+	pthread_mutex_t prefetchLock;
+	pthread_cond_t prefetchWakeup;
+	pthread_cond_t prefetchDone;
+	PrefetchRequest prefetchQueue[PREFETCH_QUEUE_SIZE];
+	int prefetchHead;
+	int numPrefetchQueued;
+	int prefetchingFile;
+	atomic_int readAheadFrames;
+
+	atomic_int prefetchWindow;
+	int requestedPrefetchWindow;
+
+	pthread_t pressureThread;
+	pthread_mutex_t pressureLock;
+	atomic_bool pressureWatchRunning;
+	int pressureFd;
+	bool pressureFromPsi;
+	long memoryHighEvents;
+	atomic_int pressureMinFrames;
+
+	pthread_mutex_t traceLock;
+	atomic_bool tracing;
+	atomic_int traceWriters;
+	PageTraceHeader *traceHeader;
+	PageTraceEvent *traceEvents;
+	size_t traceSize;
+	struct timespec traceStart;
+
+	pthread_mutex_t tierLock;
+	long tierBudget;
+	long tierBytes;
+	CompressedPage **tierBuckets;
+	int numTierBuckets;
+	CompressedPage *tierNewest;
+	CompressedPage *tierOldest;
+
+	int victimFd;
+	int numVictimSlots;
+	VictimSlot *victimSlots;
+	int *victimBuckets;
+	int numVictimBuckets;
+	int victimHand;
+	pthread_t victimWriterThread;
+	bool victimWriterRunning;
+	pthread_mutex_t victimLock;
+	pthread_cond_t victimWakeup;
+	VictimWrite victimQueue[VICTIM_QUEUE_PAGES];
+	char *victimBuffers;
+	int victimHead;
+	int numVictimQueued;
+
+	pthread_t warmThread;
+	bool warmerStarted;
+	bool warmerActive;
+	atomic_bool warmCancelled;
+	pthread_mutex_t warmLock;
+	pthread_cond_t warmDone;
+	WarmUpJob *warmJobs;
+	int warmingFile;
+	char *manifestFile;
+
+	StatStripe stats[STAT_STRIPES];
+} BufferPoolManagement;
+
+/**
+ * The bookkeeping stored in `BM_BufferPool->mgmtData`: the pool that caches the page file and
+ * the file's slot in the pool's file table. A pool made by initBufferPool() belongs to its
+ * only view (`ownsPool`) and is shut down together with it.
+ */
+typedef struct BufferPoolView
+{
+	BufferPoolManagement *pool;
+	int fileId;
+	bool ownsPool;
+} BufferPoolView;
+
+/**
+ * The frames one sequence of pins cycles through, see createAccessRing(). Slot i holds the frame
+ * the ring last read `pages[i]` into, NO_FRAME while the slot is empty. A ring belongs to one
+ * scan and is not shared between threads.
+ */
+struct BM_AccessRing
+{
+	BufferPoolManagement *pool;
+	int fileId;
+	BM_AccessStrategy strategy;
+	int size;
+	int nextSlot;
+	int frames[BULK_READ_RING_PAGES];
+	PageNumber pages[BULK_READ_RING_PAGES];
+};
+
+// the pool shared by all tables and indexes, see getGlobalSharedPool()
+static pthread_mutex_t globalPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static BufferPoolManagement *globalPool = NULL;
+
+
+/* ==================================================== */
+
+static _Thread_local int statStripe = -1;
+static atomic_int nextStatStripe;
+
+/**
+ * Description:
+ * Adds `amount` to a statistics counter of the pool. Threads are handed stripes round robin
+ * the first time they count something.
+ */
+static void countEvent(BufferPoolManagement *pool, PoolCounter counter, long amount) {
+	if (statStripe < 0) {
+		statStripe = atomic_fetch_add(&nextStatStripe, 1) % STAT_STRIPES;
+	}
+	atomic_fetch_add_explicit(&pool->stats[statStripe].counters[counter], amount, memory_order_relaxed);
+}
+
+static long sumCounter(BufferPoolManagement *pool, PoolCounter counter) {
+	long sum = 0;
+	for (int i = 0; i < STAT_STRIPES; i++) {
+		sum += atomic_load_explicit(&pool->stats[i].counters[counter], memory_order_relaxed);
+	}
+	return sum;
+}
+
+/**
+ * Description:
+ * Adds an event to the pool's page trace, if one is running. Without a trace this is a single
+ * load. stopPageTrace() waits for the threads counted in traceWriters before it unmaps the file.
+ */
+static void tracePageEvent(BufferPoolManagement *pool, int fileId, PageNumber pageNum, PageTraceKind kind) {
+	if (!pool->tracing) {
+		return;
+	}
+
+	pool->traceWriters++;
+	if (pool->tracing) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+
+		PageTraceHeader *header = pool->traceHeader;
+		uint64_t slot = atomic_fetch_add((_Atomic uint64_t *) &header->numEvents, 1) % header->capacity;
+		PageTraceEvent *event = &pool->traceEvents[slot];
+
+		event->time = (now.tv_sec - pool->traceStart.tv_sec) * 1000000000L + (now.tv_nsec - pool->traceStart.tv_nsec);
+		event->pageNum = pageNum;
+		event->fileId = fileId;
+		event->kind = kind;
+		event->reserved = 0;
+	}
+	pool->traceWriters--;
+}
+
+/**
+ * Description:
+ * Counts a pin as hit or miss and traces it.
+ */
+static void countPin(BufferPoolManagement *pool, int fileId, PageNumber pageNum, bool hit) {
+	countEvent(pool, hit ? STAT_HITS : STAT_MISSES, 1);
+	DB_EVENT(hit ? DB_EVENT_PIN_HIT : DB_EVENT_PIN_MISS, fileId, pageNum);
+	tracePageEvent(pool, fileId, pageNum, hit ? PAGE_TRACE_HIT : PAGE_TRACE_MISS);
+}
+
+static long elapsedNanos(const struct timespec *start) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1000000000L + (now.tv_nsec - start->tv_nsec);
+}
+
+/**
+ * Description:
+ * The pool behind a BM_BufferPool and the slot of its page file, see BufferPoolView.
+ */
+static BufferPoolManagement *poolOf(BM_BufferPool *const bm) {
+	BufferPoolView *view = (BufferPoolView *) bm->mgmtData;
+	return (view != NULL) ? view->pool : NULL;
+}
+
+static int fileOf(BM_BufferPool *const bm) {
+	return ((BufferPoolView *) bm->mgmtData)->fileId;
+}
+
+/**
+ * Description:
+ * Spreads pages over shards and buckets. The shard is taken from the high bits of the
+ * hash and the bucket from the low bits, so consecutive pages land in different shards.
+ */
+static unsigned int hashPage(int fileId, PageNumber pageNum) {
+	unsigned int hash = ((unsigned int) pageNum + (unsigned int) fileId * 0x9E3779B9u) * 2654435761u;
+	return hash ^ (hash >> 15);
+}
+
+static PageTableShard *shardForPage(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	return &pool->shards[(hashPage(fileId, pageNum) >> 16) & (pool->numShards - 1)];
+}
+
+static atomic_int *bucketForPage(PageTableShard *shard, int fileId, PageNumber pageNum) {
+	return &shard->buckets[hashPage(fileId, pageNum) & (shard->numBuckets - 1)];
+}
+
+static int nextPowerOfTwo(int value) {
+	int power = 1;
+	while (power < value) {
+		power <<= 1;
+	}
+	return power;
+}
+
+/**
+ * Description:
+ * Returns the frame holding page `pageNum` of file `fileId`, or NO_FRAME. The caller must hold
+ * the lock of `shard`.
+ */
+static int lookupFrame(BufferPoolManagement *pool, PageTableShard *shard, int fileId, PageNumber pageNum) {
+	int frameIndex = *bucketForPage(shard, fileId, pageNum);
+
+	while (frameIndex != NO_FRAME) {
+		if (pool->frames[frameIndex].pageNumber == pageNum && pool->frames[frameIndex].fileId == fileId) {
+			return frameIndex;
+		}
+		frameIndex = pool->frames[frameIndex].nextInChain;
+	}
+	return NO_FRAME;
+}
+
+static void insertIntoPageTable(BufferPoolManagement *pool, PageTableShard *shard, int frameIndex) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+	atomic_int *bucket = bucketForPage(shard, frame->fileId, frame->pageNumber);
+	frame->nextInChain = *bucket;
+	*bucket = frameIndex;
+}
+
+static void removeFromPageTable(BufferPoolManagement *pool, PageTableShard *shard, int frameIndex, int fileId, PageNumber pageNum) {
+	atomic_int *link = bucketForPage(shard, fileId, pageNum);
+
+	while (*link != NO_FRAME) {
+		if (*link == frameIndex) {
+			*link = pool->frames[frameIndex].nextInChain;
+			break;
+		}
+		link = &pool->frames[*link].nextInChain;
+	}
+	pool->frames[frameIndex].nextInChain = NO_FRAME;
+}
+
+/**
+ * Description:
+ * Looks a page up without taking the shard lock. Chains may change under the walk, so the
+ * result is only a hint: it is exact for a page the caller has pinned (its frame can not be
+ * reused), and a miss must be confirmed under the lock. The walk is bounded because a frame
+ * can move to another chain while we are on it.
+ */
+static int findFrameUnlocked(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	int frameIndex = *bucketForPage(shardForPage(pool, fileId, pageNum), fileId, pageNum);
+
+	for (int steps = 0; frameIndex != NO_FRAME && steps < pool->numFrames; steps++) {
+		if (pool->frames[frameIndex].pageNumber == pageNum && pool->frames[frameIndex].fileId == fileId) {
+			return frameIndex;
+		}
+		frameIndex = pool->frames[frameIndex].nextInChain;
+	}
+	return NO_FRAME;
+}
+
+/**
+ * Description:
+ * Finds the frame of a page the caller has pinned, falling back to a locked lookup when the
+ * unlocked walk raced with a change of the chain.
+ */
+static int findPinnedFrame(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	int frameIndex = findFrameUnlocked(pool, fileId, pageNum);
+
+	if (frameIndex == NO_FRAME || pool->frames[frameIndex].fixCountInfo == 0) {
+		PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+
+		pthread_mutex_lock(&shard->lock);
+		frameIndex = lookupFrame(pool, shard, fileId, pageNum);
+		pthread_mutex_unlock(&shard->lock);
+	}
+	return frameIndex;
+}
+
+/**
+ * Description:
+ * Fills a page handle with a page pinned in `frameIndex`, including the frame's generation so
+ * that frameOfHandle() can go straight to the frame later on.
+ */
+static void setPageHandle(BufferPoolManagement *pool, BM_PageHandle *const page, int frameIndex, PageNumber pageNum) {
+	page->pageNum = pageNum;
+	page->data = pool->frames[frameIndex].data;
+	page->frameIndex = frameIndex;
+	page->generation = pool->frames[frameIndex].generation;
+}
+
+/**
+ * Description:
+ * The frame of a page handle filled by pinPage(). As long as the handle's page is pinned its
+ * frame keeps the generation recorded in the handle, so that is all there is to check. Handles
+ * that were not filled by a pin, or whose page was unpinned and replaced since, are looked up
+ * as in findPinnedFrame().
+ */
+static int frameOfHandle(BufferPoolManagement *pool, int fileId, BM_PageHandle *const page) {
+	int frameIndex = page->frameIndex;
+
+	if (frameIndex >= 0 && frameIndex < pool->frameCapacity) {
+		FramesInPage *frame = &pool->frames[frameIndex];
+		if (frame->generation == page->generation && frame->fixCountInfo > 0
+				&& frame->pageNumber == page->pageNum && frame->fileId == fileId) {
+			return frameIndex;
+		}
+	}
+	return findPinnedFrame(pool, fileId, page->pageNum);
+}
+
+/**
+ * Description:
+ * Drops one pin, never going below zero.
+ */
+static void releasePin(FramesInPage *frame) {
+	int fixCount = frame->fixCountInfo;
+
+	while (fixCount > 0 && !atomic_compare_exchange_weak(&frame->fixCountInfo, &fixCount, fixCount - 1)) {
+	}
+}
+
+/**
+ * Description:
+ * Queues a frame for the page cleaner, once, and wakes the cleaner when the pool has fewer
+ * clean frames than it is asked to keep.
+ */
+static void queueDirtyFrame(BufferPoolManagement *pool, int frameIndex) {
+	if (!pool->cleanerRunning || atomic_exchange(&pool->frames[frameIndex].onDirtyList, true)) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->cleanerLock);
+	if (pool->cleanerRunning) {
+		pool->dirtyList[pool->numDirtyListed++] = frameIndex;
+		if (pool->numFrames - pool->numDirty < pool->cleanTarget * pool->numFrames) {
+			pthread_cond_signal(&pool->cleanerWakeup);
+		}
+	} else {
+		pool->frames[frameIndex].onDirtyList = false;
+	}
+	pthread_mutex_unlock(&pool->cleanerLock);
+}
+
+/**
+ * Description:
+ * All changes of a frame's dirty bit go through setFrameDirty() and clearFrameDirty(), which keep
+ * `numDirty` in step and feed the page cleaner's dirty frame list.
+ *
+ * @return the previous value of the dirty bit.
+ */
+static int setFrameDirty(BufferPoolManagement *pool, int frameIndex) {
+	pool->frames[frameIndex].dirtyMarks++;
+	int wasDirty = atomic_exchange(&pool->frames[frameIndex].dirtyBit, 1);
+
+	if (!wasDirty) {
+		pool->numDirty++;
+		queueDirtyFrame(pool, frameIndex);
+	}
+	return wasDirty;
+}
+
+static int clearFrameDirty(BufferPoolManagement *pool, int frameIndex) {
+	int wasDirty = atomic_exchange(&pool->frames[frameIndex].dirtyBit, 0);
+
+	if (wasDirty) {
+		pool->numDirty--;
+	}
+	return wasDirty;
+}
+
+/**
+ * Description:
+ * Takes a clean frame away from the page it holds, following the protocol described at
+ * FramesInPage. The caller holds the shard lock and already owns `ownPins` of the frame's pins.
+ * A lock free pin does not take the shard lock, so it can pin, change, mark dirty and unpin the
+ * page after the caller saw the frame clean. The dirty bit is checked again once the fix count
+ * is claimed, which is when no such pin can be left in between.
+ *
+ * @return true if the frame was detached. It then has fix count 1, owned by the caller, and no
+ * longer counts against the quota of the page's file.
+ */
+static bool detachFrame(BufferPoolManagement *pool, PageTableShard *shard, int frameIndex, PageNumber pageNum, int ownPins) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+	int expected = ownPins;
+
+	frame->pageNumber = NO_PAGE;
+
+	if (!atomic_compare_exchange_strong(&frame->fixCountInfo, &expected, 1)) {
+		frame->pageNumber = pageNum;
+		return false;
+	}
+	if (frame->dirtyBit == 1) {
+		if (ownPins == 0) {
+			releasePin(frame);
+		}
+		frame->pageNumber = pageNum;
+		return false;
+	}
+
+	removeFromPageTable(pool, shard, frameIndex, frame->fileId, pageNum);
+	pool->files[frame->fileId].numResident--;
+	return true;
+}
+
+/**
+ * Description:
+ * The hash bucket of the victim cache slots holding page `pageNum` of file `fileId`.
+ */
+static int *victimBucketFor(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	return &pool->victimBuckets[hashPage(fileId, pageNum) & (pool->numVictimBuckets - 1)];
+}
+
+/**
+ * Description:
+ * Returns the victim cache slot mapped to page `pageNum` of file `fileId`, or NO_SLOT. The caller
+ * holds victimLock.
+ */
+static int lookupVictimSlot(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	int slot = *victimBucketFor(pool, fileId, pageNum);
+
+	while (slot != NO_SLOT && (pool->victimSlots[slot].fileId != fileId || pool->victimSlots[slot].pageNum != pageNum)) {
+		slot = pool->victimSlots[slot].nextInBucket;
+	}
+	return slot;
+}
+
+/**
+ * Description:
+ * Takes a slot out of the victim cache's page map. It is free again right away unless the writer
+ * or a reader still uses it, then it stays stale until they are done. The caller holds victimLock.
+ */
+static void unmapVictimSlot(BufferPoolManagement *pool, int slot) {
+	VictimSlot *victim = &pool->victimSlots[slot];
+	int *link = victimBucketFor(pool, victim->fileId, victim->pageNum);
+
+	while (*link != slot) {
+		link = &pool->victimSlots[*link].nextInBucket;
+	}
+	*link = victim->nextInBucket;
+	victim->nextInBucket = NO_SLOT;
+	victim->state = (victim->state == VICTIM_SLOT_WRITING || victim->readers > 0) ? VICTIM_SLOT_STALE : VICTIM_SLOT_FREE;
+}
+
+/**
+ * Description:
+ * Returns the position in the writer's queue of page `pageNum` of file `fileId`, or -1 if the
+ * page is not waiting to be written. The caller holds victimLock.
+ */
+static int findVictimWrite(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	for (int i = 0; i < pool->numVictimQueued; i++) {
+		int position = (pool->victimHead + i) % VICTIM_QUEUE_PAGES;
+		VictimWrite *write = &pool->victimQueue[position];
+
+		if (!write->cancelled && write->fileId == fileId && write->pageNum == pageNum) {
+			return position;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Description:
+ * Queues a copy of a replaced clean page for the victim cache writer. The caller just took the
+ * page's frame out of the page table and still holds the page's shard lock, so the page can only
+ * be read back, changed and written back (which invalidates the copy, see invalidateVictimPage())
+ * after the copy is queued. Nothing is queued if the cache already has the page, if the queue is
+ * full, or while a file is closed, see dropFilePages().
+ */
+static void queueVictimPage(BufferPoolManagement *pool, int fileId, PageNumber pageNum, const char *data) {
+	pthread_mutex_lock(&pool->victimLock);
+	if (pool->numClosingFiles == 0 && pool->numVictimQueued < VICTIM_QUEUE_PAGES
+			&& lookupVictimSlot(pool, fileId, pageNum) == NO_SLOT && findVictimWrite(pool, fileId, pageNum) < 0) {
+		int position = (pool->victimHead + pool->numVictimQueued) % VICTIM_QUEUE_PAGES;
+
+		pool->victimQueue[position].fileId = fileId;
+		pool->victimQueue[position].pageNum = pageNum;
+		pool->victimQueue[position].cancelled = false;
+		memcpy(pool->victimBuffers + (size_t) position * PAGE_SIZE, data, PAGE_SIZE);
+		pool->numVictimQueued++;
+		pthread_cond_signal(&pool->victimWakeup);
+	}
+	pthread_mutex_unlock(&pool->victimLock);
+}
+
+/**
+ * Description:
+ * Forgets the victim cache's copy of page `pageNum` of file `fileId`, written or still queued.
+ * Called before the page is written back, the copy is older than what gets written.
+ */
+static void invalidateVictimPage(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	if (pool->victimFd < 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->victimLock);
+	int position = findVictimWrite(pool, fileId, pageNum);
+	if (position >= 0) {
+		pool->victimQueue[position].cancelled = true;
+	}
+	int slot = lookupVictimSlot(pool, fileId, pageNum);
+	if (slot != NO_SLOT) {
+		unmapVictimSlot(pool, slot);
+	}
+	pthread_mutex_unlock(&pool->victimLock);
+}
+
+/**
+ * Description:
+ * Forgets the victim cache's copies of the pages of file `fileId`, see dropCompressedPages().
+ */
+static void dropVictimPages(BufferPoolManagement *pool, int fileId) {
+	if (pool->victimFd < 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->victimLock);
+	for (int i = 0; i < pool->numVictimQueued; i++) {
+		VictimWrite *write = &pool->victimQueue[(pool->victimHead + i) % VICTIM_QUEUE_PAGES];
+		if (write->fileId == fileId) {
+			write->cancelled = true;
+		}
+	}
+	for (int slot = 0; slot < pool->numVictimSlots; slot++) {
+		VictimSlot *victim = &pool->victimSlots[slot];
+		if (victim->fileId == fileId && (victim->state == VICTIM_SLOT_WRITING || victim->state == VICTIM_SLOT_VALID)) {
+			unmapVictimSlot(pool, slot);
+		}
+	}
+	pthread_mutex_unlock(&pool->victimLock);
+}
+
+/**
+ * Description:
+ * Reads page `pageNum` of file `fileId` from the victim cache into `data`. A page still waiting
+ * for the writer is copied from the queue.
+ *
+ * @return true if the cache had the page.
+ */
+static bool readVictimPage(BufferPoolManagement *pool, int fileId, PageNumber pageNum, char *data) {
+	if (pool->victimFd < 0) {
+		return false;
+	}
+
+	pthread_mutex_lock(&pool->victimLock);
+	int position = findVictimWrite(pool, fileId, pageNum);
+	if (position >= 0) {
+		memcpy(data, pool->victimBuffers + (size_t) position * PAGE_SIZE, PAGE_SIZE);
+		pthread_mutex_unlock(&pool->victimLock);
+		return true;
+	}
+
+	int slot = lookupVictimSlot(pool, fileId, pageNum);
+	if (slot == NO_SLOT || pool->victimSlots[slot].state != VICTIM_SLOT_VALID) {
+		pthread_mutex_unlock(&pool->victimLock);
+		return false;
+	}
+	VictimSlot *victim = &pool->victimSlots[slot];
+	victim->readers++;
+	pthread_mutex_unlock(&pool->victimLock);
+
+	bool read = pread(pool->victimFd, data, PAGE_SIZE, (off_t) slot * PAGE_SIZE) == PAGE_SIZE;
+
+	pthread_mutex_lock(&pool->victimLock);
+	victim->readers--;
+	if (victim->state == VICTIM_SLOT_STALE) {
+		read = false;
+		if (victim->readers == 0) {
+			victim->state = VICTIM_SLOT_FREE;
+		}
+	}
+	pthread_mutex_unlock(&pool->victimLock);
+	return read;
+}
+
+/**
+ * Description:
+ * Picks the slot for the next page written to the victim cache. Slots are reused in turn, the
+ * oldest written page makes room. The caller holds victimLock.
+ *
+ * @return the slot, or NO_SLOT if every slot is in use by a reader.
+ */
+static int takeVictimSlot(BufferPoolManagement *pool) {
+	for (int i = 0; i < pool->numVictimSlots; i++) {
+		int slot = pool->victimHand;
+		VictimSlot *victim = &pool->victimSlots[slot];
+		pool->victimHand = (slot + 1) % pool->numVictimSlots;
+
+		if (victim->state == VICTIM_SLOT_VALID && victim->readers == 0) {
+			unmapVictimSlot(pool, slot);
+		}
+		if (victim->state == VICTIM_SLOT_FREE) {
+			return slot;
+		}
+	}
+	return NO_SLOT;
+}
+
+/**
+ * Description:
+ * The victim cache writer. Writes the queued pages to the cache file one at a time, each is
+ * mapped while it is written so that an invalidation meanwhile is not lost.
+ */
+static void *victimCacheWriter(void *arg) {
+	BufferPoolManagement *pool = (BufferPoolManagement *) arg;
+
+	pthread_mutex_lock(&pool->victimLock);
+	while (true) {
+		while (pool->victimWriterRunning && pool->numVictimQueued == 0) {
+			pthread_cond_wait(&pool->victimWakeup, &pool->victimLock);
+		}
+		if (!pool->victimWriterRunning) {
+			break;
+		}
+
+		int position = pool->victimHead;
+		VictimWrite *write = &pool->victimQueue[position];
+		int slot = write->cancelled ? NO_SLOT : takeVictimSlot(pool);
+
+		if (slot != NO_SLOT) {
+			VictimSlot *victim = &pool->victimSlots[slot];
+			int *bucket = victimBucketFor(pool, write->fileId, write->pageNum);
+
+			victim->fileId = write->fileId;
+			victim->pageNum = write->pageNum;
+			victim->state = VICTIM_SLOT_WRITING;
+			victim->nextInBucket = *bucket;
+			*bucket = slot;
+			pthread_mutex_unlock(&pool->victimLock);
+
+			bool written = pwrite(pool->victimFd, pool->victimBuffers + (size_t) position * PAGE_SIZE,
+					PAGE_SIZE, (off_t) slot * PAGE_SIZE) == PAGE_SIZE;
+
+			pthread_mutex_lock(&pool->victimLock);
+			if (victim->state == VICTIM_SLOT_STALE) {
+				victim->state = VICTIM_SLOT_FREE;
+			} else {
+				victim->state = VICTIM_SLOT_VALID;
+				if (written) {
+					countEvent(pool, STAT_VICTIM_CACHE_WRITES, 1);
+				} else {
+					unmapVictimSlot(pool, slot);
+				}
+			}
+		}
+
+		pool->victimHead = (position + 1) % VICTIM_QUEUE_PAGES;
+		pool->numVictimQueued--;
+	}
+	pthread_mutex_unlock(&pool->victimLock);
+	return NULL;
+}
+
+static void stopVictimWriter(BufferPoolManagement *pool) {
+	if (pool->victimFd < 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->victimLock);
+	pool->victimWriterRunning = false;
+	pthread_cond_signal(&pool->victimWakeup);
+	pthread_mutex_unlock(&pool->victimLock);
+
+	pthread_join(pool->victimWriterThread, NULL);
+}
+
+/**
+ * Description:
+ * Writes the content of a frame back to the page file it came from. The frame must be pinned by
+ * the caller so that it can not be replaced while the write is running.
+ */
+static RC writeFrame(BufferPoolManagement *pool, FramesInPage *frame) {
+	SM_FileHandle fHandler;
+	RC rc;
+
+	invalidateVictimPage(pool, frame->fileId, frame->pageNumber);
+
+	pthread_mutex_lock(&storageLock);
+
+	// RC openPageFile(char *fileName, SM_FileHandle *fHandle)
+	rc = openPageFile(pool->files[frame->fileId].fileName, &fHandler);
+	if (rc == RC_OK) {
+		// RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
+		rc = writeBlock(frame->pageNumber, &fHandler, frame->data);
+	}
+
+	pthread_mutex_unlock(&storageLock);
+
+	if (rc == RC_OK) {
+		countEvent(pool, STAT_WRITES, 1);
+		DB_EVENT(DB_EVENT_PAGE_WRITE, frame->fileId, frame->pageNumber);
+	}
+	return rc;
+}
+
+/**
+ * Description:
+ * Reads the pages `pageNums[0..n-1]` of file `fileId` into the frames `frameIndexes[0..n-1]`,
+ * all under one acquisition of the storage lock and one open of the page file, so callers
+ * should pass the pages in ascending order. Runs of consecutive pages are read with readBlocks(). Pages that do not exist yet are
+ * appended together when `extendFile` is set, up to the last one asked for, and their frames are
+ * zeroed rather than read. Otherwise their result is RC_READ_NON_EXISTING_PAGE.
+ *
+ * @param results receives the return code of each read.
+ */
+static void readFrames(BufferPoolManagement *pool, int fileId, const int *frameIndexes,
+		const PageNumber *pageNums, int n, bool extendFile, RC *results) {
+	SM_FileHandle fHandle;
+	RC rc;
+
+	pthread_mutex_lock(&storageLock);
+
+	// RC openPageFile (char *fileName, SM_FileHandle *fHandle)
+	rc = openPageFile(pool->files[fileId].fileName, &fHandle);
+	int existingPages = rc == RC_OK ? fHandle.totalNumPages : 0;
+
+	for (int i = 0; i < n; i++) {
+		results[i] = rc;
+		if (rc != RC_OK) {
+			continue;
+		}
+
+		// existing pages that follow each other in the file are read with one call
+		int run = 1;
+		while (i + run < n && pageNums[i + run] == pageNums[i] + run && pageNums[i + run] < existingPages) {
+			run++;
+		}
+		if (run > 1) {
+			SM_PageHandle data[run];
+			for (int j = 0; j < run; j++) {
+				data[j] = pool->frames[frameIndexes[i + j]].data;
+			}
+			// RC readBlocks (int firstPageNum, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages)
+			if (readBlocks(pageNums[i], run, &fHandle, data) == RC_OK) {
+				for (int j = 0; j < run; j++) {
+					results[i + j] = RC_OK;
+					DB_EVENT(DB_EVENT_PAGE_READ, fileId, pageNums[i + j]);
+				}
+				countEvent(pool, STAT_READS, run);
+				i += run - 1;
+				continue;
+			}
+			// otherwise the pages are read one by one, which tells which of them failed
+		}
+
+		if (pageNums[i] >= existingPages) {
+			if (!extendFile) {
+				results[i] = RC_READ_NON_EXISTING_PAGE;
+				continue;
+			}
+			if (pageNums[i] >= fHandle.totalNumPages) {
+				int lastPage = pageNums[i];
+				for (int j = i + 1; j < n; j++) {
+					lastPage = pageNums[j] > lastPage ? pageNums[j] : lastPage;
+				}
+				// RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle)
+				ensureCapacity(lastPage + 1, &fHandle);
+			}
+			// a page just appended is zeros
+			if (pageNums[i] < fHandle.totalNumPages) {
+				memset(pool->frames[frameIndexes[i]].data, 0, PAGE_SIZE);
+				results[i] = RC_OK;
+			} else {
+				results[i] = RC_WRITE_FAILED;
+			}
+			continue;
+		}
+
+		// RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
+		results[i] = readBlock(pageNums[i], &fHandle, pool->frames[frameIndexes[i]].data);
+		if (results[i] == RC_OK) {
+			countEvent(pool, STAT_READS, 1);
+			DB_EVENT(DB_EVENT_PAGE_READ, fileId, pageNums[i]);
+		}
+	}
+
+	pthread_mutex_unlock(&storageLock);
+}
+
+/**
+ * Description:
+ * Takes `entry` out of its hash bucket and the newest to oldest list of the compressed tier.
+ * The caller holds tierLock.
+ */
+static void unlinkCompressedPage(BufferPoolManagement *pool, CompressedPage *entry) {
+	CompressedPage **link = &pool->tierBuckets[hashPage(entry->fileId, entry->pageNum) & (pool->numTierBuckets - 1)];
+
+	while (*link != entry) {
+		link = &(*link)->nextInBucket;
+	}
+	*link = entry->nextInBucket;
+
+	if (entry->newer != NULL) {
+		entry->newer->older = entry->older;
+	} else {
+		pool->tierNewest = entry->older;
+	}
+	if (entry->older != NULL) {
+		entry->older->newer = entry->newer;
+	} else {
+		pool->tierOldest = entry->newer;
+	}
+	pool->tierBytes -= sizeof(CompressedPage) + entry->size;
+}
+
+/**
+ * Description:
+ * Compresses page `pageNum` of file `fileId` for the compressed tier. `data` is the page's frame,
+ * which the caller keeps pinned and latched shared. Pages that do not compress below
+ * COMPRESSED_PAGE_LIMIT are not kept.
+ *
+ * @return the entry for insertCompressedPage(), or NULL.
+ */
+static CompressedPage *compressForTier(BufferPoolManagement *pool, int fileId, PageNumber pageNum, const char *data) {
+	char compressed[COMPRESSED_PAGE_LIMIT];
+	int size = compressPage(data, PAGE_SIZE, compressed, COMPRESSED_PAGE_LIMIT);
+	if (size < 0 || (long) sizeof(CompressedPage) + size > pool->tierBudget) {
+		return NULL;
+	}
+
+	CompressedPage *entry = malloc(sizeof(CompressedPage) + size);
+	if (entry == NULL) {
+		return NULL;
+	}
+	entry->fileId = fileId;
+	entry->pageNum = pageNum;
+	entry->size = size;
+	memcpy(entry->data, compressed, size);
+	return entry;
+}
+
+/**
+ * Description:
+ * Enters `entry` as the newest page of the compressed tier, dropping the oldest ones if the
+ * tier is full. The caller holds the page's shard lock and takes the page out of the page table
+ * under the same lock, so a page is never in the tier and resident at the same time, see
+ * loadIntoFrames(). Nothing is entered while a file is closed: dropFilePages() purges the tier
+ * before it lowers numClosingFiles, and a page of the closed file entered later would outlive
+ * the purge.
+ *
+ * @return true if the tier took the entry, otherwise the caller still owns it.
+ */
+static bool insertCompressedPage(BufferPoolManagement *pool, CompressedPage *entry) {
+	long entrySize = sizeof(CompressedPage) + entry->size;
+
+	pthread_mutex_lock(&pool->tierLock);
+	if (pool->numClosingFiles > 0) {
+		pthread_mutex_unlock(&pool->tierLock);
+		return false;
+	}
+	while (pool->tierBytes + entrySize > pool->tierBudget) {
+		CompressedPage *oldest = pool->tierOldest;
+		unlinkCompressedPage(pool, oldest);
+		free(oldest);
+	}
+
+	CompressedPage **bucket = &pool->tierBuckets[hashPage(entry->fileId, entry->pageNum) & (pool->numTierBuckets - 1)];
+	entry->nextInBucket = *bucket;
+	*bucket = entry;
+	entry->newer = NULL;
+	entry->older = pool->tierNewest;
+	if (pool->tierNewest != NULL) {
+		pool->tierNewest->newer = entry;
+	} else {
+		pool->tierOldest = entry;
+	}
+	pool->tierNewest = entry;
+	pool->tierBytes += entrySize;
+	pthread_mutex_unlock(&pool->tierLock);
+	return true;
+}
+
+/**
+ * Description:
+ * Takes page `pageNum` of file `fileId` out of the compressed tier. The caller holds the page's
+ * shard lock, see insertCompressedPage().
+ *
+ * @return the entry, which the caller has to free, or NULL if the tier does not have the page.
+ */
+static CompressedPage *takeCompressedPage(BufferPoolManagement *pool, int fileId, PageNumber pageNum) {
+	if (pool->tierBudget == 0) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&pool->tierLock);
+	CompressedPage *entry = pool->tierBuckets[hashPage(fileId, pageNum) & (pool->numTierBuckets - 1)];
+	while (entry != NULL && (entry->fileId != fileId || entry->pageNum != pageNum)) {
+		entry = entry->nextInBucket;
+	}
+	if (entry != NULL) {
+		unlinkCompressedPage(pool, entry);
+	}
+	pthread_mutex_unlock(&pool->tierLock);
+	return entry;
+}
+
+/**
+ * Description:
+ * Drops the compressed pages of file `fileId`, or of all files for ANY_FILE. Used when a file is
+ * closed, since its slot may be given to another file afterwards.
+ */
+static void dropCompressedPages(BufferPoolManagement *pool, int fileId) {
+	if (pool->tierBudget == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->tierLock);
+	CompressedPage *entry = pool->tierOldest;
+	while (entry != NULL) {
+		CompressedPage *newer = entry->newer;
+		if (fileId == ANY_FILE || entry->fileId == fileId) {
+			unlinkCompressedPage(pool, entry);
+			free(entry);
+		}
+		entry = newer;
+	}
+	pthread_mutex_unlock(&pool->tierLock);
+}
+
+/**
+ * Description:
+ * Writes a pinned frame back if it is dirty. The dirty bit is cleared before the write, so a
+ * markDirty() that happens while the write runs leaves the frame dirty again.
+ */
+static RC cleanPinnedFrame(BufferPoolManagement *pool, int frameIndex) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+
+	if (clearFrameDirty(pool, frameIndex) == 0) {
+		return RC_OK;
+	}
+
+	// a shared latch keeps writers from changing the page halfway through the write
+	pthread_rwlock_rdlock(&frame->latch);
+	RC rc = writeFrame(pool, frame);
+	pthread_rwlock_unlock(&frame->latch);
+
+	if (rc != RC_OK) {
+		setFrameDirty(pool, frameIndex);
+	}
+	return rc;
+}
+
+/**
+ * Description:
+ * Gives a frame that was hit a new LRU stamp, `hitStamp` or a new one if it is 0, unless its stamp
+ * is among the last frameLimit / LRU_STALE_FRACTION handed out. Such a frame is near the far end of
+ * the replacement order already, and leaving it alone keeps hits on hot pages from all writing the
+ * clock's cache line. A pool of fewer than LRU_STALE_FRACTION frames is kept in exact LRU order.
+ */
+static void stampHit(BufferPoolManagement *pool, FramesInPage *frame, int hitStamp) {
+	if (pool->strategy != RS_LRU || hitStamp == KEEP_HIT_STAMP) {
+		return;
+	}
+
+	// a stamp of 0 marks a page only an access ring used, a hit always makes it part of the working set
+	int now = atomic_load_explicit(&pool->hitCount, memory_order_relaxed);
+	int stamp = frame->hitNumber;
+	if (stamp != 0 && now - stamp <= pool->frameLimit / LRU_STALE_FRACTION) {
+		return;
+	}
+	frame->hitNumber = hitStamp > 0 ? hitStamp : ++pool->hitCount;
+}
+
+/**
+ * Description:
+ * Pins a frame found in the page table. Waits while another thread is still reading the page
+ * in and reports NO_FRAME if that read failed, in which case the caller starts over.
+ * The caller holds the shard lock. For LRU the frame is stamped by stampHit().
+ */
+static int pinResidentFrame(BufferPoolManagement *pool, PageTableShard *shard, int fileId, PageNumber pageNum, int hitStamp) {
+	int frameIndex = lookupFrame(pool, shard, fileId, pageNum);
+
+	while (frameIndex != NO_FRAME && pool->frames[frameIndex].ioInProgress) {
+		pthread_cond_wait(&shard->ioDone, &shard->lock);
+		frameIndex = lookupFrame(pool, shard, fileId, pageNum);
+	}
+
+	if (frameIndex != NO_FRAME) {
+		FramesInPage *frame = &pool->frames[frameIndex];
+		frame->fixCountInfo++;
+		stampHit(pool, frame, hitStamp);
+		countPin(pool, fileId, pageNum, true);
+	}
+	return frameIndex;
+}
+
+/**
+ * Description:
+ * The common case of pinPage(): the page is resident and fully read, so it is pinned with one
+ * atomic increment and no lock. If the frame changed hands before the increment landed, the
+ * pin is undone and the caller retries under the shard lock. `hitStamp` as for pinResidentFrame().
+ * A page being read in gets ioInProgress, fileId and pageNumber set in that order, so the checks
+ * run the other way round: whoever sees the new pageNumber also sees the rest.
+ */
+static int pinResidentFrameUnlocked(BufferPoolManagement *pool, int fileId, PageNumber pageNum, int hitStamp) {
+	int frameIndex = findFrameUnlocked(pool, fileId, pageNum);
+	if (frameIndex == NO_FRAME) {
+		return NO_FRAME;
+	}
+
+	FramesInPage *frame = &pool->frames[frameIndex];
+	frame->fixCountInfo++;
+
+	if (frame->pageNumber != pageNum || frame->fileId != fileId || frame->ioInProgress) {
+		frame->fixCountInfo--;
+		return NO_FRAME;
+	}
+
+	stampHit(pool, frame, hitStamp);
+	countPin(pool, fileId, pageNum, true);
+	return frameIndex;
+}
+
+/* ==================================================== */
+
+/**
+ * Description:
+ * The replacement strategies replace BM_PRIORITY_EVICT_SOON pages first, then BM_PRIORITY_LOW
+ * pages, and only then the other pages, each group in the strategy's own order.
+ *
+ * @return the group of a frame, lower groups are replaced first.
+ */
+static int evictionClass(FramesInPage *frame) {
+	switch (frame->priority) {
+		case BM_PRIORITY_EVICT_SOON:
+			return 0;
+		case BM_PRIORITY_LOW:
+			return 1;
+		default:
+			return 2;
+	}
+}
+
+// whether the replacement strategies pass a frame over: a BM_PRIORITY_HIGH page with spare sweeps left
+static bool isSpared(FramesInPage *frame) {
+	return frame->priority == BM_PRIORITY_HIGH && frame->spareSweeps > 0;
+}
+
+/**
+ * author : Ila Deneshwara Sai 
+ * Description:
+ * FIFO picks the unpinned frame whose page was read in first, within the lowest evictionClass().
+ * Frames are only compared here,
+ * the caller still has to claim the frame under its shard lock because the pool keeps changing
+ * while we look at it. Frames a shrink is giving up are left to the shrink. Frames isSpared()
+ * are passed over, the first of them is reported in `spared` if it comes before the candidate.
+ *
+ * @param pool the buffer pool to replace a page in.
+ * @param cleanOnly skip dirty frames, used while a page cleaner keeps clean frames available.
+ * @param fileId only consider pages of this file, ANY_FILE for all of them.
+ * @param spared set to the spared frame that would have been the candidate, NO_FRAME if there is none.
+ * @return the index of the candidate frame, NO_FRAME if every (clean) frame is pinned or spared.
+ */
+int FIFO(BufferPoolManagement *pool, bool cleanOnly, int fileId, int *spared) {
+	int fifoIndex = NO_FRAME, fifoLoadNumber = 0, fifoClass = 0;
+	int sparedIndex = NO_FRAME, sparedLoadNumber = 0, sparedClass = 0;
+
+	for (int i = 0; i < pool->frameLimit; i++) {
+		FramesInPage *frame = &pool->frames[i];
+
+		if (frame->fixCountInfo == 0 && frame->pageNumber != NO_PAGE && !(cleanOnly && frame->dirtyBit)
+				&& (fileId == ANY_FILE || frame->fileId == fileId)) {
+			int loadNumber = frame->loadNumber;
+			int class = evictionClass(frame);
+
+			if (isSpared(frame)) {
+				if (sparedIndex == NO_FRAME || class < sparedClass || (class == sparedClass && loadNumber < sparedLoadNumber)) {
+					sparedLoadNumber = loadNumber;
+					sparedClass = class;
+					sparedIndex = i;
+				}
+			} else if (fifoIndex == NO_FRAME || class < fifoClass || (class == fifoClass && loadNumber < fifoLoadNumber)) {
+				fifoLoadNumber = loadNumber;
+				fifoClass = class;
+				fifoIndex = i;
+			}
+		}
+	}
+
+	bool sparedFirst = fifoIndex == NO_FRAME || sparedClass < fifoClass || (sparedClass == fifoClass && sparedLoadNumber < fifoLoadNumber);
+	*spared = sparedFirst ? sparedIndex : NO_FRAME;
+	return fifoIndex;
+}
+
+/**
+ * author : Prudhvi Teja Kari
+ * Description:
+ * LRU (Least Recently Used) picks the unpinned frame with the lowest hit number, i.e. the
+ * one that was pinned the longest time ago, within the lowest evictionClass(). Like FIFO() it
+ * only proposes a candidate and passes over the frames isSpared().
+ *
+ * @param pool the buffer pool to replace a page in.
+ * @param cleanOnly skip dirty frames, used while a page cleaner keeps clean frames available.
+ * @param fileId only consider pages of this file, ANY_FILE for all of them.
+ * @param spared set to the spared frame that would have been the candidate, NO_FRAME if there is none.
+ * @return the index of the candidate frame, NO_FRAME if every (clean) frame is pinned or spared.
+ */
+int LRU(BufferPoolManagement *pool, bool cleanOnly, int fileId, int *spared) {
+	int lruHitIndex = NO_FRAME, lruHitNumber = 0, lruClass = 0;
+	int sparedIndex = NO_FRAME, sparedHitNumber = 0, sparedClass = 0;
+
+	for (int i = 0; i < pool->frameLimit; i++) {
+		FramesInPage *frame = &pool->frames[i];
+
+		if (frame->fixCountInfo == 0 && frame->pageNumber != NO_PAGE && !(cleanOnly && frame->dirtyBit)
+				&& (fileId == ANY_FILE || frame->fileId == fileId)) {
+			int hitNumber = frame->hitNumber;
+			int class = evictionClass(frame);
+
+			if (isSpared(frame)) {
+				if (sparedIndex == NO_FRAME || class < sparedClass || (class == sparedClass && hitNumber < sparedHitNumber)) {
+					sparedHitNumber = hitNumber;
+					sparedClass = class;
+					sparedIndex = i;
+				}
+			} else if (lruHitIndex == NO_FRAME || class < lruClass || (class == lruClass && hitNumber < lruHitNumber)) {
+				lruHitNumber = hitNumber;
+				lruClass = class;
+				lruHitIndex = i;
+			}
+		}
+	}
+
+	bool sparedFirst = lruHitIndex == NO_FRAME || sparedClass < lruClass || (sparedClass == lruClass && sparedHitNumber < lruHitNumber);
+	*spared = sparedFirst ? sparedIndex : NO_FRAME;
+	return lruHitIndex;
+}
+
+static int strategyCandidate(BufferPoolManagement *pool, bool cleanOnly, int fileId, int *spared) {
+	switch(pool->strategy) {
+		case RS_LRU:
+			return LRU(pool, cleanOnly, fileId, spared);
+
+		case RS_FIFO:
+			return FIFO(pool, cleanOnly, fileId, spared);
+
+		case RS_LFU:
+		case RS_CLOCK:
+		case RS_LRU_K:
+		default:
+			// not implemented, these strategies replace pages in FIFO order
+			return FIFO(pool, cleanOnly, fileId, spared);
+	}
+}
+
+/**
+ * Description:
+ * Asks the pool's replacement strategy for the next frame to replace, in one scan of the frames.
+ * A BM_PRIORITY_HIGH page with spare sweeps left is passed over: when it would have been the
+ * candidate it uses one up and moves to the far end of the replacement order, as if it had just
+ * been read in and pinned. One page comes up per call, the next spared one on the next call.
+ */
+static int replacementCandidate(BufferPoolManagement *pool, bool cleanOnly, int fileId) {
+	countEvent(pool, STAT_VICTIM_SEARCHES, 1);
+
+	int spared;
+	int frameIndex = strategyCandidate(pool, cleanOnly, fileId, &spared);
+
+	if (spared != NO_FRAME) {
+		// a pool full of high priority pages still has to find a victim
+		if (frameIndex == NO_FRAME) {
+			return spared;
+		}
+
+		FramesInPage *frame = &pool->frames[spared];
+		int spareSweeps = frame->spareSweeps;
+		if (spareSweeps > 0 && atomic_compare_exchange_strong(&frame->spareSweeps, &spareSweeps, spareSweeps - 1)) {
+			frame->loadNumber = ++pool->loadCount;
+			frame->hitNumber = ++pool->hitCount;
+		}
+	}
+	return frameIndex;
+}
+
+/**
+ * Description:
+ * Position of a frame in the replacement order of the pool's strategy, lower values are
+ * replaced first.
+ */
+static int replacementOrder(BufferPoolManagement *pool, FramesInPage *frame) {
+	return (pool->strategy == RS_LRU) ? frame->hitNumber : frame->loadNumber;
+}
+
+/**
+ * Description:
+ * Tries to take the candidate frame away from the page it holds. Succeeds only if the frame
+ * still holds the same page (of file `fileId`, unless ANY_FILE) and nobody pinned it in the meantime. A dirty page is written
+ * back first while the frame stays in the page table, so a concurrent pin of that page
+ * still finds it and never reads the stale version from disk. With `keepCopy` the replaced page
+ * goes to the compressed tier and the victim cache. It is compressed while the frame is pinned
+ * by us and under a shared latch like a write back, and the copy is dropped if someone marked the page dirty meanwhile, even if it was
+ * written back since.
+ *
+ * @return true if the frame was claimed. It is then out of the page table with fix count 1.
+ */
+static bool tryEvictFrame(BufferPoolManagement *pool, int frameIndex, int fileId, bool keepCopy) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+	PageNumber victimPage = frame->pageNumber;
+	int victimFile = frame->fileId;
+
+	if (victimPage == NO_PAGE || (fileId != ANY_FILE && victimFile != fileId)) {
+		return false;
+	}
+
+	PageTableShard *shard = shardForPage(pool, victimFile, victimPage);
+	pthread_mutex_lock(&shard->lock);
+
+	if (frame->pageNumber != victimPage || frame->fileId != victimFile || frame->fixCountInfo != 0 || frame->ioInProgress) {
+		pthread_mutex_unlock(&shard->lock);
+		return false;
+	}
+
+	int ownPins = 0;
+	bool wasDirty = frame->dirtyBit == 1;
+	CompressedPage *compressed = NULL;
+
+	bool compress = keepCopy && pool->tierBudget > 0;
+	if (wasDirty || compress) {
+		int expected = 0;
+		if (!atomic_compare_exchange_strong(&frame->fixCountInfo, &expected, 1)) {
+			pthread_mutex_unlock(&shard->lock);
+			return false;
+		}
+		ownPins = 1;
+		unsigned int dirtyMarks = frame->dirtyMarks;
+		pthread_mutex_unlock(&shard->lock);
+
+		RC rc = wasDirty ? cleanPinnedFrame(pool, frameIndex) : RC_OK;
+		if (rc == RC_OK && compress) {
+			// the shared latch keeps a writer that still holds the page from tearing the copy
+			pthread_rwlock_rdlock(&frame->latch);
+			compressed = compressForTier(pool, victimFile, victimPage, frame->data);
+			pthread_rwlock_unlock(&frame->latch);
+		}
+
+		pthread_mutex_lock(&shard->lock);
+		if (rc != RC_OK || frame->dirtyBit == 1 || frame->dirtyMarks != dirtyMarks) {
+			releasePin(frame);
+			pthread_mutex_unlock(&shard->lock);
+			free(compressed);
+			return false;
+		}
+	}
+
+	bool detached = detachFrame(pool, shard, frameIndex, victimPage, ownPins);
+	if (!detached && ownPins > 0) {
+		releasePin(frame);
+	}
+	bool stored = detached && compressed != NULL && insertCompressedPage(pool, compressed);
+	if (detached && keepCopy && pool->victimFd >= 0) {
+		queueVictimPage(pool, victimFile, victimPage, frame->data);
+	}
+	pthread_mutex_unlock(&shard->lock);
+
+	if (!stored) {
+		free(compressed);
+	}
+
+	if (detached) {
+		countEvent(pool, STAT_EVICTIONS, 1);
+		DB_EVENT(DB_EVENT_EVICT, victimFile, victimPage);
+		if (wasDirty) {
+			countEvent(pool, STAT_DIRTY_EVICTIONS, 1);
+		}
+		if (stored) {
+			countEvent(pool, STAT_COMPRESSED_STORES, 1);
+		}
+	}
+	return detached;
+}
+
+/**
+ * Description:
+ * Asks the replacement strategy for victims among the pages of `victimFile` (or of all files)
+ * until one can be claimed. No pool wide lock is held: competing threads simply lose the claim
+ * and ask again. With `cleanFramesOnly` no dirty page is replaced.
+ *
+ * @return the claimed frame or NO_FRAME if all frames in question are pinned.
+ */
+static int evictVictim(BufferPoolManagement *pool, int victimFile, bool cleanFramesOnly) {
+	// with a page cleaner running, replace clean frames and leave the writes to the cleaner
+	bool cleanOnly = cleanFramesOnly || pool->cleanerRunning;
+
+	for (int attempt = 0; attempt < 2 * pool->numFrames; attempt++) {
+		int frameIndex = replacementCandidate(pool, cleanOnly, victimFile);
+
+		if (frameIndex == NO_FRAME && cleanOnly && !cleanFramesOnly) {
+			pthread_mutex_lock(&pool->cleanerLock);
+			pthread_cond_signal(&pool->cleanerWakeup);
+			pthread_mutex_unlock(&pool->cleanerLock);
+
+			cleanOnly = false;
+			frameIndex = replacementCandidate(pool, cleanOnly, victimFile);
+		}
+		if (frameIndex == NO_FRAME) {
+			return NO_FRAME;
+		}
+		if (tryEvictFrame(pool, frameIndex, victimFile, true)) {
+			return frameIndex;
+		}
+		countEvent(pool, STAT_VICTIM_RETRIES, 1);
+	}
+	return NO_FRAME;
+}
+
+/**
+ * Description:
+ * Takes a frame off the free list. Frames that a running shrink gives up are retired instead.
+ *
+ * @return the frame with fix count 1, or NO_FRAME if the free list is empty.
+ */
+static int takeFreeFrame(BufferPoolManagement *pool) {
+	int frameIndex = NO_FRAME;
+
+	pthread_mutex_lock(&pool->freeLock);
+	while (frameIndex == NO_FRAME && pool->numFreeFrames > 0) {
+		frameIndex = pool->freeFrames[--pool->numFreeFrames];
+		if (frameIndex >= pool->frameLimit) {
+			pool->frames[frameIndex].retired = true;
+			frameIndex = NO_FRAME;
+		}
+	}
+	pthread_mutex_unlock(&pool->freeLock);
+
+	if (frameIndex != NO_FRAME) {
+		// a lock free pin that followed a stale chain may briefly hold the frame
+		int expected = 0;
+		while (!atomic_compare_exchange_weak(&pool->frames[frameIndex].fixCountInfo, &expected, 1)) {
+			expected = 0;
+			sched_yield();
+		}
+	}
+	return frameIndex;
+}
+
+/**
+ * Description:
+ * Waits until the prefetch thread is done with the batch it holds frames for, if it holds any.
+ * It may start the next one right away, which leaves the caller a chance at the frames.
+ *
+ * @return true if it held frames, so that a search for a frame is worth repeating.
+ */
+static bool waitForReadAhead(BufferPoolManagement *pool) {
+	bool waited = false;
+
+	pthread_mutex_lock(&pool->prefetchLock);
+	if (pool->readAheadFrames > 0) {
+		pthread_cond_wait(&pool->prefetchDone, &pool->prefetchLock);
+		waited = true;
+	}
+	pthread_mutex_unlock(&pool->prefetchLock);
+	return waited;
+}
+
+static bool hasFreeFrames(BufferPoolManagement *pool) {
+	pthread_mutex_lock(&pool->freeLock);
+	bool hasFree = pool->numFreeFrames > 0;
+	pthread_mutex_unlock(&pool->freeLock);
+	return hasFree;
+}
+
+/**
+ * Description:
+ * Finds a frame for a page of file `fileId` that is about to be read in. Frames that never held
+ * a page are used first, after that the replacement strategy proposes victims.
+ * With `cleanFramesOnly` no dirty page is replaced, which is what prefetching wants.
+ * A file that has as many frames as its quota allows replaces one of its own pages instead,
+ * unless they are all pinned. The quota is checked without a lock, so concurrent misses of the
+ * same file can take it over its quota by a frame or two. Frames pinned only by reads of the
+ * prefetch thread are waited for rather than counted as pinned, except by the prefetch thread
+ * itself, which is the one caller with `cleanFramesOnly`.
+ *
+ * @return the claimed frame (fix count 1, not in the page table, counted for `fileId`) or
+ * NO_FRAME if all frames are pinned.
+ */
+static int claimFrame(BufferPoolManagement *pool, int fileId, bool cleanFramesOnly) {
+	PoolFile *file = &pool->files[fileId];
+	int frameIndex = NO_FRAME;
+
+	if (file->quota > 0 && file->numResident >= file->quota) {
+		frameIndex = evictVictim(pool, fileId, cleanFramesOnly);
+	}
+
+	// while a file is closed its frames leave the replacement candidates before they reach the
+	// free list, so a search that falls into that gap is repeated
+	while (frameIndex == NO_FRAME) {
+		frameIndex = takeFreeFrame(pool);
+		if (frameIndex == NO_FRAME) {
+			frameIndex = evictVictim(pool, ANY_FILE, cleanFramesOnly);
+		}
+		if (frameIndex == NO_FRAME) {
+			if (!cleanFramesOnly && waitForReadAhead(pool)) {
+				continue;
+			}
+			if (pool->numClosingFiles == 0 && !hasFreeFrames(pool)) {
+				break;
+			}
+			sched_yield();
+		}
+	}
+
+	if (frameIndex != NO_FRAME) {
+		file->numResident++;
+	}
+	return frameIndex;
+}
+
+/**
+ * Description:
+ * Puts a frame that holds no page back on the free list.
+ */
+static void releaseFrame(BufferPoolManagement *pool, int frameIndex) {
+	releasePin(&pool->frames[frameIndex]);
+
+	pthread_mutex_lock(&pool->freeLock);
+	pool->freeFrames[pool->numFreeFrames++] = frameIndex;
+	pthread_mutex_unlock(&pool->freeLock);
+}
+
+/**
+ * Description:
+ * Hands a frame claimed for `fileId` back, e.g. when another thread read the same page first.
+ */
+static void unclaimFrame(BufferPoolManagement *pool, int fileId, int frameIndex) {
+	pool->files[fileId].numResident--;
+	releaseFrame(pool, frameIndex);
+}
+
+/**
+ * Description:
+ * Maps one anonymous, page aligned region for the data of all frames. With huge pages it first
+ * tries MAP_HUGETLB and otherwise maps a region aligned to HUGE_PAGE_SIZE and asks for
+ * transparent huge pages with madvise(). Anonymous memory is zero filled and only committed
+ * when a frame is first used, so room for frames a pool may grow to later costs address space only.
+ *
+ * @return the arena, or NULL if it could not be mapped.
+ */
+static char *mapFrameArena(int numFrames, bool hugePages, size_t *arenaSize) {
+	size_t size = (size_t) numFrames * PAGE_SIZE;
+	void *arena;
+
+	if (!hugePages) {
+		arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (arena == MAP_FAILED) {
+			return NULL;
+		}
+		*arenaSize = size;
+		return (char *) arena;
+	}
+
+	size = (size + HUGE_PAGE_SIZE - 1) & ~((size_t) HUGE_PAGE_SIZE - 1);
+
+#ifdef MAP_HUGETLB
+	arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (arena != MAP_FAILED) {
+		*arenaSize = size;
+		return (char *) arena;
+	}
+#endif
+
+	// no reserved huge pages, map extra room and trim it down to an aligned region
+	char *region = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (region == MAP_FAILED) {
+		return NULL;
+	}
+	char *aligned = (char *) (((size_t) region + HUGE_PAGE_SIZE - 1) & ~((size_t) HUGE_PAGE_SIZE - 1));
+	if (aligned > region) {
+		munmap(region, aligned - region);
+	}
+	if (aligned + size < region + size + HUGE_PAGE_SIZE) {
+		munmap(aligned + size, region + size + HUGE_PAGE_SIZE - (aligned + size));
+	}
+
+#ifdef MADV_HUGEPAGE
+	madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+	*arenaSize = size;
+	return aligned;
+}
+
+/**
+ * Description:
+ * Reads the pages `pageNums[0..n-1]` of file `fileId` into the frames `frameIndexes[0..n-1]`
+ * claimed with claimFrame(). The pages are entered into the page table marked as being read and the reads
+ * run as one batch outside the shard locks, threads that ask for one of the pages meanwhile
+ * wait for it. Pages the compressed tier or the victim cache still have are taken from there
+ * instead of the page file. If another thread entered a page first, its frame is given back and
+ * `alreadyResident[i]` is set. Frames whose read failed are given back as well. Only a load for
+ * a pin (`forPin`) appends pages beyond the end of the file and counts as a compressed tier or
+ * victim cache hit, read ahead and warm-up do neither.
+ *
+ * @param results receives RC_OK for every frame that now holds its page pinned once
+ * (or that was already resident), otherwise the read error.
+ */
+static void loadIntoFrames(BufferPoolManagement *pool, int fileId, const int *frameIndexes,
+		const PageNumber *pageNums, int n, bool forPin, bool *alreadyResident, RC *results) {
+	int toRead[n];
+	PageNumber pagesToRead[n];
+	RC readResults[n];
+	bool cached[n];
+	int numToRead = 0;
+
+	for (int i = 0; i < n; i++) {
+		PageTableShard *shard = shardForPage(pool, fileId, pageNums[i]);
+		FramesInPage *frame = &pool->frames[frameIndexes[i]];
+		frame->version += 2;
+		frame->generation++;
+		alreadyResident[i] = false;
+		cached[i] = false;
+		results[i] = RC_OK;
+
+		pthread_mutex_lock(&shard->lock);
+
+		// another thread may have read the page while we were looking for a frame
+		if (lookupFrame(pool, shard, fileId, pageNums[i]) != NO_FRAME) {
+			pthread_mutex_unlock(&shard->lock);
+			unclaimFrame(pool, fileId, frameIndexes[i]);
+			alreadyResident[i] = true;
+			continue;
+		}
+
+		// in this order, see pinResidentFrameUnlocked()
+		frame->ioInProgress = true;
+		frame->fileId = fileId;
+		frame->pageNumber = pageNums[i];
+		frame->dirtyBit = 0;
+		frame->refNumber = 0;
+		frame->priority = BM_PRIORITY_NORMAL;
+		frame->spareSweeps = 0;
+		insertIntoPageTable(pool, shard, frameIndexes[i]);
+		CompressedPage *compressed = takeCompressedPage(pool, fileId, pageNums[i]);
+		pthread_mutex_unlock(&shard->lock);
+
+		if (compressed != NULL) {
+			cached[i] = decompressPage(compressed->data, compressed->size, frame->data, PAGE_SIZE) == 0;
+			free(compressed);
+			if (cached[i]) {
+				if (forPin) {
+					countEvent(pool, STAT_COMPRESSED_HITS, 1);
+				}
+				continue;
+			}
+		}
+		if (readVictimPage(pool, fileId, pageNums[i], frame->data)) {
+			if (forPin) {
+				countEvent(pool, STAT_VICTIM_CACHE_HITS, 1);
+			}
+			cached[i] = true;
+			continue;
+		}
+
+		toRead[numToRead] = frameIndexes[i];
+		pagesToRead[numToRead] = pageNums[i];
+		numToRead++;
+	}
+
+	readFrames(pool, fileId, toRead, pagesToRead, numToRead, forPin, readResults);
+
+	for (int i = 0, r = 0; i < n; i++) {
+		if (alreadyResident[i]) {
+			continue;
+		}
+		RC rc = cached[i] ? RC_OK : readResults[r++];
+		PageTableShard *shard = shardForPage(pool, fileId, pageNums[i]);
+		FramesInPage *frame = &pool->frames[frameIndexes[i]];
+
+		pthread_mutex_lock(&shard->lock);
+		if (rc != RC_OK) {
+			frame->pageNumber = NO_PAGE;
+			removeFromPageTable(pool, shard, frameIndexes[i], fileId, pageNums[i]);
+		}
+		frame->ioInProgress = false;
+		if (rc == RC_OK) {
+			frame->loadNumber = ++pool->loadCount;
+			frame->hitNumber = ++pool->hitCount;
+		}
+		pthread_cond_broadcast(&shard->ioDone);
+		pthread_mutex_unlock(&shard->lock);
+
+		if (rc != RC_OK) {
+			unclaimFrame(pool, fileId, frameIndexes[i]);
+		}
+		results[i] = rc;
+	}
+}
+
+/**
+ * Description:
+ * Reads one page into a frame claimed with claimFrame(), see loadIntoFrames().
+ *
+ * @return RC_OK with the frame pinned once (unless `*alreadyResident`), otherwise the read error.
+ */
+static RC loadIntoFrame(BufferPoolManagement *pool, int fileId, int frameIndex, PageNumber pageNum,
+		bool forPin, bool *alreadyResident) {
+	RC rc;
+	loadIntoFrames(pool, fileId, &frameIndex, &pageNum, 1, forPin, alreadyResident, &rc);
+	return rc;
+}
+
+static void stopPrefetcher(BufferPoolManagement *pool);
+static void cancelPrefetches(BufferPoolManagement *pool, int fileId);
+static RC stopPoolCleaner(BufferPoolManagement *pool);
+static bool cleanUnpinnedFrame(BufferPoolManagement *pool, int frameIndex);
+static void stopPressureWatch(BufferPoolManagement *pool);
+static void stopTrace(BufferPoolManagement *pool);
+static bool stopWarmUp(BufferPoolManagement *pool);
+static bool cancelWarmUp(BufferPoolManagement *pool, int fileId);
+
+/* ==================================================== */
+
+
+/* Buffer Manager Interface Pool Handling */
+
+/*
+ * author : Ila Deneshwara Sai 
+ * Description:
+ * initBufferPool() - creates a new buffer pool with numPages page frames using the page replacement
+strategy strategy. The pool is used to cache pages from the page file with name pageFileName.
+Initially, all page frames should be empty. The page file should already exist, i.e., this method
+should not generate a new page file. stratData can be used to pass parameters for the page
+replacement strategy. For example, for LRU-k this could be the parameter k.
+ *
+ * The page table is split into a power of two number of shards (at most MAX_PAGE_TABLE_SHARDS),
+ * each with its own lock, so pins of different pages rarely touch the same lock.
+*/
+
+RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData) {
+	return initBufferPoolWithOptions(bm, pageFileName, numPages, strategy, stratData, NULL);
+}
+
+/*
+ * Description:
+ * initBufferPoolWithOptions() - same as initBufferPool() with the pool options given in `options`
+ * (NULL for the defaults). The pool is made with initSharedPool() but only `bm` is opened on
+ * it, and shutdownBufferPool() shuts it down again.
+*/
+RC initBufferPoolWithOptions(BM_BufferPool *const bm, const char *const pageFileName, const int numPages,
+		ReplacementStrategy strategy, void *stratData, const BM_PoolOptions *options) {
+	BufferPoolManagement *pool;
+
+	if (bm == NULL) {
+		return RC_INVALID_INPUT;
+	}
+	bm->mgmtData = NULL;
+
+	RC rc = initSharedPool(&pool, numPages, strategy, options);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	rc = openSharedBufferPool(bm, pool, pageFileName, 0);
+	if (rc != RC_OK) {
+		shutdownSharedPool(pool);
+		return rc;
+	}
+	((BufferPoolView *) bm->mgmtData)->ownsPool = true;
+
+	// a missing or damaged manifest only means that the pool starts cold
+	if (pool->manifestFile != NULL) {
+		warmBufferPool(bm, pool->manifestFile);
+	}
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * initSharedPool() creates a buffer pool with numPages page frames that any number of page files
+ * can be opened on with openSharedBufferPool(). Pages are identified by their file and page
+ * number, so the frames go to whichever files are being used and no file keeps frames it
+ * does not need. The page data of all frames is allocated here once, as one aligned arena,
+ * and reused in place when pages are replaced. The arena has room for the `maxPages` frames
+ * of the options, which resizeBufferPool() can grow the pool to later.
+ *
+ * @param sharedPool receives the new pool.
+ * @param numPages number of page frames.
+ * @param strategy replacement strategy of the pool.
+ * @param options pool options, NULL for the defaults.
+ *
+ * @return RC_OK, RC_INVALID_INPUT, RC_FILE_NOT_FOUND if the victim cache file can not be opened,
+ * or RC_MEMORY_ALLOCATION_FAIL.
+*/
+RC initSharedPool(BM_SharedPool **sharedPool, const int numPages, ReplacementStrategy strategy, const BM_PoolOptions *options) {
+	BM_PoolOptions poolOptions = DEFAULT_POOL_OPTIONS;
+
+	if (sharedPool == NULL || numPages <= 0) {
+		return RC_INVALID_INPUT;
+	}
+	*sharedPool = NULL;
+	if (options != NULL) {
+		poolOptions = *options;
+	}
+
+	int frameCapacity = poolOptions.maxPages > 0 ? poolOptions.maxPages : DEFAULT_POOL_GROWTH * numPages;
+	if (frameCapacity < numPages) {
+		return RC_INVALID_INPUT;
+	}
+
+	int victimFd = -1;
+	if (poolOptions.victimCacheFile != NULL && poolOptions.victimCachePages > 0) {
+		victimFd = open(poolOptions.victimCacheFile, O_RDWR | O_CREAT, 0644);
+		if (victimFd < 0) {
+			return RC_FILE_NOT_FOUND;
+		}
+	}
+
+	BufferPoolManagement *pool = aligned_alloc(64, sizeof(BufferPoolManagement));
+	if (pool == NULL) {
+		if (victimFd >= 0) {
+			close(victimFd);
+		}
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+	int numShards = nextPowerOfTwo(numPages / FRAMES_PER_SHARD + 1);
+	if (numShards > MAX_PAGE_TABLE_SHARDS) {
+		numShards = MAX_PAGE_TABLE_SHARDS;
+	}
+	int bucketsPerShard = nextPowerOfTwo(2 * ((numPages + numShards - 1) / numShards));
+
+	pool->numFrames = numPages;
+	pool->frameLimit = numPages;
+	pool->frameCapacity = frameCapacity;
+	pool->strategy = strategy;
+	pool->numShards = numShards;
+    pool->frames = malloc(sizeof(FramesInPage) * frameCapacity);
+	pool->shards = aligned_alloc(64, sizeof(PageTableShard) * numShards);
+	pool->freeFrames = malloc(sizeof(int) * frameCapacity);
+	pool->arena = mapFrameArena(frameCapacity, poolOptions.hugePages, &pool->arenaSize);
+
+	if (pool->frames == NULL || pool->shards == NULL || pool->freeFrames == NULL || pool->arena == NULL) {
+		if (pool->arena != NULL) {
+			munmap(pool->arena, pool->arenaSize);
+		}
+		free(pool->frames);
+		free(pool->shards);
+		free(pool->freeFrames);
+		free(pool);
+		if (victimFd >= 0) {
+			close(victimFd);
+		}
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+/*
+	* The above code is initializing an array of structures named `framesInPage`.
+ 	* The fields being initialized include `data`, `dirtyBit`, `fixCountInfo`, `hitNumber`, `refNumber`, and `pageNumber`.
+	* The free list is filled backwards so that frames are handed out starting with frame 0.
+	* Frames beyond numPages wait retired until the pool grows.
+*/
+    for (int i=0;i<frameCapacity;i++) {
+		FramesInPage *frame = &pool->frames[i];
+        frame->data = pool->arena + (size_t) i * PAGE_SIZE;
+        frame->dirtyBit = 0;
+        frame->fixCountInfo = 0;
+        frame->hitNumber = 0;
+        frame->refNumber = 0;
+		frame->loadNumber = 0;
+        frame->pageNumber = NO_PAGE;
+		frame->fileId = NO_FILE;
+		frame->ioInProgress = false;
+		frame->nextInChain = NO_FRAME;
+		frame->onDirtyList = false;
+		frame->version = 0;
+		frame->generation = 0;
+		frame->dirtyMarks = 0;
+		frame->retired = (i >= numPages);
+		frame->priority = BM_PRIORITY_NORMAL;
+		frame->spareSweeps = 0;
+		pthread_rwlock_init(&frame->latch, NULL);
+
+		if (i < numPages) {
+			pool->freeFrames[i] = numPages - 1 - i;
+		}
+    }
+	pool->numFreeFrames = numPages;
+	pool->numClosingFiles = 0;
+
+	for (int i = 0; i < numShards; i++) {
+		PageTableShard *shard = &pool->shards[i];
+
+		pthread_mutex_init(&shard->lock, NULL);
+		pthread_cond_init(&shard->ioDone, NULL);
+		shard->numBuckets = bucketsPerShard;
+		shard->buckets = malloc(sizeof(atomic_int) * bucketsPerShard);
+
+		for (int j = 0; j < bucketsPerShard; j++) {
+			shard->buckets[j] = NO_FRAME;
+		}
+	}
+
+	pthread_mutex_init(&pool->filesLock, NULL);
+	for (int i = 0; i < MAX_POOL_FILES; i++) {
+		pool->files[i].fileName = NULL;
+		pool->files[i].quota = 0;
+		pool->files[i].numResident = 0;
+	}
+
+	pthread_mutex_init(&pool->freeLock, NULL);
+	pthread_mutex_init(&pool->resizeLock, NULL);
+	pool->hitCount = 0;
+	pool->loadCount = 0;
+	memset(pool->stats, 0, sizeof(pool->stats));
+	pool->numDirty = 0;
+
+	pool->cleanerRunning = false;
+	pool->cleanTarget = 0;
+	pool->dirtyList = NULL;
+	pool->numDirtyListed = 0;
+	pthread_mutex_init(&pool->cleanerLock, NULL);
+	pthread_cond_init(&pool->cleanerWakeup, NULL);
+
+	pool->prefetcherStarted = false;
+	pool->prefetcherRunning = false;
+	pool->prefetchHead = 0;
+	pool->numPrefetchQueued = 0;
+	pool->prefetchingFile = NO_FILE;
+	pool->readAheadFrames = 0;
+	pthread_mutex_init(&pool->prefetchLock, NULL);
+	pthread_cond_init(&pool->prefetchWakeup, NULL);
+	pthread_cond_init(&pool->prefetchDone, NULL);
+
+	// read ahead never takes more than half of the pool away from the pages in use
+	pool->requestedPrefetchWindow = poolOptions.prefetchWindow;
+	pool->prefetchWindow = poolOptions.prefetchWindow < numPages / 2 ? poolOptions.prefetchWindow : numPages / 2;
+
+	pthread_mutex_init(&pool->pressureLock, NULL);
+	pool->pressureWatchRunning = false;
+	pool->pressureFd = -1;
+	pool->pressureFromPsi = false;
+	pool->memoryHighEvents = 0;
+	pool->pressureMinFrames = 0;
+
+	pthread_mutex_init(&pool->traceLock, NULL);
+	pool->tracing = false;
+	pool->traceWriters = 0;
+	pool->traceHeader = NULL;
+
+	pthread_mutex_init(&pool->tierLock, NULL);
+	pool->tierBudget = poolOptions.compressedCacheBytes > 0 ? poolOptions.compressedCacheBytes : 0;
+	pool->tierBytes = 0;
+	pool->tierNewest = NULL;
+	pool->tierOldest = NULL;
+	pool->numTierBuckets = 0;
+	pool->tierBuckets = NULL;
+	if (pool->tierBudget > 0) {
+		// room for pages compressed to about a quarter, a few of them per bucket
+		long expectedPages = pool->tierBudget / (PAGE_SIZE / 4) / COMPRESSED_PAGES_PER_BUCKET + 1;
+		pool->numTierBuckets = nextPowerOfTwo(expectedPages < (1 << 20) ? (int) expectedPages : (1 << 20));
+		pool->tierBuckets = calloc(pool->numTierBuckets, sizeof(CompressedPage *));
+		if (pool->tierBuckets == NULL) {
+			pool->tierBudget = 0;
+		}
+	}
+
+	pthread_mutex_init(&pool->warmLock, NULL);
+	pthread_cond_init(&pool->warmDone, NULL);
+	pool->warmerStarted = false;
+	pool->warmerActive = false;
+	pool->warmCancelled = false;
+	pool->warmJobs = NULL;
+	pool->warmingFile = NO_FILE;
+	pool->manifestFile = poolOptions.manifestFile != NULL ? strdup(poolOptions.manifestFile) : NULL;
+
+	// the victim cache file's old content is never looked at, all its slots start out free
+	pthread_mutex_init(&pool->victimLock, NULL);
+	pthread_cond_init(&pool->victimWakeup, NULL);
+	pool->victimFd = victimFd;
+	pool->numVictimSlots = victimFd >= 0 ? poolOptions.victimCachePages : 0;
+	pool->numVictimBuckets = nextPowerOfTwo(pool->numVictimSlots);
+	pool->victimSlots = NULL;
+	pool->victimBuckets = NULL;
+	pool->victimBuffers = NULL;
+	pool->victimHand = 0;
+	pool->victimHead = 0;
+	pool->numVictimQueued = 0;
+	pool->victimWriterRunning = false;
+	if (victimFd >= 0) {
+		pool->victimSlots = malloc(sizeof(VictimSlot) * pool->numVictimSlots);
+		pool->victimBuckets = malloc(sizeof(int) * pool->numVictimBuckets);
+		pool->victimBuffers = malloc((size_t) VICTIM_QUEUE_PAGES * PAGE_SIZE);
+		pool->victimWriterRunning = pool->victimSlots != NULL && pool->victimBuckets != NULL && pool->victimBuffers != NULL;
+
+		for (int i = 0; pool->victimWriterRunning && i < pool->numVictimSlots; i++) {
+			pool->victimSlots[i].fileId = NO_FILE;
+			pool->victimSlots[i].pageNum = NO_PAGE;
+			pool->victimSlots[i].state = VICTIM_SLOT_FREE;
+			pool->victimSlots[i].readers = 0;
+			pool->victimSlots[i].nextInBucket = NO_SLOT;
+		}
+		for (int i = 0; pool->victimWriterRunning && i < pool->numVictimBuckets; i++) {
+			pool->victimBuckets[i] = NO_SLOT;
+		}
+
+		// without the memory or the thread the pool runs without a victim cache
+		if (!pool->victimWriterRunning || pthread_create(&pool->victimWriterThread, NULL, victimCacheWriter, pool) != 0) {
+			pool->victimWriterRunning = false;
+			pool->victimFd = -1;
+			close(victimFd);
+		}
+	}
+
+	*sharedPool = pool;
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * shutdownSharedPool() stops the pool's background threads and frees it. Every BM_BufferPool
+ * opened on the pool has to be shut down first.
+ *
+ * @return RC_OK, RC_POOL_STILL_IN_USE if a page file is still open on the pool.
+*/
+RC shutdownSharedPool(BM_SharedPool *pool) {
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+
+	pthread_mutex_lock(&pool->filesLock);
+	for (int i = 0; i < MAX_POOL_FILES; i++) {
+		if (pool->files[i].fileName != NULL) {
+			pthread_mutex_unlock(&pool->filesLock);
+			return RC_POOL_STILL_IN_USE;
+		}
+	}
+	pthread_mutex_unlock(&pool->filesLock);
+
+	stopPrefetcher(pool);
+	stopPoolCleaner(pool);
+	stopPressureWatch(pool);
+	stopTrace(pool);
+	stopVictimWriter(pool);
+	stopWarmUp(pool);
+
+	pthread_mutex_lock(&globalPoolLock);
+	if (globalPool == pool) {
+		globalPool = NULL;
+	}
+	pthread_mutex_unlock(&globalPoolLock);
+
+	for (int i = 0; i < pool->frameCapacity; i++) {
+		pthread_rwlock_destroy(&pool->frames[i].latch);
+	}
+	for (int i = 0; i < pool->numShards; i++) {
+		pthread_mutex_destroy(&pool->shards[i].lock);
+		pthread_cond_destroy(&pool->shards[i].ioDone);
+		free(pool->shards[i].buckets);
+	}
+	pthread_mutex_destroy(&pool->filesLock);
+	pthread_mutex_destroy(&pool->freeLock);
+	pthread_mutex_destroy(&pool->resizeLock);
+	pthread_mutex_destroy(&pool->pressureLock);
+	pthread_mutex_destroy(&pool->traceLock);
+
+	dropCompressedPages(pool, ANY_FILE);
+	free(pool->tierBuckets);
+	pthread_mutex_destroy(&pool->tierLock);
+
+	if (pool->victimFd >= 0) {
+		close(pool->victimFd);
+	}
+	free(pool->victimSlots);
+	free(pool->victimBuckets);
+	free(pool->victimBuffers);
+	pthread_mutex_destroy(&pool->victimLock);
+	pthread_cond_destroy(&pool->victimWakeup);
+	pthread_mutex_destroy(&pool->warmLock);
+	pthread_cond_destroy(&pool->warmDone);
+	free(pool->manifestFile);
+	pthread_mutex_destroy(&pool->cleanerLock);
+	pthread_cond_destroy(&pool->cleanerWakeup);
+	pthread_mutex_destroy(&pool->prefetchLock);
+	pthread_cond_destroy(&pool->prefetchWakeup);
+	pthread_cond_destroy(&pool->prefetchDone);
+
+	munmap(pool->arena, pool->arenaSize);
+	free(pool->shards);
+	free(pool->freeFrames);
+    free(pool->frames);
+	free(pool);
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * getGlobalSharedPool() returns the pool shared by all tables and indexes, creating it with
+ * GLOBAL_POOL_PAGES frames on first use.
+*/
+RC getGlobalSharedPool(BM_SharedPool **pool) {
+	RC rc = RC_OK;
+
+	if (pool == NULL) {
+		return RC_INVALID_INPUT;
+	}
+
+	pthread_mutex_lock(&globalPoolLock);
+	if (globalPool == NULL) {
+		BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+		options.prefetchWindow = GLOBAL_POOL_PREFETCH_WINDOW;
+		rc = initSharedPool(&globalPool, GLOBAL_POOL_PAGES, RS_LRU, &options);
+	}
+	*pool = globalPool;
+	pthread_mutex_unlock(&globalPoolLock);
+
+	return rc;
+}
+
+/**
+ * Description:
+ * Takes a free slot of the pool's file table for a page file.
+ */
+static RC registerFile(BufferPoolManagement *pool, const char *fileName, int quota, int *fileId) {
+	int freeSlot = NO_FILE;
+
+	pthread_mutex_lock(&pool->filesLock);
+	for (int i = 0; i < MAX_POOL_FILES && freeSlot == NO_FILE; i++) {
+		if (pool->files[i].fileName == NULL) {
+			freeSlot = i;
+		}
+	}
+
+	if (freeSlot == NO_FILE) {
+		pthread_mutex_unlock(&pool->filesLock);
+		return RC_TOO_MANY_POOL_FILES;
+	}
+
+	PoolFile *file = &pool->files[freeSlot];
+	file->fileName = strdup(fileName);
+	if (file->fileName == NULL) {
+		pthread_mutex_unlock(&pool->filesLock);
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+	file->quota = quota;
+	file->numResident = 0;
+	file->lastPinnedPage = NO_PAGE;
+	file->sequentialRun = 0;
+	file->prefetchedUpTo = NO_PAGE;
+	pthread_mutex_unlock(&pool->filesLock);
+
+	*fileId = freeSlot;
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Takes every page of a file out of the pool and puts the frames back on the free list.
+ * Nobody may use the file any more, but the page cleaner or a lock free pin that followed a
+ * stale chain can still hold one of its frames for a moment, so those frames are retried.
+ */
+static void dropFilePages(BufferPoolManagement *pool, int fileId) {
+	pool->numClosingFiles++;
+
+	for (int i = 0; i < pool->numFrames; i++) {
+		FramesInPage *frame = &pool->frames[i];
+		PageNumber pageNum;
+
+		while ((pageNum = frame->pageNumber) != NO_PAGE && frame->fileId == fileId) {
+			PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+			bool dropped = false;
+
+			pthread_mutex_lock(&shard->lock);
+			if (frame->pageNumber == pageNum && frame->fileId == fileId && !frame->ioInProgress && frame->dirtyBit == 0) {
+				dropped = detachFrame(pool, shard, i, pageNum, 0);
+			}
+			pthread_mutex_unlock(&shard->lock);
+
+			if (dropped) {
+				releaseFrame(pool, i);
+			} else {
+				cleanUnpinnedFrame(pool, i);
+				sched_yield();
+			}
+		}
+	}
+
+	dropCompressedPages(pool, fileId);
+	dropVictimPages(pool, fileId);
+	pool->numClosingFiles--;
+}
+
+/**
+ * Description:
+ * Tells whether a page of the file is pinned. The page cleaner and lock free pins that followed
+ * a stale chain hold a frame for a moment only, so a pin has to outlast PIN_CHECK_ROUNDS looks.
+ * Frames being read belong to the prefetcher or the warm-up, whose pins end with the read.
+ */
+static bool filePagesPinned(BufferPoolManagement *pool, int fileId) {
+	for (int round = 0; round < PIN_CHECK_ROUNDS; round++) {
+		bool pinned = false;
+
+		for (int i = 0; i < pool->numFrames && !pinned; i++) {
+			if (pool->frames[i].fileId != fileId || pool->frames[i].pageNumber == NO_PAGE || pool->frames[i].ioInProgress) {
+				continue;
+			}
+			if (round == 0) {
+				DB_LOG_DEBUG("page %d of file %d fix count %d", (int) pool->frames[i].pageNumber, fileId, (int) pool->frames[i].fixCountInfo);
+			}
+			pinned = (pool->frames[i].fixCountInfo != 0);
+		}
+
+		if (!pinned) {
+			return false;
+		}
+		sched_yield();
+	}
+	return true;
+}
+
+/**
+ * Description:
+ * Takes a file's pages out of the pool and frees its slot, unless one of the pages is still pinned.
+ *
+ * @return RC_OK, RC_PINNED_PAGES_IN_BUFFER if the file is still in use.
+ */
+static RC unregisterFile(BufferPoolManagement *pool, int fileId) {
+	PoolFile *file = &pool->files[fileId];
+
+	pthread_mutex_lock(&pool->filesLock);
+	cancelPrefetches(pool, fileId);
+	cancelWarmUp(pool, fileId);
+
+	if (filePagesPinned(pool, fileId)) {
+		pthread_mutex_unlock(&pool->filesLock);
+		return RC_PINNED_PAGES_IN_BUFFER;
+	}
+	dropFilePages(pool, fileId);
+
+	free(file->fileName);
+	file->fileName = NULL;
+	file->quota = 0;
+	pthread_mutex_unlock(&pool->filesLock);
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * openSharedBufferPool() opens the page file `pageFileName` on a pool made with initSharedPool()
+ * (or getGlobalSharedPool()). `bm` is then used with the page access functions like a pool of
+ * its own, while the frames are shared with all other files opened on the pool. Like two pools
+ * of their own, two BM_BufferPools opened on the same file do not share its pages.
+ *
+ * @param bm receives the file's view of the pool, shut it down with shutdownBufferPool().
+ * @param pool the shared pool.
+ * @param pageFileName an existing page file.
+ * @param quota the most frames the file's pages may take (further pages replace pages of the
+ * same file), 0 for no limit.
+ *
+ * @return RC_OK, RC_INVALID_INPUT, RC_TOO_MANY_POOL_FILES or RC_MEMORY_ALLOCATION_FAIL.
+*/
+RC openSharedBufferPool(BM_BufferPool *const bm, BM_SharedPool *pool, const char *const pageFileName, int quota) {
+	int fileId;
+
+	if (bm == NULL || pool == NULL || pageFileName == NULL || quota < 0) {
+		return RC_INVALID_INPUT;
+	}
+	bm->mgmtData = NULL;
+
+	BufferPoolView *view = malloc(sizeof(BufferPoolView));
+	if (view == NULL) {
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+	RC rc = registerFile(pool, pageFileName, quota, &fileId);
+	if (rc != RC_OK) {
+		free(view);
+		return rc;
+	}
+	view->pool = pool;
+	view->fileId = fileId;
+	view->ownsPool = false;
+
+    bm->pageFile = (char *) (pageFileName);
+    bm->strategy = pool->strategy;
+    bm->numPages = pool->numFrames;
+    bm->mgmtData = view;
+    return RC_OK;
+}
+
+/*
+
+ * shutdownBufferPool() - destroys a buffer pool. This method should free up all resources associated
+	with buffer pool. For example, it should free the memory allocated for page frames. If the buffer
+	pool contains any dirty pages, then these pages should be written back to disk before destroying
+	the pool. It is an error to shutdown a buffer pool that has pinned pages.
+*/
+
+/**
+ * author : Prudhvi Teja Kari
+ * Description:
+ * The function `shutdownBufferPool` checks for pinned pages, flushes the buffer pool and then
+ * frees the frames and the page table. No other thread may use the pool while it is shut down.
+ * On a shared pool only the file's pages are written back and taken out of the pool, the pool
+ * itself stays up. A shutdown that fails on a pinned page leaves the pool running as it was.
+ *
+ * The pool is dumped to its manifest, unless its warm-up from the manifest was still going on:
+ * the pool then holds only part of the pages the manifest lists, and the manifest is kept.
+ *
+ * @param bm BM_BufferPool structure containing information about the buffer pool and its management data.
+ *
+ * @return RC_OK, or RC_PINNED_PAGES_IN_BUFFER if a page is still pinned.
+ */
+
+RC shutdownBufferPool(BM_BufferPool *const bm) {
+
+    BufferPoolView *view = (BufferPoolView *) bm->mgmtData;
+	if (view == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	BufferPoolManagement *pool = view->pool;
+
+	if (filePagesPinned(pool, view->fileId)) {
+		return RC_PINNED_PAGES_IN_BUFFER;
+	}
+
+	if (view->ownsPool) {
+		stopPrefetcher(pool);
+		stopPoolCleaner(pool);
+		stopPressureWatch(pool);
+		stopTrace(pool);
+		bool warmUpCut = stopWarmUp(pool);
+		if (pool->manifestFile != NULL && !warmUpCut) {
+			dumpPoolManifest(bm, pool->manifestFile);
+		}
+	}
+	forceFlushPool(bm);
+
+	RC rc = unregisterFile(pool, view->fileId);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	if (view->ownsPool) {
+		shutdownSharedPool(pool);
+	}
+	free(view);
+    bm->mgmtData = NULL;
+    return RC_OK;
+}
+
+// a dirty page forceFlushPool() writes, pinned by the flush
+typedef struct FlushEntry {
+	PageNumber pageNum;
+	int frameIndex;
+} FlushEntry;
+
+/**
+ * The work of one forceFlushPool() call, shared by its writer threads. Run i covers
+ * entries[runStarts[i]] up to entries[runStarts[i + 1] - 1], and the writers take runs in
+ * order through `nextRun`.
+ */
+typedef struct FlushJob {
+	BufferPoolManagement *pool;
+	int fileId;
+	SM_FileHandle fHandle;
+	FlushEntry *entries;
+	int *runStarts;
+	int numRuns;
+	atomic_int nextRun;
+	atomic_int firstError;
+} FlushJob;
+
+static int compareFlushEntries(const void *first, const void *second) {
+	const FlushEntry *a = first, *b = second;
+	return (a->pageNum > b->pageNum) - (a->pageNum < b->pageNum);
+}
+
+/**
+ * Description:
+ * Writes the pages entries[from..to-1] of a flush, adjacent pages of the file, with as few
+ * writeBlocks() calls as possible. Only the first latch of each write is waited for, the
+ * following ones are only taken if they are free, so the flush never waits for a latch while
+ * holding another one. A page that failed to be written is marked dirty again.
+ */
+static RC writeFlushRun(FlushJob *job, int from, int to) {
+	BufferPoolManagement *pool = job->pool;
+	SM_FileHandle fHandle = job->fHandle;
+	SM_PageHandle data[FLUSH_RUN_PAGES];
+	RC result = RC_OK;
+
+	for (int first = from, last; first < to; first = last) {
+		pthread_rwlock_rdlock(&pool->frames[job->entries[first].frameIndex].latch);
+		last = first + 1;
+		while (last < to && pthread_rwlock_tryrdlock(&pool->frames[job->entries[last].frameIndex].latch) == 0) {
+			last++;
+		}
+
+		for (int i = first; i < last; i++) {
+			data[i - first] = pool->frames[job->entries[i].frameIndex].data;
+			invalidateVictimPage(pool, job->fileId, job->entries[i].pageNum);
+		}
+
+		// RC writeBlocks (int firstPageNum, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages)
+		RC rc = writeBlocks(job->entries[first].pageNum, last - first, &fHandle, data);
+
+		for (int i = first; i < last; i++) {
+			pthread_rwlock_unlock(&pool->frames[job->entries[i].frameIndex].latch);
+			if (rc != RC_OK) {
+				setFrameDirty(pool, job->entries[i].frameIndex);
+			}
+		}
+
+		if (rc == RC_OK) {
+			countEvent(pool, STAT_WRITES, last - first);
+		} else {
+			result = rc;
+		}
+	}
+	return result;
+}
+
+static void *flushWriter(void *arg) {
+	FlushJob *job = arg;
+	int run;
+
+	while ((run = job->nextRun++) < job->numRuns) {
+		RC rc = writeFlushRun(job, job->runStarts[run], job->runStarts[run + 1]);
+		if (rc != RC_OK) {
+			int expected = RC_OK;
+			atomic_compare_exchange_strong(&job->firstError, &expected, rc);
+		}
+	}
+	return NULL;
+}
+
+/*
+forceFlushPool() - causes all dirty pages (with fix count 0) from the buffer pool to be written to
+disk.
+*/
+
+/**
+ * author : Ila Deneshwara Sai 
+ * Description:
+ * The function `forceFlushPool` writes the dirty pages with fix count zero back to disk.
+ * The pages are pinned and taken off the dirty list first, so they can not be replaced underneath
+ * the write, then sorted by page number and merged into runs of adjacent pages. The runs are
+ * written with vectored writes by up to FLUSH_WRITERS threads (the caller being one of them),
+ * which turns the flush of a large pool into mostly sequential I/O.
+ * On a shared pool only the pages of the BM_BufferPool's own file are written.
+ *
+ * @param bm BM_BufferPool *const bm
+ *
+ * @return RC_OK, or the error of the first write that failed. Pages that were not written stay dirty.
+ */
+RC forceFlushPool(BM_BufferPool *const bm) {
+
+    BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	int fileId = fileOf(bm);
+	int numFrames = pool->numFrames;
+
+	FlushEntry *entries = (FlushEntry *) malloc(numFrames * sizeof(FlushEntry));
+	int *runStarts = (int *) malloc((numFrames + 1) * sizeof(int));
+	if (entries == NULL || runStarts == NULL) {
+		free(entries);
+		free(runStarts);
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+	int numEntries = 0;
+
+    for (int i = 0; i < numFrames; i++) {
+		FramesInPage *frame = &pool->frames[i];
+		PageNumber pageNum = frame->pageNumber;
+
+		if (pageNum == NO_PAGE || frame->fileId != fileId || frame->dirtyBit == 0) {
+			continue;
+		}
+
+		PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+		pthread_mutex_lock(&shard->lock);
+
+        if ((frame->pageNumber == pageNum) && (frame->fileId == fileId) && (frame->fixCountInfo == 0)
+                && !frame->ioInProgress) {
+			frame->fixCountInfo++;
+
+			// cleared before the write, so a markDirty() while it runs leaves the page dirty
+			if (clearFrameDirty(pool, i)) {
+				entries[numEntries].pageNum = pageNum;
+				entries[numEntries].frameIndex = i;
+				numEntries++;
+			} else {
+				releasePin(frame);
+			}
+        }
+		pthread_mutex_unlock(&shard->lock);
+    }
+
+	qsort(entries, numEntries, sizeof(FlushEntry), compareFlushEntries);
+	DB_EVENT(DB_EVENT_FLUSH, fileId, numEntries);
+
+	FlushJob job = { .pool = pool, .fileId = fileId, .entries = entries, .runStarts = runStarts, .numRuns = 0 };
+	job.nextRun = 0;
+	job.firstError = RC_OK;
+
+	for (int i = 0; i < numEntries; i++) {
+		int runStart = (job.numRuns > 0) ? runStarts[job.numRuns - 1] : 0;
+		if (i == 0 || entries[i].pageNum != entries[i - 1].pageNum + 1 || i - runStart == FLUSH_RUN_PAGES) {
+			runStarts[job.numRuns++] = i;
+		}
+	}
+	runStarts[job.numRuns] = numEntries;
+
+	if (numEntries > 0) {
+		pthread_mutex_lock(&storageLock);
+		// RC openPageFile(char *fileName, SM_FileHandle *fHandle)
+		RC rc = openPageFile(pool->files[fileId].fileName, &job.fHandle);
+		pthread_mutex_unlock(&storageLock);
+
+		if (rc != RC_OK) {
+			job.firstError = rc;
+			job.nextRun = job.numRuns;
+			for (int i = 0; i < numEntries; i++) {
+				setFrameDirty(pool, entries[i].frameIndex);
+			}
+		}
+	}
+
+	pthread_t writers[FLUSH_WRITERS - 1];
+	int numWriters = 0;
+
+	while (numWriters < FLUSH_WRITERS - 1 && numWriters + 1 < job.numRuns - job.nextRun
+			&& pthread_create(&writers[numWriters], NULL, flushWriter, &job) == 0) {
+		numWriters++;
+	}
+	flushWriter(&job);
+	for (int i = 0; i < numWriters; i++) {
+		pthread_join(writers[i], NULL);
+	}
+
+	for (int i = 0; i < numEntries; i++) {
+		releasePin(&pool->frames[entries[i].frameIndex]);
+	}
+	free(entries);
+	free(runStarts);
+
+    return job.firstError;
+}
+
+/* ***** BACKGROUND PAGE CLEANER ***** */
+
+typedef struct CleanerCandidate {
+	int frameIndex;
+	int order;
+} CleanerCandidate;
+
+static int compareCleanerCandidates(const void *first, const void *second) {
+	const CleanerCandidate *a = first, *b = second;
+	return (a->order > b->order) - (a->order < b->order);
+}
+
+/**
+ * Description:
+ * Number of dirty frames the cleaner still has to write to get back to its clean target.
+ */
+static int framesToClean(BufferPoolManagement *pool) {
+	int cleanWanted = (int) (pool->cleanTarget * pool->numFrames);
+	if (cleanWanted < pool->cleanTarget * pool->numFrames) {
+		cleanWanted++;
+	}
+	return cleanWanted - (pool->numFrames - pool->numDirty);
+}
+
+/**
+ * Description:
+ * Writes an unpinned dirty frame back without replacing it. The frame is pinned for the
+ * duration of the write so it stays where it is.
+ *
+ * @return true if the frame was written.
+ */
+static bool cleanUnpinnedFrame(BufferPoolManagement *pool, int frameIndex) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+	PageNumber pageNum = frame->pageNumber;
+	int fileId = frame->fileId;
+
+	if (pageNum == NO_PAGE) {
+		return false;
+	}
+
+	PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+	pthread_mutex_lock(&shard->lock);
+
+	if (frame->pageNumber != pageNum || frame->fileId != fileId || frame->fixCountInfo != 0
+			|| frame->dirtyBit == 0 || frame->ioInProgress) {
+		pthread_mutex_unlock(&shard->lock);
+		return false;
+	}
+	frame->fixCountInfo++;
+	pthread_mutex_unlock(&shard->lock);
+
+	RC rc = cleanPinnedFrame(pool, frameIndex);
+	releasePin(frame);
+
+	return rc == RC_OK;
+}
+
+/**
+ * Description:
+ * Body of the page cleaner thread. Whenever fewer than `cleanTarget` of the frames are clean it
+ * takes the frames queued on the dirty frame list, orders the unpinned ones the way the
+ * replacement strategy would evict them and writes back just enough of the closest ones to
+ * reach the target again. Frames that are pinned or beyond the budget are queued again.
+ * Without work it sleeps until markDirty() or a replacement that found no clean frame wakes it.
+ */
+static void *pageCleaner(void *arg) {
+	BufferPoolManagement *pool = (BufferPoolManagement *) arg;
+	int *listed = malloc(sizeof(int) * pool->frameCapacity);
+	CleanerCandidate *candidates = malloc(sizeof(CleanerCandidate) * pool->frameCapacity);
+	bool wroteSomething = true;
+
+	pthread_mutex_lock(&pool->cleanerLock);
+	while (pool->cleanerRunning) {
+		if (!wroteSomething || framesToClean(pool) <= 0 || pool->numDirtyListed == 0) {
+			struct timespec deadline;
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += CLEANER_IDLE_WAIT_MS * 1000000L;
+			deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+			deadline.tv_nsec %= 1000000000L;
+
+			pthread_cond_timedwait(&pool->cleanerWakeup, &pool->cleanerLock, &deadline);
+			wroteSomething = true;
+			continue;
+		}
+
+		int numListed = pool->numDirtyListed;
+		memcpy(listed, pool->dirtyList, sizeof(int) * numListed);
+		pool->numDirtyListed = 0;
+		pthread_mutex_unlock(&pool->cleanerLock);
+
+		int numCandidates = 0;
+		for (int i = 0; i < numListed; i++) {
+			FramesInPage *frame = &pool->frames[listed[i]];
+			frame->onDirtyList = false;
+
+			if (frame->dirtyBit == 1 && frame->fixCountInfo == 0 && frame->pageNumber != NO_PAGE) {
+				candidates[numCandidates].frameIndex = listed[i];
+				candidates[numCandidates].order = replacementOrder(pool, frame);
+				numCandidates++;
+			} else if (frame->dirtyBit == 1) {
+				queueDirtyFrame(pool, listed[i]);
+			}
+		}
+		qsort(candidates, numCandidates, sizeof(CleanerCandidate), compareCleanerCandidates);
+
+		int budget = framesToClean(pool);
+		wroteSomething = false;
+		for (int i = 0; i < numCandidates; i++) {
+			if (i < budget && cleanUnpinnedFrame(pool, candidates[i].frameIndex)) {
+				countEvent(pool, STAT_CLEANER_WRITES, 1);
+				wroteSomething = true;
+			} else if (pool->frames[candidates[i].frameIndex].dirtyBit == 1) {
+				queueDirtyFrame(pool, candidates[i].frameIndex);
+			}
+		}
+
+		pthread_mutex_lock(&pool->cleanerLock);
+	}
+	pthread_mutex_unlock(&pool->cleanerLock);
+
+	free(listed);
+	free(candidates);
+	return NULL;
+}
+
+/*
+ * Description:
+ * startPageCleaner() starts a background thread that writes dirty pages back before they are
+ * chosen for replacement, so that pinPage() finds a clean frame to replace and does not have to
+ * wait for a write. The cleaner keeps at least `cleanFraction` of the frames clean and stays
+ * idle otherwise. Calling it again on a running cleaner only changes the target.
+ * On a shared pool the cleaner works for all files of the pool.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param cleanFraction fraction of frames (0 < cleanFraction <= 1) to keep clean.
+ *
+ * @return RC_OK, RC_INVALID_INPUT for a bad fraction.
+*/
+RC startPageCleaner(BM_BufferPool *const bm, double cleanFraction) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (cleanFraction <= 0 || cleanFraction > 1) {
+		return RC_INVALID_INPUT;
+	}
+
+	pthread_mutex_lock(&pool->cleanerLock);
+	pool->cleanTarget = cleanFraction;
+	if (pool->cleanerRunning) {
+		pthread_cond_signal(&pool->cleanerWakeup);
+		pthread_mutex_unlock(&pool->cleanerLock);
+		return RC_OK;
+	}
+
+	pool->dirtyList = malloc(sizeof(int) * pool->frameCapacity);
+	if (pool->dirtyList == NULL) {
+		pthread_mutex_unlock(&pool->cleanerLock);
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+	pool->numDirtyListed = 0;
+	pool->cleanerRunning = true;
+	pthread_mutex_unlock(&pool->cleanerLock);
+
+	// frames that were already dirty before the cleaner started
+	for (int i = 0; i < pool->numFrames; i++) {
+		if (pool->frames[i].dirtyBit == 1) {
+			queueDirtyFrame(pool, i);
+		}
+	}
+
+	if (pthread_create(&pool->cleanerThread, NULL, pageCleaner, pool) != 0) {
+		stopPoolCleaner(pool);
+		return RC_ERROR;
+	}
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * stopPageCleaner() stops the page cleaner of the pool, if one is running, and waits for it.
+ * From then on dirty pages are written when they are replaced, as without a cleaner.
+*/
+RC stopPageCleaner(BM_BufferPool *const bm) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	return stopPoolCleaner(pool);
+}
+
+static RC stopPoolCleaner(BufferPoolManagement *pool) {
+	pthread_mutex_lock(&pool->cleanerLock);
+	if (!pool->cleanerRunning) {
+		pthread_mutex_unlock(&pool->cleanerLock);
+		return RC_OK;
+	}
+	pool->cleanerRunning = false;
+	pthread_cond_signal(&pool->cleanerWakeup);
+	pthread_mutex_unlock(&pool->cleanerLock);
+
+	pthread_join(pool->cleanerThread, NULL);
+
+	pthread_mutex_lock(&pool->cleanerLock);
+	for (int i = 0; i < pool->frameCapacity; i++) {
+		pool->frames[i].onDirtyList = false;
+	}
+	free(pool->dirtyList);
+	pool->dirtyList = NULL;
+	pool->numDirtyListed = 0;
+	pthread_mutex_unlock(&pool->cleanerLock);
+
+	return RC_OK;
+}
+
+/* ***** RESIZING ***** */
+
+/**
+ * Description:
+ * Takes a frame that a shrink gives up out of use. A free frame is taken off the free list,
+ * a clean unpinned page is dropped and a dirty one is written back for the next round.
+ * Pinned pages and frames another thread has just claimed are left for the next round too.
+ *
+ * @return true if the frame is retired.
+ */
+static bool retireFrame(BufferPoolManagement *pool, int frameIndex) {
+	FramesInPage *frame = &pool->frames[frameIndex];
+	PageNumber pageNum = frame->pageNumber;
+	int fileId = frame->fileId;
+
+	if (pageNum == NO_PAGE) {
+		pthread_mutex_lock(&pool->freeLock);
+		for (int i = 0; i < pool->numFreeFrames && !frame->retired; i++) {
+			if (pool->freeFrames[i] == frameIndex) {
+				pool->freeFrames[i] = pool->freeFrames[--pool->numFreeFrames];
+				frame->retired = true;
+			}
+		}
+		bool retired = frame->retired;
+		pthread_mutex_unlock(&pool->freeLock);
+		return retired;
+	}
+
+	PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+	bool dropped = false;
+
+	pthread_mutex_lock(&shard->lock);
+	if (frame->pageNumber == pageNum && frame->fileId == fileId && !frame->ioInProgress && frame->dirtyBit == 0) {
+		dropped = detachFrame(pool, shard, frameIndex, pageNum, 0);
+	}
+	pthread_mutex_unlock(&shard->lock);
+
+	if (!dropped) {
+		cleanUnpinnedFrame(pool, frameIndex);
+		return false;
+	}
+	frame->retired = true;
+	releasePin(frame);
+	return true;
+}
+
+/**
+ * Description:
+ * Hands the reserved frames up to `newNumFrames` to the free list.
+ */
+static void growPool(BufferPoolManagement *pool, int newNumFrames) {
+	int numFrames = pool->numFrames;
+
+	pool->numFrames = newNumFrames;
+
+	pthread_mutex_lock(&pool->freeLock);
+	pool->frameLimit = newNumFrames;
+	for (int i = newNumFrames - 1; i >= numFrames; i--) {
+		pool->frames[i].retired = false;
+		pool->freeFrames[pool->numFreeFrames++] = i;
+	}
+	pthread_mutex_unlock(&pool->freeLock);
+}
+
+/**
+ * Description:
+ * Gives up the frames from `newNumFrames` on. New pages stop going into them at once, then
+ * they are retired one by one, waiting at most RESIZE_WAIT_MS for pages that are pinned.
+ * If that is not enough the frames are handed back and the pool keeps its size.
+ */
+static RC shrinkPool(BufferPoolManagement *pool, int newNumFrames) {
+	int numFrames = pool->numFrames;
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	pool->frameLimit = newNumFrames;
+
+	while (true) {
+		bool allRetired = true;
+
+		for (int i = newNumFrames; i < numFrames; i++) {
+			if (!retireFrame(pool, i)) {
+				allRetired = false;
+			}
+		}
+		if (allRetired) {
+			break;
+		}
+
+		if (elapsedNanos(&start) > RESIZE_WAIT_MS * 1000000L) {
+			pthread_mutex_lock(&pool->freeLock);
+			pool->frameLimit = numFrames;
+			for (int i = numFrames - 1; i >= newNumFrames; i--) {
+				if (pool->frames[i].retired) {
+					pool->frames[i].retired = false;
+					pool->freeFrames[pool->numFreeFrames++] = i;
+				}
+			}
+			pthread_mutex_unlock(&pool->freeLock);
+			return RC_PINNED_PAGES_IN_BUFFER;
+		}
+		sched_yield();
+	}
+
+	pool->numFrames = newNumFrames;
+
+	// the pages of the retired frames go back to the system, they are zero filled on next use
+	madvise(pool->arena + (size_t) newNumFrames * PAGE_SIZE, (size_t) (numFrames - newNumFrames) * PAGE_SIZE, MADV_DONTNEED);
+	return RC_OK;
+}
+
+static RC resizePool(BufferPoolManagement *pool, int newNumFrames) {
+	RC rc = RC_OK;
+
+	if (newNumFrames <= 0) {
+		return RC_INVALID_INPUT;
+	}
+	if (newNumFrames > pool->frameCapacity) {
+		return RC_POOL_CAPACITY_EXCEEDED;
+	}
+
+	pthread_mutex_lock(&pool->resizeLock);
+	if (newNumFrames > pool->numFrames) {
+		growPool(pool, newNumFrames);
+	} else if (newNumFrames < pool->numFrames) {
+		rc = shrinkPool(pool, newNumFrames);
+	}
+
+	if (rc == RC_OK) {
+		int window = pool->requestedPrefetchWindow;
+		pool->prefetchWindow = window < newNumFrames / 2 ? window : newNumFrames / 2;
+	}
+	pthread_mutex_unlock(&pool->resizeLock);
+
+	return rc;
+}
+
+/*
+ * Description:
+ * resizeBufferPool() changes the number of page frames while the pool is in use. Growing hands
+ * frames of the arena the pool reserved (see BM_PoolOptions.maxPages) to the free list.
+ * Shrinking stops new pages from going into the frames beyond `newNumPages`, writes their
+ * dirty pages back, drops them and returns their memory to the system. Pins are not blocked
+ * by a resize, a shrink rather waits up to RESIZE_WAIT_MS for pages pinned in the frames it
+ * removes and is undone if they stay pinned.
+ * On a shared pool all files lose or gain the frames. Other BM_BufferPools opened on the pool
+ * keep the `numPages` they were opened with.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param newNumPages the new number of page frames.
+ *
+ * @return RC_OK, RC_INVALID_INPUT, RC_POOL_CAPACITY_EXCEEDED beyond the reserved frames or
+ * RC_PINNED_PAGES_IN_BUFFER if pages stayed pinned in the frames a shrink would remove.
+*/
+RC resizeBufferPool(BM_BufferPool *const bm, const int newNumPages) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+
+	RC rc = resizePool(pool, newNumPages);
+	if (rc == RC_OK) {
+		bm->numPages = newNumPages;
+	}
+	return rc;
+}
+
+/**
+ * Description:
+ * Number of times the cgroup went over memory.high, read from its memory.events file.
+ */
+static long readMemoryHighEvents(int fd) {
+	char events[512];
+	ssize_t length = pread(fd, events, sizeof(events) - 1, 0);
+
+	if (length <= 0) {
+		return -1;
+	}
+	events[length] = '\0';
+
+	char *high = (strncmp(events, "high ", 5) == 0) ? events : strstr(events, "\nhigh ");
+	if (high == NULL) {
+		return -1;
+	}
+	return atol(high + (high == events ? 5 : 6));
+}
+
+/**
+ * Description:
+ * Opens what the memory pressure watcher waits on: a PSI trigger on the memory stalls of the
+ * system or, without PSI, the memory.events file of the process's cgroup (cgroup v2), which
+ * signals a change whenever the cgroup goes over memory.high.
+ *
+ * @return the file descriptor, -1 if neither is available.
+ */
+static int openPressureSource(BufferPoolManagement *pool) {
+	int fd = open(PSI_MEMORY_FILE, O_RDWR | O_NONBLOCK);
+
+	if (fd >= 0) {
+		if (write(fd, PSI_MEMORY_TRIGGER, strlen(PSI_MEMORY_TRIGGER) + 1) >= 0) {
+			pool->pressureFromPsi = true;
+			return fd;
+		}
+		close(fd);
+	}
+
+	FILE *cgroups = fopen("/proc/self/cgroup", "r");
+	if (cgroups == NULL) {
+		return -1;
+	}
+
+	char line[512], path[600];
+	fd = -1;
+	while (fd < 0 && fgets(line, sizeof(line), cgroups) != NULL) {
+		// the cgroup v2 entry reads "0::/path/of/the/cgroup"
+		if (strncmp(line, "0::", 3) == 0) {
+			line[strcspn(line, "\n")] = '\0';
+			snprintf(path, sizeof(path), "/sys/fs/cgroup%s/memory.events", line + 3);
+			fd = open(path, O_RDONLY);
+		}
+	}
+	fclose(cgroups);
+
+	if (fd >= 0) {
+		pool->pressureFromPsi = false;
+		pool->memoryHighEvents = readMemoryHighEvents(fd);
+	}
+	return fd;
+}
+
+/**
+ * Description:
+ * Body of the memory pressure watcher. Each pressure event shrinks the pool by a
+ * PRESSURE_SHRINK_DIVISOR part, down to `pressureMinFrames`. A shrink that fails because
+ * pages stay pinned is simply tried again at the next event.
+ */
+static void *pressureWatcher(void *arg) {
+	BufferPoolManagement *pool = (BufferPoolManagement *) arg;
+	struct pollfd source = { .fd = pool->pressureFd, .events = POLLPRI };
+	struct timespec lastShrink;
+	bool shrunk = false;
+
+	while (pool->pressureWatchRunning) {
+		if (poll(&source, 1, PRESSURE_POLL_MS) <= 0 || !(source.revents & (POLLPRI | POLLERR))) {
+			continue;
+		}
+
+		if (pool->pressureFromPsi) {
+			// the trigger went away
+			if (source.revents & POLLERR) {
+				break;
+			}
+		} else {
+			long events = readMemoryHighEvents(pool->pressureFd);
+			if (events <= pool->memoryHighEvents) {
+				continue;
+			}
+			pool->memoryHighEvents = events;
+		}
+
+		if (shrunk && elapsedNanos(&lastShrink) < PRESSURE_SHRINK_INTERVAL_MS * 1000000L) {
+			continue;
+		}
+
+		int numFrames = pool->numFrames;
+		int newNumFrames = numFrames - numFrames / PRESSURE_SHRINK_DIVISOR;
+		if (newNumFrames < pool->pressureMinFrames) {
+			newNumFrames = pool->pressureMinFrames;
+		}
+		if (newNumFrames < numFrames && resizePool(pool, newNumFrames) == RC_OK) {
+			clock_gettime(CLOCK_MONOTONIC, &lastShrink);
+			shrunk = true;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Description:
+ * startMemoryPressureWatch() starts a thread that gives memory back when the system runs short
+ * of it: on every memory pressure event the pool is shrunk by a quarter (see resizeBufferPool()),
+ * but not below `minNumPages` frames and at most once every PRESSURE_SHRINK_INTERVAL_MS.
+ * Pressure is taken from Linux PSI (/proc/pressure/memory) or, without it, from the
+ * memory.high events of the process's cgroup. Growing the pool back is left to the caller.
+ * Calling it again on a running watcher only changes the minimum.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param minNumPages the pool is not shrunk below this number of frames.
+ *
+ * @return RC_OK, RC_INVALID_INPUT, RC_MEMORY_PRESSURE_UNAVAILABLE if the system offers neither.
+*/
+RC startMemoryPressureWatch(BM_BufferPool *const bm, const int minNumPages) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (minNumPages <= 0) {
+		return RC_INVALID_INPUT;
+	}
+
+	pthread_mutex_lock(&pool->pressureLock);
+	pool->pressureMinFrames = minNumPages;
+	if (pool->pressureWatchRunning) {
+		pthread_mutex_unlock(&pool->pressureLock);
+		return RC_OK;
+	}
+
+	pool->pressureFd = openPressureSource(pool);
+	if (pool->pressureFd < 0) {
+		pthread_mutex_unlock(&pool->pressureLock);
+		return RC_MEMORY_PRESSURE_UNAVAILABLE;
+	}
+
+	pool->pressureWatchRunning = true;
+	if (pthread_create(&pool->pressureThread, NULL, pressureWatcher, pool) != 0) {
+		pool->pressureWatchRunning = false;
+		close(pool->pressureFd);
+		pool->pressureFd = -1;
+		pthread_mutex_unlock(&pool->pressureLock);
+		return RC_ERROR;
+	}
+	pthread_mutex_unlock(&pool->pressureLock);
+
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * stopMemoryPressureWatch() stops the memory pressure watcher of the pool, if one is running.
+ * The pool keeps the size it was shrunk to.
+*/
+RC stopMemoryPressureWatch(BM_BufferPool *const bm) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	stopPressureWatch(pool);
+	return RC_OK;
+}
+
+static void stopPressureWatch(BufferPoolManagement *pool) {
+	pthread_mutex_lock(&pool->pressureLock);
+	if (pool->pressureWatchRunning) {
+		pool->pressureWatchRunning = false;
+		pthread_join(pool->pressureThread, NULL);
+		close(pool->pressureFd);
+		pool->pressureFd = -1;
+	}
+	pthread_mutex_unlock(&pool->pressureLock);
+}
+
+/* ***** PAGE TRACE ***** */
+
+/*
+ * Description:
+ * startPageTrace() records every pin and unpin of the pool the BM_BufferPool is opened on, of all
+ * its page files, in `traceFile`: the page, the time and whether the pin was a hit or a miss.
+ * The file holds the last `maxEvents` events in a ring (see page_trace.h), is mapped into memory
+ * and can be read while the trace runs. trace_sim replays it against several replacement
+ * strategies and pool sizes.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param traceFile file to write the trace to, it is created or truncated.
+ * @param maxEvents number of events the ring holds.
+ *
+ * @return RC_OK, RC_PAGE_TRACE_RUNNING if the pool is already traced, RC_FILE_NOT_FOUND if the
+ * file can not be created or RC_WRITE_FAILED if it can not be sized or mapped.
+*/
+RC startPageTrace(BM_BufferPool *const bm, const char *const traceFile, const int maxEvents) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (traceFile == NULL || maxEvents <= 0) {
+		return RC_INVALID_INPUT;
+	}
+
+	pthread_mutex_lock(&pool->traceLock);
+	if (pool->traceHeader != NULL) {
+		pthread_mutex_unlock(&pool->traceLock);
+		return RC_PAGE_TRACE_RUNNING;
+	}
+
+	size_t traceSize = sizeof(PageTraceHeader) + (size_t) maxEvents * sizeof(PageTraceEvent);
+	int fd = open(traceFile, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		pthread_mutex_unlock(&pool->traceLock);
+		return RC_FILE_NOT_FOUND;
+	}
+	void *mapped = MAP_FAILED;
+	if (ftruncate(fd, traceSize) == 0) {
+		mapped = mmap(NULL, traceSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		pthread_mutex_unlock(&pool->traceLock);
+		return RC_WRITE_FAILED;
+	}
+
+	struct timespec realTime;
+	clock_gettime(CLOCK_REALTIME, &realTime);
+	clock_gettime(CLOCK_MONOTONIC, &pool->traceStart);
+
+	PageTraceHeader *header = mapped;
+	header->magic = PAGE_TRACE_MAGIC;
+	header->version = PAGE_TRACE_VERSION;
+	header->capacity = maxEvents;
+	header->numFrames = pool->numFrames;
+	header->numEvents = 0;
+	header->startTime = realTime.tv_sec * 1000000000UL + realTime.tv_nsec;
+
+	pool->traceHeader = header;
+	pool->traceEvents = (PageTraceEvent *) (header + 1);
+	pool->traceSize = traceSize;
+	pool->tracing = true;
+	pthread_mutex_unlock(&pool->traceLock);
+
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * stopPageTrace() ends the trace of the pool and writes the trace file out.
+ *
+ * @return RC_OK, also if no trace was running.
+*/
+RC stopPageTrace(BM_BufferPool *const bm) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	stopTrace(pool);
+	return RC_OK;
+}
+
+static void stopTrace(BufferPoolManagement *pool) {
+	pthread_mutex_lock(&pool->traceLock);
+	if (pool->traceHeader != NULL) {
+		pool->tracing = false;
+		while (pool->traceWriters > 0) {
+			sched_yield();
+		}
+		msync(pool->traceHeader, pool->traceSize, MS_SYNC);
+		munmap(pool->traceHeader, pool->traceSize);
+		pool->traceHeader = NULL;
+		pool->traceEvents = NULL;
+	}
+	pthread_mutex_unlock(&pool->traceLock);
+}
+
+/* ***** PREFETCHING ***** */
+
+/**
+ * Description:
+ * Reads the pages `pageNums[0..n-1]` of file `fileId` into free or clean frames as one batch,
+ * see loadIntoFrames(), and leaves them unpinned. Pages that are already in the pool or beyond
+ * the end of the page file are skipped, and so are the remaining pages once every frame is
+ * pinned or dirty: a prefetch never waits for a write. The frames held for the batch always
+ * leave `prefetchWindow` + 1 frames of the pool unpinned, so the pins the read ahead is for
+ * still find a frame.
+ */
+static void prefetchRun(BufferPoolManagement *pool, int fileId, const PageNumber *pageNums, int n) {
+	int frames[n];
+	PageNumber pages[n];
+	bool alreadyResident[n];
+	RC results[n];
+	int numLoads = 0;
+
+	int headroom = pool->prefetchWindow + 1;
+	int numUnpinned = 0;
+	for (int i = 0; i < pool->frameLimit; i++) {
+		numUnpinned += pool->frames[i].fixCountInfo == 0;
+	}
+
+	for (int i = 0; i < n && numLoads < numUnpinned - headroom; i++) {
+		if (findFrameUnlocked(pool, fileId, pageNums[i]) != NO_FRAME) {
+			continue;
+		}
+		int frameIndex = claimFrame(pool, fileId, true);
+		if (frameIndex == NO_FRAME) {
+			break;
+		}
+		pool->readAheadFrames++;
+		frames[numLoads] = frameIndex;
+		pages[numLoads] = pageNums[i];
+		numLoads++;
+	}
+
+	if (numLoads > 0) {
+		loadIntoFrames(pool, fileId, frames, pages, numLoads, false, alreadyResident, results);
+	}
+	for (int i = 0; i < numLoads; i++) {
+		if (results[i] == RC_OK && !alreadyResident[i]) {
+			releasePin(&pool->frames[frames[i]]);
+			countEvent(pool, STAT_PREFETCH_READS, 1);
+		}
+	}
+	// the prefetch thread wakes the pins waiting for these frames once it takes prefetchLock
+	pool->readAheadFrames -= numLoads;
+}
+
+/**
+ * Description:
+ * Body of the prefetch thread, reads the queued pages in the order they were asked for. A run of
+ * up to PREFETCH_BATCH_PAGES queued pages that follow each other in one file, as read ahead
+ * queues them, is taken off the queue together and read with one readBlocks().
+ */
+static void *prefetcher(void *arg) {
+	BufferPoolManagement *pool = (BufferPoolManagement *) arg;
+	PageNumber pageNums[PREFETCH_BATCH_PAGES];
+
+	pthread_mutex_lock(&pool->prefetchLock);
+	while (pool->prefetcherRunning) {
+		if (pool->numPrefetchQueued == 0) {
+			pthread_cond_wait(&pool->prefetchWakeup, &pool->prefetchLock);
+			continue;
+		}
+
+		int fileId = pool->prefetchQueue[pool->prefetchHead].fileId;
+		int n = 0;
+		do {
+			pageNums[n++] = pool->prefetchQueue[pool->prefetchHead].pageNum;
+			pool->prefetchHead = (pool->prefetchHead + 1) % PREFETCH_QUEUE_SIZE;
+			pool->numPrefetchQueued--;
+		} while (n < PREFETCH_BATCH_PAGES && pool->numPrefetchQueued > 0
+				&& pool->prefetchQueue[pool->prefetchHead].fileId == fileId
+				&& pool->prefetchQueue[pool->prefetchHead].pageNum == pageNums[n - 1] + 1);
+		pool->prefetchingFile = fileId;
+		pthread_mutex_unlock(&pool->prefetchLock);
+
+		prefetchRun(pool, fileId, pageNums, n);
+
+		pthread_mutex_lock(&pool->prefetchLock);
+		pool->prefetchingFile = NO_FILE;
+		pthread_cond_broadcast(&pool->prefetchDone);
+	}
+	pthread_mutex_unlock(&pool->prefetchLock);
+	return NULL;
+}
+
+/**
+ * Description:
+ * Stops the prefetch thread, if it was started, dropping the requests it has not read yet.
+ */
+static void stopPrefetcher(BufferPoolManagement *pool) {
+	pthread_mutex_lock(&pool->prefetchLock);
+	if (!pool->prefetcherStarted) {
+		pthread_mutex_unlock(&pool->prefetchLock);
+		return;
+	}
+	pool->prefetcherRunning = false;
+	pool->prefetcherStarted = false;
+	pool->numPrefetchQueued = 0;
+	pthread_cond_signal(&pool->prefetchWakeup);
+	pthread_mutex_unlock(&pool->prefetchLock);
+
+	pthread_join(pool->prefetchThread, NULL);
+}
+
+/**
+ * Description:
+ * Drops the queued requests for pages of a file and waits until the prefetch thread is done
+ * with the one it may be reading, so that no page of the file enters the pool afterwards.
+ */
+static void cancelPrefetches(BufferPoolManagement *pool, int fileId) {
+	pthread_mutex_lock(&pool->prefetchLock);
+
+	int numKept = 0;
+	for (int i = 0; i < pool->numPrefetchQueued; i++) {
+		PrefetchRequest request = pool->prefetchQueue[(pool->prefetchHead + i) % PREFETCH_QUEUE_SIZE];
+		if (request.fileId != fileId) {
+			pool->prefetchQueue[(pool->prefetchHead + numKept) % PREFETCH_QUEUE_SIZE] = request;
+			numKept++;
+		}
+	}
+	pool->numPrefetchQueued = numKept;
+
+	while (pool->prefetchingFile == fileId) {
+		pthread_cond_wait(&pool->prefetchDone, &pool->prefetchLock);
+	}
+	pthread_mutex_unlock(&pool->prefetchLock);
+}
+
+/*
+ * Description:
+ * prefetchPages() asks for the pages in `pageNums` to be read into the pool in the background
+ * so that a later pinPage() of them does not wait for the disk. The pages are loaded into free
+ * or clean frames and stay unpinned. This is only a hint: requests beyond PREFETCH_QUEUE_SIZE
+ * outstanding pages and pages that do not exist in the page file are dropped.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param pageNums pages to read, in the order they should be read.
+ * @param n number of entries of `pageNums`.
+ *
+ * @return RC_OK, RC_INVALID_INPUT if `pageNums` is NULL or `n` negative.
+*/
+RC prefetchPages(BM_BufferPool *const bm, const PageNumber *pageNums, int n) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if ((pageNums == NULL && n > 0) || n < 0) {
+		return RC_INVALID_INPUT;
+	}
+
+	int fileId = fileOf(bm);
+
+	pthread_mutex_lock(&pool->prefetchLock);
+	if (!pool->prefetcherStarted) {
+		pool->prefetcherRunning = true;
+		if (pthread_create(&pool->prefetchThread, NULL, prefetcher, pool) != 0) {
+			pool->prefetcherRunning = false;
+			pthread_mutex_unlock(&pool->prefetchLock);
+			return RC_ERROR;
+		}
+		pool->prefetcherStarted = true;
+	}
+
+	for (int i = 0; i < n && pool->numPrefetchQueued < PREFETCH_QUEUE_SIZE; i++) {
+		if (pageNums[i] < 0) {
+			continue;
+		}
+		int tail = (pool->prefetchHead + pool->numPrefetchQueued) % PREFETCH_QUEUE_SIZE;
+		pool->prefetchQueue[tail].fileId = fileId;
+		pool->prefetchQueue[tail].pageNum = pageNums[i];
+		pool->numPrefetchQueued++;
+	}
+	pthread_cond_signal(&pool->prefetchWakeup);
+	pthread_mutex_unlock(&pool->prefetchLock);
+
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Read ahead for sequential scans. Once SEQUENTIAL_RUN_TRIGGER consecutive pages were pinned in
+ * order, the next `prefetchWindow` pages are requested, and the window is topped up again each
+ * time the scan has used half of it. Pinning the same page again does not break a run,
+ * any other jump does. Runs are tracked per file. The state is only written when a pin extends
+ * or breaks a run, and a sequence of random pins only writes the last pinned page.
+ */
+static void detectSequentialAccess(BM_BufferPool *const bm, BufferPoolManagement *pool, PageNumber pageNum) {
+	if (pool->prefetchWindow == 0) {
+		return;
+	}
+	PoolFile *file = &pool->files[fileOf(bm)];
+
+	// pins of the page the run is at only read the shared state, the rest write what changes
+	PageNumber lastPage = atomic_load_explicit(&file->lastPinnedPage, memory_order_relaxed);
+	if (pageNum == lastPage) {
+		return;
+	}
+	atomic_store_explicit(&file->lastPinnedPage, pageNum, memory_order_relaxed);
+	if (pageNum != lastPage + 1) {
+		if (file->sequentialRun != 0 || file->prefetchedUpTo != NO_PAGE) {
+			file->sequentialRun = 0;
+			file->prefetchedUpTo = NO_PAGE;
+		}
+		return;
+	}
+	if (++file->sequentialRun < SEQUENTIAL_RUN_TRIGGER) {
+		return;
+	}
+
+	PageNumber prefetchedUpTo = file->prefetchedUpTo;
+	if (prefetchedUpTo - pageNum > pool->prefetchWindow / 2) {
+		return;
+	}
+
+	PageNumber from = prefetchedUpTo >= pageNum ? prefetchedUpTo + 1 : pageNum + 1;
+	PageNumber to = pageNum + pool->prefetchWindow;
+	if (from > to || !atomic_compare_exchange_strong(&file->prefetchedUpTo, &prefetchedUpTo, to)) {
+		return;
+	}
+
+	PageNumber pages[to - from + 1];
+	for (PageNumber p = from; p <= to; p++) {
+		pages[p - from] = p;
+	}
+	prefetchPages(bm, pages, to - from + 1);
+}
+
+/* ***** WARM START ***** */
+
+// a resident page as dumpPoolManifest() sees it
+typedef struct ManifestEntry {
+	int fileId;
+	PageNumber pageNum;
+	int hitNumber;
+	int loadNumber;
+} ManifestEntry;
+
+// most recently used first
+static int compareManifestEntries(const void *first, const void *second) {
+	const ManifestEntry *a = first, *b = second;
+	if (a->hitNumber != b->hitNumber) {
+		return (a->hitNumber < b->hitNumber) - (a->hitNumber > b->hitNumber);
+	}
+	return (a->loadNumber < b->loadNumber) - (a->loadNumber > b->loadNumber);
+}
+
+static int comparePageNumbers(const void *first, const void *second) {
+	PageNumber a = *(const PageNumber *) first, b = *(const PageNumber *) second;
+	return (a > b) - (a < b);
+}
+
+/*
+ * Description:
+ * dumpPoolManifest() writes the list of pages in the pool of `bm` to the manifest file
+ * `manifestFile`, for warmBufferPool() after a restart. It covers every file open on the pool
+ * and lists the pages by file name and page number, the most recently used first. The manifest
+ * is written to `manifestFile`.tmp first and renamed when complete, so a crash never leaves a
+ * torn manifest behind.
+ *
+ * The format is text: a line "BM_POOL_MANIFEST <version>", a line "files <n>" followed by one
+ * file name per line, then a line "pages <m>" followed by lines "<file index> <page number>".
+ *
+ * @return RC_OK, RC_INVALID_INPUT, RC_MEMORY_ALLOCATION_FAIL or RC_WRITE_FAILED.
+*/
+RC dumpPoolManifest(BM_BufferPool *const bm, const char *const manifestFile) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (manifestFile == NULL) {
+		return RC_INVALID_INPUT;
+	}
+
+	int numFrames = pool->numFrames;
+	ManifestEntry *entries = malloc(sizeof(ManifestEntry) * numFrames);
+	char *tempFile = malloc(strlen(manifestFile) + 5);
+	if (entries == NULL || tempFile == NULL) {
+		free(entries);
+		free(tempFile);
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+	// frames change under us, the manifest is a hint and a page that just left does no harm
+	int numEntries = 0;
+	for (int i = 0; i < numFrames; i++) {
+		FramesInPage *frame = &pool->frames[i];
+		PageNumber pageNum = frame->pageNumber;
+		int fileId = frame->fileId;
+
+		if (pageNum != NO_PAGE && fileId != NO_FILE && !frame->ioInProgress) {
+			entries[numEntries].fileId = fileId;
+			entries[numEntries].pageNum = pageNum;
+			entries[numEntries].hitNumber = frame->hitNumber;
+			entries[numEntries].loadNumber = frame->loadNumber;
+			numEntries++;
+		}
+	}
+	qsort(entries, numEntries, sizeof(ManifestEntry), compareManifestEntries);
+
+	sprintf(tempFile, "%s.tmp", manifestFile);
+	FILE *out = fopen(tempFile, "w");
+	if (out == NULL) {
+		free(entries);
+		free(tempFile);
+		return RC_WRITE_FAILED;
+	}
+
+	int fileIndex[MAX_POOL_FILES];
+	int numFiles = 0;
+
+	pthread_mutex_lock(&pool->filesLock);
+	for (int i = 0; i < MAX_POOL_FILES; i++) {
+		fileIndex[i] = pool->files[i].fileName != NULL ? numFiles++ : NO_FILE;
+	}
+	fprintf(out, "BM_POOL_MANIFEST %d\nfiles %d\n", MANIFEST_VERSION, numFiles);
+	for (int i = 0; i < MAX_POOL_FILES; i++) {
+		if (fileIndex[i] != NO_FILE) {
+			fprintf(out, "%s\n", pool->files[i].fileName);
+		}
+	}
+	pthread_mutex_unlock(&pool->filesLock);
+
+	int numPages = 0;
+	for (int i = 0; i < numEntries; i++) {
+		numPages += fileIndex[entries[i].fileId] != NO_FILE;
+	}
+	fprintf(out, "pages %d\n", numPages);
+	for (int i = 0; i < numEntries; i++) {
+		if (fileIndex[entries[i].fileId] != NO_FILE) {
+			fprintf(out, "%d %d\n", fileIndex[entries[i].fileId], entries[i].pageNum);
+		}
+	}
+
+	bool written = !ferror(out);
+	written = fclose(out) == 0 && written;
+	if (written) {
+		written = rename(tempFile, manifestFile) == 0;
+	}
+	if (!written) {
+		remove(tempFile);
+	}
+
+	free(entries);
+	free(tempFile);
+	return written ? RC_OK : RC_WRITE_FAILED;
+}
+
+/**
+ * Description:
+ * Reads the pages of one warm-up job into free frames, in batches of up to WARM_BATCH_PAGES
+ * pages that readFrames() reads in file order. Pages in use are never replaced for a warm-up:
+ * the job ends early once no frame is free, the file reached its quota, or it is cancelled.
+ */
+static void warmUpFile(BufferPoolManagement *pool, WarmUpJob *job) {
+	PoolFile *file = &pool->files[job->fileId];
+	int frames[WARM_BATCH_PAGES];
+	PageNumber pages[WARM_BATCH_PAGES];
+	bool alreadyResident[WARM_BATCH_PAGES];
+	RC results[WARM_BATCH_PAGES];
+	bool poolFull = false;
+
+	for (int next = 0; next < job->numPages && !poolFull && !pool->warmCancelled; ) {
+		int n = 0;
+
+		while (n < WARM_BATCH_PAGES && next < job->numPages) {
+			PageNumber pageNum = job->pageNums[next++];
+			if (findFrameUnlocked(pool, job->fileId, pageNum) != NO_FRAME) {
+				continue;
+			}
+			int frameIndex = NO_FRAME;
+			if (file->quota == 0 || file->numResident < file->quota) {
+				frameIndex = takeFreeFrame(pool);
+			}
+			if (frameIndex == NO_FRAME) {
+				poolFull = true;
+				break;
+			}
+			file->numResident++;
+			frames[n] = frameIndex;
+			pages[n] = pageNum;
+			n++;
+		}
+
+		if (n > 0) {
+			loadIntoFrames(pool, job->fileId, frames, pages, n, false, alreadyResident, results);
+		}
+		for (int i = 0; i < n; i++) {
+			if (results[i] == RC_OK && !alreadyResident[i]) {
+				releasePin(&pool->frames[frames[i]]);
+				countEvent(pool, STAT_PREFETCH_READS, 1);
+			}
+		}
+	}
+}
+
+/**
+ * Description:
+ * Body of the warm-up thread, works through the queued jobs and ends when none is left.
+ */
+static void *warmer(void *arg) {
+	BufferPoolManagement *pool = (BufferPoolManagement *) arg;
+
+	pthread_mutex_lock(&pool->warmLock);
+	while (pool->warmJobs != NULL) {
+		WarmUpJob *job = pool->warmJobs;
+		pool->warmJobs = job->next;
+		pool->warmingFile = job->fileId;
+		pool->warmCancelled = false;
+		pthread_mutex_unlock(&pool->warmLock);
+
+		warmUpFile(pool, job);
+
+		pthread_mutex_lock(&pool->warmLock);
+		pool->warmingFile = NO_FILE;
+		pthread_cond_broadcast(&pool->warmDone);
+		free(job->pageNums);
+		free(job);
+	}
+	pool->warmerActive = false;
+	pthread_mutex_unlock(&pool->warmLock);
+	return NULL;
+}
+
+/**
+ * Description:
+ * Drops the warm-up jobs of file `fileId` (of all files for ANY_FILE) and waits until the
+ * warm-up thread is done with the one it may be working on, see cancelPrefetches().
+ *
+ * @return whether a job was dropped or cut short.
+ */
+static bool cancelWarmUp(BufferPoolManagement *pool, int fileId) {
+	bool cut = false;
+
+	pthread_mutex_lock(&pool->warmLock);
+
+	WarmUpJob **link = &pool->warmJobs;
+	while (*link != NULL) {
+		WarmUpJob *job = *link;
+		if (fileId == ANY_FILE || job->fileId == fileId) {
+			*link = job->next;
+			free(job->pageNums);
+			free(job);
+			cut = true;
+		} else {
+			link = &job->next;
+		}
+	}
+
+	while (pool->warmingFile != NO_FILE && (fileId == ANY_FILE || pool->warmingFile == fileId)) {
+		pool->warmCancelled = true;
+		cut = true;
+		pthread_cond_wait(&pool->warmDone, &pool->warmLock);
+	}
+	pthread_mutex_unlock(&pool->warmLock);
+	return cut;
+}
+
+// stops the warm-up thread, returns whether a warm-up was cut short, see cancelWarmUp()
+static bool stopWarmUp(BufferPoolManagement *pool) {
+	bool cut = cancelWarmUp(pool, ANY_FILE);
+
+	pthread_mutex_lock(&pool->warmLock);
+	bool started = pool->warmerStarted;
+	pool->warmerStarted = false;
+	pthread_mutex_unlock(&pool->warmLock);
+
+	if (started) {
+		pthread_join(pool->warmThread, NULL);
+	}
+	return cut;
+}
+
+/**
+ * Description:
+ * Reads the pages a manifest lists for the file `fileName`, the first `maxPages` of them, i.e.
+ * the most recently used ones.
+ *
+ * @param pageNums receives the pages, sorted and without duplicates, to be freed by the caller.
+ * @return RC_OK, RC_FILE_NOT_FOUND, RC_INVALID_MANIFEST or RC_MEMORY_ALLOCATION_FAIL.
+ */
+static RC readManifest(const char *manifestFile, const char *fileName, int maxPages, PageNumber **pageNums, int *numPages) {
+	char line[MANIFEST_LINE_SIZE];
+	int version, numFiles, numEntries;
+	int ownIndex = NO_FILE;
+
+	FILE *in = fopen(manifestFile, "r");
+	if (in == NULL) {
+		return RC_FILE_NOT_FOUND;
+	}
+
+	bool valid = fgets(line, sizeof(line), in) != NULL && sscanf(line, "BM_POOL_MANIFEST %d", &version) == 1
+			&& version == MANIFEST_VERSION
+			&& fgets(line, sizeof(line), in) != NULL && sscanf(line, "files %d", &numFiles) == 1 && numFiles >= 0;
+
+	for (int i = 0; valid && i < numFiles; i++) {
+		valid = fgets(line, sizeof(line), in) != NULL;
+		line[strcspn(line, "\n")] = '\0';
+		if (valid && ownIndex == NO_FILE && strcmp(line, fileName) == 0) {
+			ownIndex = i;
+		}
+	}
+	valid = valid && fgets(line, sizeof(line), in) != NULL && sscanf(line, "pages %d", &numEntries) == 1 && numEntries >= 0;
+	if (!valid) {
+		fclose(in);
+		return RC_INVALID_MANIFEST;
+	}
+
+	*numPages = 0;
+	*pageNums = malloc(sizeof(PageNumber) * (maxPages > 0 ? maxPages : 1));
+	if (*pageNums == NULL) {
+		fclose(in);
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+	for (int i = 0; i < numEntries && *numPages < maxPages; i++) {
+		int index;
+		PageNumber pageNum;
+		if (fgets(line, sizeof(line), in) == NULL || sscanf(line, "%d %d", &index, &pageNum) != 2) {
+			break;
+		}
+		if (index == ownIndex && pageNum >= 0) {
+			(*pageNums)[(*numPages)++] = pageNum;
+		}
+	}
+	fclose(in);
+
+	qsort(*pageNums, *numPages, sizeof(PageNumber), comparePageNumbers);
+	int numUnique = 0;
+	for (int i = 0; i < *numPages; i++) {
+		if (numUnique == 0 || (*pageNums)[numUnique - 1] != (*pageNums)[i]) {
+			(*pageNums)[numUnique++] = (*pageNums)[i];
+		}
+	}
+	*numPages = numUnique;
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * warmBufferPool() reads the pages that a manifest written by dumpPoolManifest() lists for the
+ * page file of `bm` (matched by the name it was opened with) back into the pool, so that a
+ * restarted pool does not have to fill up one miss at a time. As many of the most recently used
+ * pages as the pool has frames are read, in file order and in batches, by a background thread
+ * while the pool serves pins. The warm-up only takes free frames and stops when there are none
+ * left. Closing the file cancels it.
+ *
+ * @return RC_OK once the warm-up is started, RC_FILE_NOT_FOUND if there is no manifest,
+ * RC_INVALID_MANIFEST, RC_MEMORY_ALLOCATION_FAIL or RC_ERROR if the thread can not be started.
+*/
+RC warmBufferPool(BM_BufferPool *const bm, const char *const manifestFile) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (manifestFile == NULL) {
+		return RC_INVALID_INPUT;
+	}
+
+	int fileId = fileOf(bm);
+	WarmUpJob *job = malloc(sizeof(WarmUpJob));
+	if (job == NULL) {
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+	RC rc = readManifest(manifestFile, pool->files[fileId].fileName, pool->numFrames, &job->pageNums, &job->numPages);
+	if (rc != RC_OK || job->numPages == 0) {
+		if (rc == RC_OK) {
+			free(job->pageNums);
+		}
+		free(job);
+		return rc;
+	}
+	job->fileId = fileId;
+	job->next = NULL;
+
+	pthread_mutex_lock(&pool->warmLock);
+	WarmUpJob **link = &pool->warmJobs;
+	while (*link != NULL) {
+		link = &(*link)->next;
+	}
+	*link = job;
+
+	if (!pool->warmerActive) {
+		// the thread of an earlier warm-up is done but still has to be joined
+		if (pool->warmerStarted) {
+			pthread_join(pool->warmThread, NULL);
+		}
+		pool->warmerStarted = pthread_create(&pool->warmThread, NULL, warmer, pool) == 0;
+		pool->warmerActive = pool->warmerStarted;
+		if (!pool->warmerStarted) {
+			*link = NULL;
+			free(job->pageNums);
+			free(job);
+			rc = RC_ERROR;
+		}
+	}
+	pthread_mutex_unlock(&pool->warmLock);
+	return rc;
+}
+
+// ========================================================================================================================================================================================================================================================================
+
+// Buffer Manager Interface Access Pages
+// ***** PAGE MANAGEMENT FUNCTIONS ***** //
+
+// markDirty() - marks a page as dirty
+
+/**
+ * The function `markDirty` sets the dirty bit to 1 for a page in the buffer pool if the page number matches.
+ *
+ * author : Ila Deneshwara Sai 
+ * Description:
+ * @param bm BM_BufferPool *const bm
+ * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains
+ * information about a page in the buffer pool.
+ *
+ * @return RC_OK or RC_ERROR is being returned, depending on whether the page number matches any page in the buffer pool.
+ */
+
+RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page) {
+
+    BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex != NO_FRAME) {
+		// here we are setting dirty bit as 1 if the page is in the pool
+		setFrameDirty(pool, frameIndex);
+	}
+
+    return (frameIndex != NO_FRAME) ? RC_OK : RC_ERROR;
+}
+
+/* unpinPage unpins the page. The pageNum field of page should be used to figure out which page to unpin. */
+/**
+ * author : Prudhvi Teja Kari
+ * Description:
+ * The unpinPage function decreases the fix count of a page frame in the buffer pool.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains
+ * information about a page in the buffer pool.
+ *
+ * @return RC_OK
+ */
+
+RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page) {
+
+    BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex != NO_FRAME) {
+		FramesInPage *frame = &pool->frames[frameIndex];
+
+		releasePin(frame);
+		DB_LOG_TRACE("unpinned page %d, fix count %d", page->pageNum, (int) frame->fixCountInfo);
+		DB_EVENT(DB_EVENT_UNPIN, fileOf(bm), page->pageNum);
+		tracePageEvent(pool, fileOf(bm), page->pageNum, PAGE_TRACE_UNPIN);
+	}
+
+    return RC_OK;
+}
+
+// forcePage() should write the current content of the page back to the page file on disk
+/**
+ * author : Ila Deneshwara Sai 
+ * Description:
+ * The function `forcePage` writes a page from the buffer pool to disk. The write holds the page's
+ * latch shared, like a write back of the pool, so the caller must not hold it exclusively.
+ * @param bm BM_BufferPool *const bm
+ * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains
+ * information about a page in the buffer pool.
+ *
+ * @return The function `RC forcePage` is returning `RC_OK`, or the error of the failed write.
+ */
+
+RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page) {
+
+    BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+
+	int fileId = fileOf(bm);
+	int frameIndex = page->frameIndex;
+	FramesInPage *frame = NULL;
+
+	// the handle of a pinned page leads straight to its frame, pinned and checked as in pinResidentFrameUnlocked()
+	if (frameIndex >= 0 && frameIndex < pool->frameCapacity) {
+		frame = &pool->frames[frameIndex];
+		frame->fixCountInfo++;
+
+		if (frame->generation != page->generation || frame->pageNumber != page->pageNum
+				|| frame->fileId != fileId || frame->ioInProgress) {
+			frame->fixCountInfo--;
+			frame = NULL;
+		}
+	}
+
+	if (frame == NULL) {
+		PageTableShard *shard = shardForPage(pool, fileId, page->pageNum);
+		pthread_mutex_lock(&shard->lock);
+
+		frameIndex = lookupFrame(pool, shard, fileId, page->pageNum);
+		if (frameIndex == NO_FRAME || pool->frames[frameIndex].ioInProgress) {
+			pthread_mutex_unlock(&shard->lock);
+			return RC_OK;
+		}
+
+		frame = &pool->frames[frameIndex];
+		frame->fixCountInfo++;
+		pthread_mutex_unlock(&shard->lock);
+	}
+	int wasDirty = clearFrameDirty(pool, frameIndex);
+
+	// a shared latch keeps writers from changing the page halfway through the write
+	pthread_rwlock_rdlock(&frame->latch);
+	RC rc = writeFrame(pool, frame);
+	pthread_rwlock_unlock(&frame->latch);
+
+	if (rc != RC_OK && wasDirty) {
+		setFrameDirty(pool, frameIndex);
+	}
+	releasePin(frame);
+
+    return rc;
+}
+
+/**
+ * Description:
+ * The part of pinPage() that takes locks: the page is being read by another thread, or it is
+ * not in the pool and has to be read into a free or replaced frame.
+ */
+static RC pinPageSlowPath(BufferPoolManagement *pool, int fileId, PageTableShard *shard,
+		BM_PageHandle *const page, const PageNumber pageNum) {
+	int frameIndex;
+
+	while (true) {
+		pthread_mutex_lock(&shard->lock);
+		frameIndex = pinResidentFrame(pool, shard, fileId, pageNum, 0);
+		pthread_mutex_unlock(&shard->lock);
+
+		if (frameIndex != NO_FRAME) {
+			setPageHandle(pool, page, frameIndex, pageNum);
+			return RC_OK;
+		}
+
+		frameIndex = claimFrame(pool, fileId, false);
+		if (frameIndex == NO_FRAME) {
+			return RC_PINNED_PAGES_IN_BUFFER;
+		}
+
+		bool alreadyResident;
+		RC rc = loadIntoFrame(pool, fileId, frameIndex, pageNum, true, &alreadyResident);
+		if (rc != RC_OK) {
+			return rc;
+		}
+		if (alreadyResident) {
+			continue;
+		}
+		countPin(pool, fileId, pageNum, false);
+
+		setPageHandle(pool, page, frameIndex, pageNum);
+		return RC_OK;
+	}
+}
+
+/*
+ * author : Prudhvi Teja Kari
+ * Description:
+pinPage() pins the page with page number pageNum. The buffer manager is responsible to set the
+pageNum field of the page handle passed to the method. Similarly, the data field should point to
+the page frame the page is stored in (the area in memory storing the content of the page).
+ *
+ * A hit normally takes no lock at all (see pinResidentFrameUnlocked()) and otherwise only the
+ * lock of the page's shard. On a miss a frame is claimed without any lock held, the page is
+ * entered into the page table marked as being read and the read runs outside the shard lock.
+ * Threads that ask for the same page meanwhile wait for that read.
+ * With a prefetch window set, pins of consecutive pages start read ahead of the next pages.
+ * The handle also records the frame and its generation, so markDirty(), unpinPage(), forcePage()
+ * and the latch calls on the handle find the frame without a page table lookup.
+*/
+RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (pageNum < 0) {
+		return RC_READ_NON_EXISTING_PAGE;
+	}
+
+	int fileId = fileOf(bm);
+	PageTableShard *shard = shardForPage(pool, fileId, pageNum);
+	detectSequentialAccess(bm, pool, pageNum);
+
+	int frameIndex = pinResidentFrameUnlocked(pool, fileId, pageNum, 0);
+	if (frameIndex != NO_FRAME) {
+		setPageHandle(pool, page, frameIndex, pageNum);
+		return RC_OK;
+	}
+
+	struct timespec waitStart;
+	clock_gettime(CLOCK_MONOTONIC, &waitStart);
+	RC rc = pinPageSlowPath(pool, fileId, shard, page, pageNum);
+	countEvent(pool, STAT_PIN_WAIT_NANOS, elapsedNanos(&waitStart));
+	return rc;
+}
+
+/*
+ * Description:
+ * pinPageWithPriority() pins a page like pinPage() and gives it a priority the replacement
+ * strategies respect. BM_PRIORITY_HIGH pages, e.g. index inner nodes or a table's header page,
+ * are passed over HIGH_PRIORITY_SWEEPS times when they come up for replacement.
+ * BM_PRIORITY_LOW pages are replaced before all normal pages, and BM_PRIORITY_EVICT_SOON pages
+ * before anything else. The priority stays with the page while it is in the pool: pinPage()
+ * leaves it alone, another pinPageWithPriority() replaces it, and a high priority pin also
+ * restores the spare sweeps.
+ *
+ * @return RC_OK, RC_INVALID_INPUT for an unknown priority, otherwise as pinPage().
+*/
+RC pinPageWithPriority (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_PagePriority priority) {
+	if (priority < BM_PRIORITY_HIGH || priority > BM_PRIORITY_EVICT_SOON) {
+		return RC_INVALID_INPUT;
+	}
+
+	RC rc = pinPage(bm, page, pageNum);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	// the frame can not change hands while we hold the pin
+	FramesInPage *frame = &poolOf(bm)->frames[page->frameIndex];
+	frame->priority = priority;
+	frame->spareSweeps = (priority == BM_PRIORITY_HIGH) ? HIGH_PRIORITY_SWEEPS : 0;
+	return RC_OK;
+}
+
+
+/* ***** ACCESS STRATEGIES ***** */
 
 /**
- * The `FramesInPage` struct represents a page in memory with attributes such as dirty bit, fix count,
- * data, page number, hit number, and reference number.
- * 
- * dirtyBit - The `dirtyBit` property in the `FramesInPage` struct typically represents
- * whether the page has been changed since it was last read from or written to the disk. 
- * 
- * fixCountInfo - The `fixCountInfo` property in the `FramesInPage` struct represents
- * the number of times the page has been pinned in memory. 
- * 
- * {SM_PageHandle} data - This property is used to store the actual data or contents of the page.
- * 
- * {PageNumber} pageNumber - The `pageNumber` property represents the page number of the page in memory. 
+ * Description:
+ * Creates a ring for a sequence of pins with access strategy `strategy`, see
+ * pinPageWithStrategy(). A BM_ACCESS_BULK_READ ring cycles through BULK_READ_RING_PAGES frames,
+ * or an eighth of the pool if that is less, so that a scan over a large table replaces its own
+ * pages instead of the working set of everybody else.
  *
- * hitNumber - The `hitNumber` property in the `FramesInPage` struct represents the
- * number of times a page has been accessed or "hit" in the memory. 
- * 
- * refNumber - The `refNumber` property in the `FramesInPage` struct represents the
- * reference number of the page. 
+ * @param bm BM_BufferPool *const bm
+ * @param strategy how the pages will be accessed.
+ * @param ring receives the new ring, to be freed with freeAccessRing().
+ *
+ * @return RC_OK, RC_INVALID_INPUT for an unknown strategy or RC_MEMORY_ALLOCATION_FAIL.
  */
-typedef struct PageStructure
-{
-    int dirtyBit; 
-	int fixCountInfo;
-    
-    SM_PageHandle data; 
-	PageNumber pageNumber; 
+RC createAccessRing (BM_BufferPool *const bm, BM_AccessStrategy strategy, BM_AccessRing **ring) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (ring == NULL || (strategy != BM_ACCESS_NORMAL && strategy != BM_ACCESS_BULK_READ)) {
+		return RC_INVALID_INPUT;
+	}
 
-	int hitNumber;
-	int refNumber;
-} FramesInPage;
+	BM_AccessRing *newRing = (BM_AccessRing *) malloc(sizeof(BM_AccessRing));
+	if (newRing == NULL) {
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+	newRing->pool = pool;
+	newRing->fileId = fileOf(bm);
+	newRing->strategy = strategy;
+	newRing->size = 0;
+	newRing->nextSlot = 0;
 
+	if (strategy == BM_ACCESS_BULK_READ) {
+		newRing->size = pool->numFrames / 8;
+		if (newRing->size > BULK_READ_RING_PAGES) {
+			newRing->size = BULK_READ_RING_PAGES;
+		}
+		if (newRing->size < 1) {
+			newRing->size = 1;
+		}
+	}
+	for (int slot = 0; slot < BULK_READ_RING_PAGES; slot++) {
+		newRing->frames[slot] = NO_FRAME;
+		newRing->pages[slot] = NO_PAGE;
+	}
 
-/* ==================================================== */
+	*ring = newRing;
+	return RC_OK;
+}
 
 /**
- * author : Ila Deneshwara Sai 
  * Description:
- * The FIFO function iterates through the buffer pool size to find a frame with fix count 0, writes the
- * frame to disk if it's dirty, and then replaces it with a new frame.
- * 
- * @param bm BM_BufferPool *const bm: This parameter is a pointer to a buffer pool structure.  
- * @param page: represents a structure that contains information about a page in memory.
- */
-void FIFO(BM_BufferPool *const bm, FramesInPage *page) {
-    int indexForFront = indexForRear % sizeOfBuffer;
-
-    FramesInPage * framesInPage = (FramesInPage *) bm->mgmtData;
-
-    for (int i=0;i<sizeOfBuffer;i++) {
-
-        if (framesInPage[indexForFront].fixCountInfo == 0) {
-            if (framesInPage[indexForFront].dirtyBit == 1) {
-				SM_FileHandle fHandler;
-
-                // RC openPageFile(char *fileName, SM_FileHandle *fHandle)
-                openPageFile(bm->pageFile, &fHandler);
-
-                // RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-                writeBlock(framesInPage[indexForFront].pageNumber, &fHandler, framesInPage[indexForFront].data);
-                writeCount++;
-            }    
-
-           /* The code snippet is assigning values from a `page` struct to a `framesInPage` array at a specific index `indexForFront`. 
-		   It is copying the `data`, `dirtyBit`, `fixCountInfo`, and `pageNumber` values from the `page` struct 
-		   to the corresponding fields in the `framesInPage` array at the specified index. */
-		    framesInPage[indexForFront].data = page->data;
-            framesInPage[indexForFront].dirtyBit = page->dirtyBit;
-            framesInPage[indexForFront].fixCountInfo = page->fixCountInfo;
-            framesInPage[indexForFront].pageNumber = page->pageNumber;
-            break;
-        } else {
-            indexForFront++;
-            indexForFront = (indexForFront % sizeOfBuffer == 0) ? 0 : indexForFront;
-        }
-    }
+ * Frees a ring made by createAccessRing(). The pages it read stay in the pool, first in line
+ * to be replaced.
+ */
+RC freeAccessRing (BM_AccessRing *ring) {
+	free(ring);
+	return RC_OK;
 }
 
 /**
- * 
- * author : Prudhvi Teja Kari
  * Description:
- * The LRU (Least Recently Used) function is used to implement a page replacement algorithm within a buffer pool.
- * 
- * @param bm BM_BufferPool *const bm: This parameter is a pointer to a buffer pool structure.  
- * @param page: represents a structure that contains information about a page in memory.
- */
-void LRU(BM_BufferPool *const bm, FramesInPage *page) {
-
-	SM_FileHandle fhandler;
-	int lruHitNumber = 0, lruHitIndex = 0;
-
-	FramesInPage * framesInPages = (FramesInPage * ) bm->mgmtData;
-
-	/* 
-	* Loops till present bufferSize.
-	* It checks if the `fixCountInfo` of each element is equal to 0. 
-	* If it is, it assigns the `hitNumber` of that element to `lruHitNumber` 
-	* and the index of that element to `lruHitIndex`, and then breaks out
-	* of the loop. If the `fixCountInfo` is not 0, it prints "Fix count is not 0". 
-	*/
-	for (int i=0;i<sizeOfBuffer;i++) {
-		if (framesInPages[i].fixCountInfo == 0) {
-			lruHitNumber = framesInPages[i].hitNumber;
-			lruHitIndex = i;
-			break;
-		} else {
-			printf("Fix count is not 0");
+ * Finds a frame for a page a bulk read misses on. The frame in the ring's next slot is replaced
+ * if it still holds the page the ring read into it, is clean and unpinned, and (for LRU) was not
+ * pinned by a normal pin since, which would have given it a hit stamp. Otherwise that page has
+ * become part of the working set and stays, and a frame is claimed as for pinPage().
+ *
+ * @return the claimed frame (fix count 1, not in the page table, counted for the ring's file)
+ * or NO_FRAME if all frames are pinned.
+ */
+static int claimRingFrame(BufferPoolManagement *pool, BM_AccessRing *ring) {
+	int frameIndex = ring->frames[ring->nextSlot];
+
+	if (frameIndex != NO_FRAME && frameIndex < pool->frameLimit) {
+		FramesInPage *frame = &pool->frames[frameIndex];
+
+		if (frame->fileId == ring->fileId && frame->pageNumber == ring->pages[ring->nextSlot]
+				&& frame->dirtyBit == 0 && (pool->strategy != RS_LRU || frame->hitNumber == 0)
+				&& tryEvictFrame(pool, frameIndex, ring->fileId, false)) {
+			pool->files[ring->fileId].numResident++;
+			return frameIndex;
 		}
 	}
+	return claimFrame(pool, ring->fileId, false);
+}
+
+/**
+ * Description:
+ * The locked part of pinPageWithStrategy(), like pinPageSlowPath() but misses read into a frame
+ * of the ring. The frame then takes the ring's next slot.
+ */
+static RC pinRingPageSlowPath(BufferPoolManagement *pool, BM_AccessRing *ring, PageTableShard *shard,
+		PageNumber pageNum, int *frameIndex) {
+	while (true) {
+		pthread_mutex_lock(&shard->lock);
+		*frameIndex = pinResidentFrame(pool, shard, ring->fileId, pageNum, KEEP_HIT_STAMP);
+		pthread_mutex_unlock(&shard->lock);
 
-	printf("\nThe lru hit index is : %d \n", lruHitIndex);
-	/* 
-	* The below for loop iterates from `lruHitIndex + 1` up to `sizeOfBuffer`. 
-	* It is checking if the `hitNumber` of each element is less than the current `lruHitNumber`. 
-	* If it is, then it updates the `lruHitNumber` and `lruHitIndex` with the values from that element. 
-	* This code is essentially finding the element with the lowest `hitNumber` in the array after a specific index. 
-	*/
-	for (int i = (lruHitIndex + 1);i<sizeOfBuffer;i++) {
-		if (framesInPages[i].hitNumber < lruHitNumber) {
-			lruHitNumber = framesInPages[i].hitNumber;
-			lruHitIndex = i;
+		if (*frameIndex != NO_FRAME) {
+			return RC_OK;
 		}
-	}
 
-	if(framesInPages[lruHitIndex].dirtyBit == 1) {
+		*frameIndex = claimRingFrame(pool, ring);
+		if (*frameIndex == NO_FRAME) {
+			return RC_PINNED_PAGES_IN_BUFFER;
+		}
 
-		// RC openPageFile(char *fileName, SM_FileHandle *fHandle)
-		openPageFile(bm->pageFile, &fhandler);
+		bool alreadyResident;
+		RC rc = loadIntoFrame(pool, ring->fileId, *frameIndex, pageNum, true, &alreadyResident);
+		if (rc != RC_OK) {
+			return rc;
+		}
+		if (alreadyResident) {
+			continue;
+		}
+		countPin(pool, ring->fileId, pageNum, false);
 
-		// RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-		writeBlock(framesInPages[lruHitIndex].pageNumber, &fhandler, framesInPages[lruHitIndex].data);
-		writeCount++;
+		ring->frames[ring->nextSlot] = *frameIndex;
+		ring->pages[ring->nextSlot] = pageNum;
+		ring->nextSlot = (ring->nextSlot + 1) % ring->size;
+		return RC_OK;
+	}
+}
+
+/*
+ * Description:
+ * pinPageWithStrategy() pins a page like pinPage(), as part of the sequence of pins `ring` was
+ * made for. Without a ring, or with a BM_ACCESS_NORMAL one, it is pinPage().
+ * Under BM_ACCESS_BULK_READ pages that are not in the pool are read into the frames of the ring
+ * in turn, and the pages the ring holds are kept first in the replacement order, so the pool's
+ * strategy never prefers them over pages other threads use. Pages that are already in the pool
+ * are pinned without moving them in the LRU order, so concurrent scans of the same table do not
+ * promote each other's pages either. Bulk reads start no sequential read ahead, its pages would
+ * enter the pool outside the ring.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param page handle that receives the pinned page.
+ * @param pageNum page to pin.
+ * @param ring ring from createAccessRing() for the same BM_BufferPool, or NULL.
+ *
+ * @return RC_OK, RC_INVALID_INPUT if the ring belongs to another page file or pool,
+ * RC_PINNED_PAGES_IN_BUFFER if all frames are pinned, otherwise the error of the read.
+*/
+RC pinPageWithStrategy (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_AccessRing *ring) {
+	if (ring == NULL || ring->strategy == BM_ACCESS_NORMAL) {
+		return pinPage(bm, page, pageNum);
 	}
 
-	/* 
-	* The code snippet is assigning values from a `page` struct to a `framesInPage` array at a specific index `lruHitIndex`. 
-	* It is copying the `data`, `dirtyBit`, `hitNumber`, `fixCountInfo`, and `pageNumber` values from the `page` struct 
-	* to the corresponding fields in the `framesInPage` array at the specified index. 
-	*/	
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (ring->pool != pool || ring->fileId != fileOf(bm)) {
+		return RC_INVALID_INPUT;
+	}
+	if (pageNum < 0) {
+		return RC_READ_NON_EXISTING_PAGE;
+	}
 
-	framesInPages[lruHitIndex].pageNumber = page->pageNumber;
-	framesInPages[lruHitIndex].dirtyBit = page->dirtyBit;
-	framesInPages[lruHitIndex].data = page->data;
+	RC rc = RC_OK;
+	int frameIndex = pinResidentFrameUnlocked(pool, ring->fileId, pageNum, KEEP_HIT_STAMP);
 
-	framesInPages[lruHitIndex].hitNumber = page->hitNumber;
-	framesInPages[lruHitIndex].fixCountInfo = page->fixCountInfo;
-}
+	if (frameIndex == NO_FRAME) {
+		struct timespec waitStart;
+		clock_gettime(CLOCK_MONOTONIC, &waitStart);
+		rc = pinRingPageSlowPath(pool, ring, shardForPage(pool, ring->fileId, pageNum), pageNum, &frameIndex);
+		countEvent(pool, STAT_PIN_WAIT_NANOS, elapsedNanos(&waitStart));
+		if (rc != RC_OK) {
+			return rc;
+		}
+	}
 
-/* ==================================================== */
+	// a page of the ring stays in front, also when the scan pins it again
+	for (int slot = 0; slot < ring->size; slot++) {
+		if (ring->frames[slot] == frameIndex && ring->pages[slot] == pageNum) {
+			pool->frames[frameIndex].loadNumber = 0;
+			pool->frames[frameIndex].hitNumber = 0;
+			break;
+		}
+	}
+
+	setPageHandle(pool, page, frameIndex, pageNum);
+	return RC_OK;
+}
 
+// a page of a pinPages() batch that still has to be pinned, and its index in the batch
+typedef struct BatchEntry {
+	PageNumber pageNum;
+	int index;
+} BatchEntry;
 
-/* Buffer Manager Interface Pool Handling */
+static int compareBatchEntries(const void *first, const void *second) {
+	const BatchEntry *a = first, *b = second;
+	return (a->pageNum > b->pageNum) - (a->pageNum < b->pageNum);
+}
 
-/* 
- * author : Ila Deneshwara Sai 
+/*
  * Description:
- * initBufferPool() - creates a new buffer pool with numPages page frames using the page replacement
-strategy strategy. The pool is used to cache pages from the page file with name pageFileName.
-Initially, all page frames should be empty. The page file should already exist, i.e., this method
-should not generate a new page file. stratData can be used to pass parameters for the page
-replacement strategy. For example, for LRU-k this could be the parameter k.
+ * pinPages() pins the pages `pageNums[0..n-1]` into `pages[0..n-1]`, like n calls of pinPage().
+ * All pages that are already in the pool are pinned first and share one LRU stamp. The
+ * remaining pages are then read together in ascending page order as one batch. A page may
+ * appear more than once, it is then pinned once per occurrence.
+ * Either all pages are pinned or, on an error, none of them is.
+ *
+ * @param bm BM_BufferPool *const bm
+ * @param pages handles that receive the pinned pages.
+ * @param pageNums pages to pin.
+ * @param n number of pages.
+ *
+ * @return RC_OK, RC_PINNED_PAGES_IN_BUFFER if there are not enough unpinned frames for the
+ * batch, otherwise the error of a failed read.
 */
+RC pinPages (BM_BufferPool *const bm, BM_PageHandle *const pages, const PageNumber *pageNums, int n) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (n < 0 || (n > 0 && (pages == NULL || pageNums == NULL))) {
+		return RC_INVALID_INPUT;
+	}
+	for (int i = 0; i < n; i++) {
+		if (pageNums[i] < 0) {
+			return RC_READ_NON_EXISTING_PAGE;
+		}
+		pages[i].pageNum = NO_PAGE;
+		pages[i].data = NULL;
+		pages[i].frameIndex = NO_FRAME;
+	}
 
-RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData) {
-    sizeOfBuffer = numPages;
+	int fileId = fileOf(bm);
+	// the hits of a batch share the newest stamp rather than each taking one of their own
+	int hitStamp = pool->strategy == RS_LRU ? pool->hitCount : 0;
+	BatchEntry misses[n];
+	int numMisses = 0;
 
-    bm->pageFile = (char *) (pageFileName);
-    bm->strategy = strategy;
-    bm->numPages = numPages;
-    bm->mgmtData = NULL;
+	for (int i = 0; i < n; i++) {
+		int frameIndex = pinResidentFrameUnlocked(pool, fileId, pageNums[i], hitStamp);
+		if (frameIndex != NO_FRAME) {
+			setPageHandle(pool, &pages[i], frameIndex, pageNums[i]);
+		} else {
+			misses[numMisses].pageNum = pageNums[i];
+			misses[numMisses].index = i;
+			numMisses++;
+		}
+	}
+	qsort(misses, numMisses, sizeof(BatchEntry), compareBatchEntries);
 
-    FramesInPage *framesInPage = malloc (sizeof(FramesInPage) * numPages);
+	struct timespec waitStart;
+	clock_gettime(CLOCK_MONOTONIC, &waitStart);
 
-/* 
-	* The above code is initializing an array of structures named `framesInPage`. 
- 	* The fields being initialized include `data`, `dirtyBit`, `fixCountInfo`, `hitNumber`, `refNumber`, and `pageNumber`. 
-*/
-    for (int i=0;i<sizeOfBuffer;i++) {
-        framesInPage[i].data = NULL;
-        framesInPage[i].dirtyBit = 0;
-        framesInPage[i].fixCountInfo = 0;
-        framesInPage[i].hitNumber = 0;
-        framesInPage[i].refNumber = 0;
-        framesInPage[i].pageNumber = -1;
-    }
+	BatchEntry loads[n];
+	int loadFrames[n];
+	PageNumber loadPages[n];
+	bool alreadyResident[n];
+	RC results[n];
+	RC rc = RC_OK;
 
-    bm->mgmtData = framesInPage;
-    lfuPointerCount = 0;
-    writeCount = 0;
-    clockPointerCount = 0;
+	while (numMisses > 0 && rc == RC_OK) {
+		int numLoads = 0;
+		int numRetries = 0;
 
-    return RC_OK;
-}   
+		for (int m = 0; m < numMisses; m++) {
+			int i = misses[m].index;
 
-/* 
+			// a page asked for twice is pinned again once the first copy is read
+			if (numLoads > 0 && loadPages[numLoads - 1] == pageNums[i]) {
+				misses[numRetries++] = misses[m];
+				continue;
+			}
 
- * shutdownBufferPool() - destroys a buffer pool. This method should free up all resources associated
-	with buffer pool. For example, it should free the memory allocated for page frames. If the buffer
-	pool contains any dirty pages, then these pages should be written back to disk before destroying
-	the pool. It is an error to shutdown a buffer pool that has pinned pages.
-*/
+			PageTableShard *shard = shardForPage(pool, fileId, pageNums[i]);
+			pthread_mutex_lock(&shard->lock);
+			int frameIndex = pinResidentFrame(pool, shard, fileId, pageNums[i], hitStamp);
+			pthread_mutex_unlock(&shard->lock);
 
-/**
- * author : Prudhvi Teja Kari
- * Description:
- * The function `shutdownBufferPool` closes the buffer pool and checks for pinned pages before locking
- * memory and setting the management data to NULL.
- * 
- * @param bm BM_BufferPool structure containing information about the buffer pool and its management data.
- * 
- * @return RC_OK
- */
+			if (frameIndex != NO_FRAME) {
+				setPageHandle(pool, &pages[i], frameIndex, pageNums[i]);
+				continue;
+			}
 
-RC shutdownBufferPool(BM_BufferPool *const bm) {
+			frameIndex = claimFrame(pool, fileId, false);
+			if (frameIndex == NO_FRAME) {
+				rc = RC_PINNED_PAGES_IN_BUFFER;
+				break;
+			}
+			loads[numLoads] = misses[m];
+			loadFrames[numLoads] = frameIndex;
+			loadPages[numLoads] = pageNums[i];
+			numLoads++;
+		}
 
-    FramesInPage *framesInPage = (FramesInPage *)bm->mgmtData;
+		if (rc != RC_OK) {
+			for (int l = 0; l < numLoads; l++) {
+				unclaimFrame(pool, fileId, loadFrames[l]);
+			}
+			break;
+		}
 
-	forceFlushPool(bm);
-    
-    for (int i=0;i<sizeOfBuffer;i++) {
-        
-        printf("frames Page fixCount : %d\n", framesInPage[i].fixCountInfo);
+		loadIntoFrames(pool, fileId, loadFrames, loadPages, numLoads, true, alreadyResident, results);
 
-        if(framesInPage[i].fixCountInfo != 0) {
-            return RC_PINNED_PAGES_IN_BUFFER;
-        } else {
+		for (int l = 0; l < numLoads; l++) {
+			int i = loads[l].index;
+			if (results[l] != RC_OK) {
+				rc = results[l];
+			} else if (alreadyResident[l]) {
+				misses[numRetries++] = loads[l];
+			} else {
+				setPageHandle(pool, &pages[i], loadFrames[l], pageNums[i]);
+				countPin(pool, fileId, pageNums[i], false);
+			}
+		}
+		numMisses = numRetries;
+	}
+	countEvent(pool, STAT_PIN_WAIT_NANOS, elapsedNanos(&waitStart));
 
-        }
-    }
-    free(framesInPage);
-    bm->mgmtData = NULL;
-    return RC_OK;
+	if (rc != RC_OK) {
+		unpinPages(bm, pages, n);
+	}
+	return rc;
 }
 
 /*
-forceFlushPool() - causes all dirty pages (with fix count 0) from the buffer pool to be written to
-disk.
-*/
-
-/**
- * author : Ila Deneshwara Sai 
  * Description:
- * The function `forceFlushPool` iterates through the buffer pool frames, writing dirty pages back to disk if their fix count is zero.
- * 
+ * unpinPages() unpins the pages of `pages[0..n-1]`, like n calls of unpinPage(). Handles that
+ * do not hold a page (pageNum NO_PAGE) are skipped.
+ *
  * @param bm BM_BufferPool *const bm
- * 
- * @return The function `RC forceFlushPool(BM_BufferPool *const bm)` is returning an `RC` (Return Code) value, specifically `RC_OK`.
- */
-RC forceFlushPool(BM_BufferPool *const bm) {
-
-    FramesInPage* framesInPage = (FramesInPage *) bm->mgmtData;
-
-    for (int i=0;i<sizeOfBuffer;i++) {
-
-        printf("FixCount Info : %d | Dirty Count Bit : %d\n", framesInPage[i].fixCountInfo, framesInPage[i].dirtyBit);
-        if ((framesInPage[i].fixCountInfo == 0) 
-                && (framesInPage[i].dirtyBit == 1)) {
-            
-            printf("When condition true\n");
-            SM_FileHandle fileHandler;
-            printf("PageFile : %s\n",bm->pageFile);
-            
-            /* RC openPageFile(char *fileName, SM_FileHandle *fHandle) */
-            openPageFile(bm->pageFile, &fileHandler);
-
-            /* RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage) */
-            writeBlock(framesInPage[i].pageNumber, &fileHandler, framesInPage[i].data);
-            writeCount++;
+ * @param pages handles of pinned pages.
+ * @param n number of handles.
+ *
+ * @return RC_OK
+*/
+RC unpinPages (BM_BufferPool *const bm, BM_PageHandle *const pages, int n) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (n < 0 || (n > 0 && pages == NULL)) {
+		return RC_INVALID_INPUT;
+	}
 
-            framesInPage[i].dirtyBit = 0;
-        }
-    }
-    return RC_OK;
+	for (int i = 0; i < n; i++) {
+		if (pages[i].pageNum == NO_PAGE) {
+			continue;
+		}
+		int frameIndex = frameOfHandle(pool, fileOf(bm), &pages[i]);
+		if (frameIndex != NO_FRAME) {
+			releasePin(&pool->frames[frameIndex]);
+			tracePageEvent(pool, fileOf(bm), pages[i].pageNum, PAGE_TRACE_UNPIN);
+		}
+	}
+	return RC_OK;
 }
 
-// ========================================================================================================================================================================================================================================================================
-
-// Buffer Manager Interface Access Pages
-// ***** PAGE MANAGEMENT FUNCTIONS ***** //
-
-// markDirty() - marks a page as dirty
+// ***** PAGE LATCHES ***** //
 
-/**
- * The function `markDirty` sets the dirty bit to 1 for a page in the buffer pool if the page number matches.
- * 
- * author : Ila Deneshwara Sai 
+/*
  * Description:
+ * latchPage() latches the content of a pinned page. A pin only keeps the page in its frame,
+ * the latch is what keeps concurrent readers and writers of the page content apart:
+ * BM_LATCH_SHARED admits any number of readers, BM_LATCH_EXCLUSIVE one writer and nobody else.
+ * Every exclusive latch advances the frame's version so optimistic readers notice the change.
+ *
  * @param bm BM_BufferPool *const bm
- * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains 
- * information about a page in the buffer pool. 
- * 
- * @return RC_OK or RC_ERROR is being returned, depending on whether the page number matches any page in the buffer pool.
- */
+ * @param page handle of a page the caller has pinned.
+ * @param mode BM_LATCH_SHARED or BM_LATCH_EXCLUSIVE.
+ *
+ * @return RC_OK, RC_ERROR if the page is not in the pool.
+*/
+RC latchPage (BM_BufferPool *const bm, BM_PageHandle *const page, BM_LatchMode mode) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
 
-RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page) {
-    
-    FramesInPage* framesInPage = (FramesInPage *) bm->mgmtData;
-
-    for (int i = 0;i<sizeOfBuffer;i++) {
-        if(page->pageNum == framesInPage[i].pageNumber) {
-            // here we are setting dirty bit as 1 if the above condition is true
-            framesInPage[i].dirtyBit = 1;
-            return RC_OK;
-        }
-    }
-    return RC_ERROR;
-}
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex == NO_FRAME) {
+		return RC_ERROR;
+	}
 
-/* unpinPage unpins the page. The pageNum field of page should be used to figure out which page to unpin. */
-/** 
- * author : Prudhvi Teja Kari
- * Description:
- * The unpinPage function decreases the fix count of a page frame in the buffer pool.
- * 
- * @param bm BM_BufferPool *const bm
- * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains 
- * information about a page in the buffer pool. 
- * 
- * @return RC_OK
- */
+	FramesInPage *frame = &pool->frames[frameIndex];
+	switch (mode) {
+		case BM_LATCH_SHARED:
+			pthread_rwlock_rdlock(&frame->latch);
+			break;
 
-RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page) {
+		case BM_LATCH_EXCLUSIVE:
+			pthread_rwlock_wrlock(&frame->latch);
+			frame->version++;
+			break;
 
-    FramesInPage* framesInPage = (FramesInPage *) bm->mgmtData;
-	printf("\n");
-    for (int i = 0;i<sizeOfBuffer;i++) {
-        if(page->pageNum == framesInPage[i].pageNumber) {
-            printf("Before - Page frame - fix : %d\n", framesInPage[i].fixCountInfo);
-			framesInPage[i].fixCountInfo--;
-			printf("After  - Page frame - fix : %d\n", framesInPage[i].fixCountInfo);
-            break;
-        }
-    }
-    return RC_OK;
+		default:
+			return RC_INVALID_INPUT;
+	}
+	return RC_OK;
 }
 
-// forcePage() should write the current content of the page back to the page file on disk
-/**
- * author : Ila Deneshwara Sai 
+/*
  * Description:
- * The function `forcePage` writes a page from the buffer pool to disk if it is dirty.
- * @param bm BM_BufferPool *const bm
- * @param page The `page` parameter is a pointer to a structure `BM_PageHandle` which contains 
- * information about a page in the buffer pool. 
- * 
- * @return The function `RC forcePage` is returning `RC_OK`.
- */
+ * unlatchPage() releases a latch taken with latchPage() in the same mode.
+*/
+RC unlatchPage (BM_BufferPool *const bm, BM_PageHandle *const page, BM_LatchMode mode) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
 
-RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page) {
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex == NO_FRAME) {
+		return RC_ERROR;
+	}
 
-    FramesInPage* framesInPage = (FramesInPage *) bm->mgmtData;
+	FramesInPage *frame = &pool->frames[frameIndex];
+	if (mode == BM_LATCH_EXCLUSIVE) {
+		frame->version++;
+	}
+	pthread_rwlock_unlock(&frame->latch);
+	return RC_OK;
+}
 
-    for (int i = 0;i<sizeOfBuffer;i++) {
-        if(framesInPage[i].pageNumber == page->pageNum) {
-            SM_FileHandle fHandle;
+/*
+ * Description:
+ * startOptimisticRead() starts reading a pinned page without latching it. It waits until no
+ * writer holds the page and returns the version the read has to be validated against with
+ * validateOptimisticRead(). Values read in between must not be trusted (or followed as
+ * pointers) before the validation succeeded; on failure the reader simply starts over.
+ *
+ * @return the page version, 0 if the page is not in the pool (such a read never validates).
+*/
+unsigned long startOptimisticRead (BM_BufferPool *const bm, BM_PageHandle *const page) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return 0;
+	}
 
-            // RC openPageFile(char *fileName, SM_FileHandle *fHandle)
-            openPageFile(bm->pageFile, &fHandle);
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex == NO_FRAME) {
+		return 0;
+	}
 
-            // RC writeBlock(int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-            writeBlock(framesInPage[i].pageNumber, &fHandle, framesInPage[i].data);
-            writeCount++;
+	FramesInPage *frame = &pool->frames[frameIndex];
+	unsigned long version = frame->version;
 
-            framesInPage[i].dirtyBit = 0;
-        }
-    }
-    return RC_OK;
+	while (version & 1) {
+		sched_yield();
+		version = frame->version;
+	}
+	return version;
 }
 
 /*
- * author : Prudhvi Teja Kari
  * Description:
-pinPage() pins the page with page number pageNum. The buffer manager is responsible to set the
-pageNum field of the page handle passed to the method. Similarly, the data field should point to
-the page frame the page is stored in (the area in memory storing the content of the page).
-*/ 
-RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum) {
-	FramesInPage *framesInPage = (FramesInPage *)bm->mgmtData;
-	
-	printf("Here in PIN_PAGE");
-	if(framesInPage[0].pageNumber == -1){
-		SM_FileHandle fHandle;
-		framesInPage[0].data = (SM_PageHandle) malloc(PAGE_SIZE);
-
-		// RC openPageFile (char *fileName, SM_FileHandle *fHandle) 
-        openPageFile(bm->pageFile, &fHandle);
-
-		// RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle)
-        ensureCapacity(pageNum, &fHandle);
-		
-        // RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-        readBlock(pageNum, &fHandle, framesInPage[0].data);
-		
-        framesInPage[0].pageNumber = pageNum;
-		framesInPage[0].fixCountInfo++;
-		
-        indexForRear = hitCount = 0;
-
-		framesInPage[0].refNumber = 0;
-		framesInPage[0].hitNumber = hitCount;	
-		
-		page->data = framesInPage[0].data;
-        page->pageNum = pageNum;
-		
-		return RC_OK;		
-	} else {	
-		bool isBufferPoolFull = true;
-		
-		for(int i = 0; i < sizeOfBuffer; i++) {
-			if(framesInPage[i].pageNumber != -1) {	
-				if(framesInPage[i].pageNumber == pageNum) {
-					
-                    framesInPage[i].fixCountInfo++;
-					isBufferPoolFull = false;
-					hitCount++; 
-                    
-					if(bm->strategy == RS_LRU){
-						framesInPage[i].hitNumber = hitCount;
-                    } 
-					
-					page->pageNum = pageNum;
-					page->data = framesInPage[i].data;
-
-					clockPointerCount++;
-					break;
-				}				
-			} else {
-				SM_FileHandle fh;
-                framesInPage[i].data = (SM_PageHandle) malloc(PAGE_SIZE);
-
-                // RC openPageFile (char *fileName, SM_FileHandle *fHandle) 
-				openPageFile(bm->pageFile, &fh);
-								        
-                // RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-                readBlock(pageNum, &fh, framesInPage[i].data);
-				
-				framesInPage[i].fixCountInfo = 1;
-                framesInPage[i].pageNumber = pageNum;
-				framesInPage[i].refNumber = 0;
-				
-                indexForRear++;	
-				hitCount++;
-
-				if(bm->strategy == RS_LRU) {
- 					framesInPage[i].hitNumber = hitCount;
-                }
-						
-				page->pageNum = pageNum;
-				page->data = framesInPage[i].data;
-				
-				isBufferPoolFull = false;
-				break;
-			}
-		}
-		
-		if(isBufferPoolFull == true) {
-			FramesInPage *newFramePage = (FramesInPage *) malloc(sizeof(FramesInPage));		
-			
-			SM_FileHandle fh;
-			newFramePage->data = (SM_PageHandle) malloc(PAGE_SIZE);
-
-            // RC openPageFile (char *fileName, SM_FileHandle *fHandle) 
-			openPageFile(bm->pageFile, &fh);
-            
-            // RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-			readBlock(pageNum, &fh, newFramePage->data);
-		
-			newFramePage->dirtyBit = 0;		
-			newFramePage->fixCountInfo = 1;
-			newFramePage->refNumber = 0;
-            newFramePage->pageNumber = pageNum;
-			
-            indexForRear++;
-			hitCount++;
-
-			if(bm->strategy == RS_LRU) {
-				newFramePage->hitNumber = hitCount;				
-            }
-
-			page->pageNum = pageNum;
-			page->data = newFramePage->data;			
-
-			switch(bm->strategy) {					
-				case RS_LRU: 
-					LRU(bm, newFramePage);
-					break;
-
-                case RS_LFU: 
-					printf("RS_LFU : This Algorithm is not inplemented");
-					break;
-				
-				case RS_CLOCK: 
-					printf("RS_CLOCK : This Algorithm is not inplemented");
-					break;
-
-                case RS_FIFO: 
-					FIFO(bm, newFramePage);
-					break;
-
-                case RS_LRU_K:
-					printf("\n LRU-k algorithm not implemented");
-					break;
-  				
-				default:
-					printf("The selected option/ algorithm is not present.");
-					break;
-			}		
-		}		
-		return RC_OK;
-	}	
+ * validateOptimisticRead() tells whether the page is unchanged since startOptimisticRead()
+ * returned `version`, i.e. whether everything read in between is consistent.
+*/
+bool validateOptimisticRead (BM_BufferPool *const bm, BM_PageHandle *const page, unsigned long version) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL || (version & 1)) {
+		return false;
+	}
+
+	int frameIndex = frameOfHandle(pool, fileOf(bm), page);
+	if (frameIndex == NO_FRAME) {
+		return false;
+	}
+
+	atomic_thread_fence(memory_order_acquire);
+	return pool->frames[frameIndex].version == version;
 }
 
 // ******************** STATISTICS FUNCTIONS ******************** //
 
-/* 
+/*
  * author : Prudhvi Teja Kari
  * Description:
- * The getFrameContents() returns an array of PageNumbers (of size numPages) where the ith element is the 
+ * The getFrameContents() returns an array of PageNumbers (of size numPages) where the ith element is the
  * number of the page stored in the ith page frame. An empty page frame is represented using the constant NO PAGE.
 */
 PageNumber *getFrameContents (BM_BufferPool *const bm) {
-	FramesInPage *framesInPage = (FramesInPage *) bm->mgmtData;
-	PageNumber *frameInfo = malloc(sizeof (PageNumber) * sizeOfBuffer);
-	
-    for (int i=0;i<sizeOfBuffer;i++) {
-		frameInfo[i] = (framesInPage[i].pageNumber != -1) ? framesInPage[i].pageNumber : NO_PAGE;
-	}
+	PageNumber *frameInfo = malloc(sizeof (PageNumber) * bm->numPages);
+
+	getFrameInfo(bm, frameInfo, NULL, NULL);
 	return frameInfo;
 }
 
 /*
  * author : Ila Deneshwara Sai 
  * Description:
- * The getDirtyFlags() returns an array of bools (of size numPages) 
+ * The getDirtyFlags() returns an array of bools (of size numPages)
  * where the ith element is TRUE if the page stored in the i
  * th page frame is dirty. Empty page frames are considered as clean.
 */
 bool *getDirtyFlags (BM_BufferPool *const bm) {
-	bool *dirtyBoolFlag = malloc(sizeof(bool) * sizeOfBuffer);
-	FramesInPage *frameInPage = (FramesInPage *)bm->mgmtData;
-	
-	for(int i = 0; i < sizeOfBuffer; i++) {
-		dirtyBoolFlag[i] = (frameInPage[i].dirtyBit == 1) ? true : false ;
-	}	
+	bool *dirtyBoolFlag = malloc(sizeof(bool) * bm->numPages);
+
+	getFrameInfo(bm, NULL, dirtyBoolFlag, NULL);
 	return dirtyBoolFlag;
 }
 
@@ -569,28 +4811,95 @@ bool *getDirtyFlags (BM_BufferPool *const bm) {
  * author : Prudhvi Teja Kari
  * Description:
     The getFixCounts() returns an array of ints (of size numPages) where the i
-    th element is the fix count of the page stored in the ith page frame. 
+    th element is the fix count of the page stored in the ith page frame.
     Return 0 for empty page frames.
 */
 int * getFixCounts (BM_BufferPool *const bm) {
-	int *countFixList = malloc(sizeof(int) * sizeOfBuffer);
-	FramesInPage *pageFrame= (FramesInPage *)bm->mgmtData;
-	
-    for(int i=0;i<sizeOfBuffer;i++) {
-		countFixList[i] = (pageFrame[i].fixCountInfo != -1) ? pageFrame[i].fixCountInfo : 0;
-	}	
+	int *countFixList = malloc(sizeof(int) * bm->numPages);
+
+	getFrameInfo(bm, NULL, NULL, countFixList);
 	return countFixList;
 }
 
-/* 
+/*
+ * Description:
+ * getFrameInfo() fills caller owned arrays (of size numPages) with the same information as
+ * getFrameContents(), getDirtyFlags() and getFixCounts(), without allocating anything.
+ * Arrays that are not needed can be passed as NULL. On a shared pool, frames holding pages of
+ * other files are shown as empty. The arrays have `bm->numPages` entries, frames the pool no
+ * longer has since another view resized it are shown as empty too.
+*/
+RC getFrameInfo (BM_BufferPool *const bm, PageNumber *frameContents, bool *dirtyFlags, int *fixCounts) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	int fileId = fileOf(bm);
+
+	for (int i = 0; i < bm->numPages; i++) {
+		FramesInPage *frame = &pool->frames[i];
+		PageNumber pageNum = frame->pageNumber;
+
+		if (i >= pool->numFrames || frame->fileId != fileId) {
+			pageNum = NO_PAGE;
+		}
+		if (frameContents != NULL) {
+			frameContents[i] = pageNum;
+		}
+		if (dirtyFlags != NULL) {
+			dirtyFlags[i] = (pageNum != NO_PAGE && frame->dirtyBit == 1) ? true : false;
+		}
+		if (fixCounts != NULL) {
+			fixCounts[i] = (pageNum != NO_PAGE) ? frame->fixCountInfo : 0;
+		}
+	}
+	return RC_OK;
+}
+
+/*
+ * Description:
+ * getPoolStats() fills `stats` with the counters of the pool since it was initialized, for a
+ * shared pool those of all its files. The counters are read one after another while the pool may be in use, so they are not an
+ * atomic snapshot of each other, but each of them is exact.
+*/
+RC getPoolStats (BM_BufferPool *const bm, BM_PoolStats *stats) {
+	BufferPoolManagement *pool = poolOf(bm);
+	if (pool == NULL) {
+		return RC_BUFFER_POOL_NOT_INIT;
+	}
+	if (stats == NULL) {
+		return RC_INVALID_INPUT;
+	}
+
+	stats->hits = sumCounter(pool, STAT_HITS);
+	stats->misses = sumCounter(pool, STAT_MISSES);
+	stats->reads = sumCounter(pool, STAT_READS);
+	stats->writes = sumCounter(pool, STAT_WRITES);
+	stats->evictions = sumCounter(pool, STAT_EVICTIONS);
+	stats->dirtyEvictions = sumCounter(pool, STAT_DIRTY_EVICTIONS);
+	stats->pinWaitNanos = sumCounter(pool, STAT_PIN_WAIT_NANOS);
+	stats->victimSearches = sumCounter(pool, STAT_VICTIM_SEARCHES);
+	stats->victimRetries = sumCounter(pool, STAT_VICTIM_RETRIES);
+	stats->prefetchReads = sumCounter(pool, STAT_PREFETCH_READS);
+	stats->cleanerWrites = sumCounter(pool, STAT_CLEANER_WRITES);
+	stats->compressedStores = sumCounter(pool, STAT_COMPRESSED_STORES);
+	stats->compressedHits = sumCounter(pool, STAT_COMPRESSED_HITS);
+	stats->victimCacheWrites = sumCounter(pool, STAT_VICTIM_CACHE_WRITES);
+	stats->victimCacheHits = sumCounter(pool, STAT_VICTIM_CACHE_HITS);
+	return RC_OK;
+}
+
+/*
  * author : Ila Deneshwara Sai 
  * Description:
 The getNumReadIO() returns the number of pages that have been read from disk since a
 buffer pool has been initialized. You code is responsible to initializing this statistic at pool creating
 time and update whenever a page is read from the page file into a page frame.
+For a shared pool this counts the reads of all its files.
 */
 int getNumReadIO (BM_BufferPool *const bm) {
-	return (indexForRear + 1);
+	BufferPoolManagement *pool = poolOf(bm);
+	return (int) sumCounter(pool, STAT_READS);
 }
 
 /*
@@ -600,5 +4909,6 @@ getNumWriteIO() returns the number of pages written to the page file since the b
 initialized.
 */
 int getNumWriteIO (BM_BufferPool *const bm) {
-	return writeCount;
-}
\ No newline at end of file
+	BufferPoolManagement *pool = poolOf(bm);
+	return (int) sumCounter(pool, STAT_WRITES);
+}
@@ -16,6 +16,26 @@ typedef enum ReplacementStrategy {
   RS_LRU_K = 4
 } ReplacementStrategy;
 
+// Page latch modes
+typedef enum BM_LatchMode {
+  BM_LATCH_SHARED = 0,
+  BM_LATCH_EXCLUSIVE = 1
+} BM_LatchMode;
+
+// Access strategies of a sequence of pins, see createAccessRing
+typedef enum BM_AccessStrategy {
+  BM_ACCESS_NORMAL = 0,
+  BM_ACCESS_BULK_READ = 1 // large scans, pages cycle through a small ring of frames
+} BM_AccessStrategy;
+
+// Priority hints for pinPageWithPriority, respected by the replacement strategies
+typedef enum BM_PagePriority {
+  BM_PRIORITY_HIGH = 0,      // e.g. index inner nodes, kept for a few extra replacement rounds
+  BM_PRIORITY_NORMAL = 1,
+  BM_PRIORITY_LOW = 2,       // replaced before normal pages
+  BM_PRIORITY_EVICT_SOON = 3 // replaced before anything else
+} BM_PagePriority;
+
 // Data Types and Structures
 typedef int PageNumber;
 #define NO_PAGE -1
@@ -31,8 +51,50 @@ typedef struct BM_BufferPool {
 typedef struct BM_PageHandle {
   PageNumber pageNum;
   char *data;
+  int frameIndex;          // frame the page was pinned in, set by pinPage
+  unsigned int generation; // generation of that frame, tells whether it still holds the page
 } BM_PageHandle;
 
+// Options of a buffer pool, see initBufferPoolWithOptions
+typedef struct BM_PoolOptions {
+  bool hugePages; // back the frame arena with huge pages if the system has them
+  int prefetchWindow; // pages read ahead of sequential pinPage calls, 0 turns read ahead off
+  int maxPages; // most frames resizeBufferPool can grow the pool to, 0 for a default multiple of numPages
+  long compressedCacheBytes; // memory for compressed copies of replaced clean pages, 0 turns the tier off
+  const char *victimCacheFile; // local file replaced clean pages are also kept in, e.g. on an SSD, NULL for none
+  int victimCachePages; // pages the victim cache file holds
+  const char *manifestFile; // initBufferPoolWithOptions warms the pool from it, shutdownBufferPool dumps to it, NULL for neither
+} BM_PoolOptions;
+
+#define DEFAULT_POOL_OPTIONS ((BM_PoolOptions) { .hugePages = false, .prefetchWindow = 0, .maxPages = 0, \
+                                                 .compressedCacheBytes = 0, .victimCacheFile = NULL, \
+                                                 .victimCachePages = 0, .manifestFile = NULL })
+
+// A buffer pool several page files can be opened on, see initSharedPool
+typedef struct BufferPoolManagement BM_SharedPool;
+
+// The frames a bulk access cycles through, see createAccessRing
+typedef struct BM_AccessRing BM_AccessRing;
+
+// Counters of a buffer pool since it was initialized, see getPoolStats
+typedef struct BM_PoolStats {
+  long hits;           // pins of pages that were already in the pool
+  long misses;         // pins that had to read their page
+  long reads;          // pages read from the page file
+  long writes;         // pages written to the page file
+  long evictions;      // pages replaced to make room for another page
+  long dirtyEvictions; // replaced pages that had to be written back first
+  long pinWaitNanos;   // time pins spent waiting for reads and free frames
+  long victimSearches; // times the replacement strategy was asked for a victim
+  long victimRetries;  // victims lost to another thread, so the strategy was asked again
+  long prefetchReads;  // pages read by prefetchPages and sequential read ahead
+  long cleanerWrites;  // pages written by the page cleaner
+  long compressedStores; // replaced pages kept in the compressed tier
+  long compressedHits;   // misses served from the compressed tier instead of the page file
+  long victimCacheWrites; // replaced pages written to the victim cache file
+  long victimCacheHits;   // misses served from the victim cache instead of the page file
+} BM_PoolStats;
+
 // convenience macros
 #define MAKE_POOL()					\
   ((BM_BufferPool *) malloc (sizeof(BM_BufferPool)))
@@ -44,8 +106,26 @@ typedef struct BM_PageHandle {
 RC initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, 
 		  const int numPages, ReplacementStrategy strategy, 
 		  void *stratData);
+RC initBufferPoolWithOptions(BM_BufferPool *const bm, const char *const pageFileName,
+		  const int numPages, ReplacementStrategy strategy,
+		  void *stratData, const BM_PoolOptions *options);
 RC shutdownBufferPool(BM_BufferPool *const bm);
 RC forceFlushPool(BM_BufferPool *const bm);
+RC initSharedPool(BM_SharedPool **pool, const int numPages, ReplacementStrategy strategy,
+		  const BM_PoolOptions *options);
+RC shutdownSharedPool(BM_SharedPool *pool);
+RC getGlobalSharedPool(BM_SharedPool **pool);
+RC openSharedBufferPool(BM_BufferPool *const bm, BM_SharedPool *pool,
+		  const char *const pageFileName, int quota);
+RC startPageCleaner(BM_BufferPool *const bm, double cleanFraction);
+RC stopPageCleaner(BM_BufferPool *const bm);
+RC resizeBufferPool(BM_BufferPool *const bm, const int newNumPages);
+RC startMemoryPressureWatch(BM_BufferPool *const bm, const int minNumPages);
+RC stopMemoryPressureWatch(BM_BufferPool *const bm);
+RC startPageTrace(BM_BufferPool *const bm, const char *const traceFile, const int maxEvents);
+RC stopPageTrace(BM_BufferPool *const bm);
+RC dumpPoolManifest(BM_BufferPool *const bm, const char *const manifestFile);
+RC warmBufferPool(BM_BufferPool *const bm, const char *const manifestFile);
 
 // Buffer Manager Interface Access Pages
 RC markDirty (BM_BufferPool *const bm, BM_PageHandle *const page);
@@ -53,6 +133,22 @@ RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page);
 RC pinPage (BM_BufferPool *const bm, BM_PageHandle *const page, 
 	    const PageNumber pageNum);
+RC pinPages (BM_BufferPool *const bm, BM_PageHandle *const pages,
+	    const PageNumber *pageNums, int n);
+RC unpinPages (BM_BufferPool *const bm, BM_PageHandle *const pages, int n);
+RC prefetchPages (BM_BufferPool *const bm, const PageNumber *pageNums, int n);
+RC createAccessRing (BM_BufferPool *const bm, BM_AccessStrategy strategy, BM_AccessRing **ring);
+RC freeAccessRing (BM_AccessRing *ring);
+RC pinPageWithStrategy (BM_BufferPool *const bm, BM_PageHandle *const page,
+	    const PageNumber pageNum, BM_AccessRing *ring);
+RC pinPageWithPriority (BM_BufferPool *const bm, BM_PageHandle *const page,
+	    const PageNumber pageNum, BM_PagePriority priority);
+
+// Buffer Manager Interface Page Latches
+RC latchPage (BM_BufferPool *const bm, BM_PageHandle *const page, BM_LatchMode mode);
+RC unlatchPage (BM_BufferPool *const bm, BM_PageHandle *const page, BM_LatchMode mode);
+unsigned long startOptimisticRead (BM_BufferPool *const bm, BM_PageHandle *const page);
+bool validateOptimisticRead (BM_BufferPool *const bm, BM_PageHandle *const page, unsigned long version);
 
 // Statistics Interface
 PageNumber *getFrameContents (BM_BufferPool *const bm);
@@ -60,5 +156,7 @@ bool *getDirtyFlags (BM_BufferPool *const bm);
 int *getFixCounts (BM_BufferPool *const bm);
 int getNumReadIO (BM_BufferPool *const bm);
 int getNumWriteIO (BM_BufferPool *const bm);
+RC getFrameInfo (BM_BufferPool *const bm, PageNumber *frameContents, bool *dirtyFlags, int *fixCounts);
+RC getPoolStats (BM_BufferPool *const bm, BM_PoolStats *stats);
 
 #endif
@@ -6,19 +6,19 @@
 
 // local functions
 static void printStrat (BM_BufferPool *const bm);
+static const char *stratName (BM_BufferPool *const bm);
+static int sprintPoolStatsJSONInto (BM_BufferPool *const bm, char *message, int size);
 
 // external functions
 void 
 printPoolContent (BM_BufferPool *const bm)
 {
-	PageNumber *frameContent;
-	bool *dirty;
-	int *fixCount;
+	PageNumber frameContent[bm->numPages];
+	bool dirty[bm->numPages];
+	int fixCount[bm->numPages];
 	int i;
 
-	frameContent = getFrameContents(bm);
-	dirty = getDirtyFlags(bm);
-	fixCount = getFixCounts(bm);
+	getFrameInfo(bm, frameContent, dirty, fixCount);
 
 	printf("{");
 	printStrat(bm);
@@ -32,17 +32,15 @@ printPoolContent (BM_BufferPool *const bm)
 char *
 sprintPoolContent (BM_BufferPool *const bm)
 {
-	PageNumber *frameContent;
-	bool *dirty;
-	int *fixCount;
+	PageNumber frameContent[bm->numPages];
+	bool dirty[bm->numPages];
+	int fixCount[bm->numPages];
 	int i;
 	char *message;
 	int pos = 0;
 
 	message = (char *) malloc(256 + (22 * bm->numPages));
-	frameContent = getFrameContents(bm);
-	dirty = getDirtyFlags(bm);
-	fixCount = getFixCounts(bm);
+	getFrameInfo(bm, frameContent, dirty, fixCount);
 
 	for (i = 0; i < bm->numPages; i++)
 		pos += sprintf(message + pos, "%s[%i%s%i]", ((i == 0) ? "" : ",") , frameContent[i], (dirty[i] ? "x": " "), fixCount[i]);
@@ -50,6 +48,65 @@ sprintPoolContent (BM_BufferPool *const bm)
 	return message;
 }
 
+void
+printPoolStatsJSON (BM_BufferPool *const bm)
+{
+	char message[1024];
+
+	sprintPoolStatsJSONInto(bm, message, sizeof(message));
+	printf("%s\n", message);
+}
+
+char *
+sprintPoolStatsJSON (BM_BufferPool *const bm)
+{
+	char *message;
+
+	message = (char *) malloc(1024);
+	sprintPoolStatsJSONInto(bm, message, 1024);
+	return message;
+}
+
+// writes the counters of getPoolStats as one JSON object into message
+static int
+sprintPoolStatsJSONInto (BM_BufferPool *const bm, char *message, int size)
+{
+	BM_PoolStats stats;
+	const char *name = stratName(bm);
+	char strategy[16];
+	long pins;
+
+	if (getPoolStats(bm, &stats) != RC_OK)
+		return snprintf(message, size, "{}");
+
+	// a strategy without a name is printed as its number, like printStrat does
+	if (name != NULL)
+		snprintf(strategy, sizeof(strategy), "%s", name);
+	else
+		snprintf(strategy, sizeof(strategy), "%i", bm->strategy);
+	pins = stats.hits + stats.misses;
+
+	return snprintf(message, size,
+			"{\"strategy\": \"%s\", \"numPages\": %i, "
+			"\"hits\": %ld, \"misses\": %ld, \"hitRatio\": %.4f, "
+			"\"reads\": %ld, \"writes\": %ld, "
+			"\"evictions\": %ld, \"dirtyEvictions\": %ld, "
+			"\"pinWaitNanos\": %ld, "
+			"\"victimSearches\": %ld, \"victimRetries\": %ld, "
+			"\"prefetchReads\": %ld, \"cleanerWrites\": %ld, "
+			"\"compressedStores\": %ld, \"compressedHits\": %ld, "
+			"\"victimCacheWrites\": %ld, \"victimCacheHits\": %ld}",
+			strategy, bm->numPages,
+			stats.hits, stats.misses, (pins > 0) ? (double) stats.hits / pins : 0.0,
+			stats.reads, stats.writes,
+			stats.evictions, stats.dirtyEvictions,
+			stats.pinWaitNanos,
+			stats.victimSearches, stats.victimRetries,
+			stats.prefetchReads, stats.cleanerWrites,
+			stats.compressedStores, stats.compressedHits,
+			stats.victimCacheWrites, stats.victimCacheHits);
+}
+
 
 void
 printPageContent (BM_PageHandle *const page)
@@ -80,26 +137,31 @@ sprintPageContent (BM_PageHandle *const page)
 
 void
 printStrat (BM_BufferPool *const bm)
+{
+	const char *name = stratName(bm);
+
+	if (name != NULL)
+		printf("%s", name);
+	else
+		printf("%i", bm->strategy);
+}
+
+const char *
+stratName (BM_BufferPool *const bm)
 {
 	switch (bm->strategy)
 	{
 	case RS_FIFO:
-		printf("FIFO");
-		break;
+		return "FIFO";
 	case RS_LRU:
-		printf("LRU");
-		break;
+		return "LRU";
 	case RS_CLOCK:
-		printf("CLOCK");
-		break;
+		return "CLOCK";
 	case RS_LFU:
-		printf("LFU");
-		break;
+		return "LFU";
 	case RS_LRU_K:
-		printf("LRU-K");
-		break;
+		return "LRU-K";
 	default:
-		printf("%i", bm->strategy);
-		break;
+		return NULL;
 	}
 }
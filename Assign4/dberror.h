@@ -68,6 +68,17 @@ typedef int RC;
 #define RC_UNSUPPORTED_DATATYPE 615
 #define RC_MEM_ALLOCATION_FAIL 617
 #define RC_SCHEMA_NOT_FOUND 618
+#define RC_TOO_MANY_POOL_FILES 619
+#define RC_POOL_STILL_IN_USE 620
+#define RC_POOL_CAPACITY_EXCEEDED 621
+#define RC_MEMORY_PRESSURE_UNAVAILABLE 622
+#define RC_PAGE_TRACE_RUNNING 623
+#define RC_INVALID_MANIFEST 624
+#define RC_RM_RECORD_TOO_LARGE 625
+#define RC_RM_BROKEN_OVERFLOW_CHAIN 626
+#define RC_RM_CSV_PARSE_ERROR 627
+#define RC_RM_TABLE_IN_USE 628
+#define RC_RM_INVALID_CATALOG 629
 
 
 #define RC_RM_COMPARE_VALUE_OF_DIFFERENT_DATATYPE 200
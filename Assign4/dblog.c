@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "dblog.h"
+
+/*
+ * Each thread records its events in a ring of its own, so recording is a few stores and no
+ * locks. Rings are linked into a list that only ever grows; a ring whose thread ended is
+ * handed to the next new thread, which keeps the number of rings at the number of threads
+ * that ran at the same time. The events of an ended thread stay dumpable until then.
+ *
+ * On x86 events are stamped with the time stamp counter, which is several times cheaper to
+ * read than the clock. A dump converts the stamps to nanoseconds, measuring the counter's rate
+ * against CLOCK_MONOTONIC between dbEnableEventTrace() and the dump.
+ */
+
+typedef struct DbEvent {
+	uint64_t time; // eventClock()
+	uint32_t id;   // DbEventId
+	uint32_t reserved;
+	int64_t arg1;
+	int64_t arg2;
+} DbEvent;
+
+typedef struct DbEventRing {
+	DbEvent events[DB_EVENT_RING_SIZE];
+	atomic_ulong numEvents; // events ever recorded, the next one goes to numEvents % DB_EVENT_RING_SIZE
+	atomic_bool inUse;
+	int ringNo;
+	struct DbEventRing *next;
+} DbEventRing;
+
+// event of a dump, with the ring it came from
+typedef struct DumpedEvent {
+	DbEvent event;
+	int ringNo;
+} DumpedEvent;
+
+static const char *dbEventNames[DB_NUM_EVENTS] = {
+	"PIN_HIT fileId pageNum",
+	"PIN_MISS fileId pageNum",
+	"UNPIN fileId pageNum",
+	"PAGE_READ fileId pageNum",
+	"PAGE_WRITE fileId pageNum",
+	"EVICT fileId pageNum",
+	"FLUSH fileId pages",
+	"EXTEND_FILE oldPages newPages"
+};
+
+static const char *dbLevelNames[] = { "NONE", "ERROR", "WARN", "INFO", "DEBUG", "TRACE" };
+
+atomic_bool dbEventTraceOn = false;
+
+static _Atomic(DbEventRing *) eventRings = NULL;
+static atomic_int numEventRings = 0;
+static _Thread_local DbEventRing *threadRing = NULL;
+
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t ringKey;
+
+// eventClock() and CLOCK_MONOTONIC when recording was last switched on
+static _Atomic uint64_t clockBaseTicks = 0;
+static _Atomic uint64_t clockBaseNanos = 0;
+
+static uint64_t monotonicNanos(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+
+static uint64_t eventClock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return monotonicNanos();
+#endif
+}
+
+/**
+ * Description:
+ * Writes one log message with its level and source location to stderr, as one line.
+ */
+void dbLogPrint (int level, const char *file, int line, const char *format, ...) {
+	char message[1024];
+	va_list args;
+
+	va_start(args, format);
+	vsnprintf(message, sizeof(message), format, args);
+	va_end(args);
+
+	const char *name = strrchr(file, '/');
+	fprintf(stderr, "[%s] %s:%d: %s\n", dbLevelNames[level], name != NULL ? name + 1 : file, line, message);
+}
+
+// called when a thread that recorded events ends
+static void releaseRing(void *ring) {
+	atomic_store(&((DbEventRing *) ring)->inUse, false);
+}
+
+static void createRingKey(void) {
+	pthread_key_create(&ringKey, releaseRing);
+}
+
+/**
+ * Description:
+ * Gives the calling thread a ring, one left by an ended thread if there is one.
+ *
+ * @return the ring, NULL if there is none and no memory for a new one.
+ */
+static DbEventRing *acquireRing(void) {
+	pthread_once(&ringKeyOnce, createRingKey);
+
+	DbEventRing *ring;
+	for (ring = atomic_load(&eventRings); ring != NULL; ring = ring->next) {
+		_Bool expected = false;
+		if (atomic_compare_exchange_strong(&ring->inUse, &expected, true)) {
+			break;
+		}
+	}
+
+	if (ring == NULL) {
+		ring = malloc(sizeof(DbEventRing));
+		if (ring == NULL) {
+			return NULL;
+		}
+		ring->numEvents = 0;
+		ring->inUse = true;
+		ring->ringNo = atomic_fetch_add(&numEventRings, 1);
+		ring->next = atomic_load(&eventRings);
+		while (!atomic_compare_exchange_weak(&eventRings, &ring->next, ring)) {
+		}
+	}
+
+	pthread_setspecific(ringKey, ring);
+	threadRing = ring;
+	return ring;
+}
+
+/**
+ * Description:
+ * Records an event in the calling thread's ring, overwriting its oldest event once it is full.
+ * Use it through DB_EVENT, which only calls it while recording is switched on.
+ */
+void dbRecordEvent (DbEventId id, long arg1, long arg2) {
+	DbEventRing *ring = threadRing != NULL ? threadRing : acquireRing();
+	if (ring == NULL) {
+		return;
+	}
+
+	unsigned long n = atomic_load_explicit(&ring->numEvents, memory_order_relaxed);
+	DbEvent *event = &ring->events[n & (DB_EVENT_RING_SIZE - 1)];
+	event->time = eventClock();
+	event->id = id;
+	event->arg1 = arg1;
+	event->arg2 = arg2;
+	atomic_store_explicit(&ring->numEvents, n + 1, memory_order_release);
+}
+
+/**
+ * Description:
+ * Switches recording of DB_EVENT events on or off for all threads. The events recorded so far
+ * are kept either way.
+ */
+void dbEnableEventTrace (bool enabled) {
+	if (enabled) {
+		clockBaseTicks = eventClock();
+		clockBaseNanos = monotonicNanos();
+	}
+	atomic_store(&dbEventTraceOn, enabled);
+}
+
+static int compareDumpedEvents(const void *first, const void *second) {
+	const DumpedEvent *a = first, *b = second;
+	return (a->event.time > b->event.time) - (a->event.time < b->event.time);
+}
+
+/**
+ * Description:
+ * Writes the events in all rings to the text file `fileName`, oldest first, one line
+ * "<CLOCK_MONOTONIC nanoseconds> <ring> <event> <arg1> <arg2>" per event, after a line naming the arguments
+ * of each event. Threads may keep recording meanwhile: events overwritten while the rings are
+ * copied are left out.
+ *
+ * @return RC_OK, RC_MEMORY_ALLOCATION_FAIL or RC_WRITE_FAILED.
+ */
+RC dbDumpEventTrace (const char *fileName) {
+	int capacity = atomic_load(&numEventRings) * DB_EVENT_RING_SIZE;
+	DumpedEvent *dumped = malloc(sizeof(DumpedEvent) * (capacity > 0 ? capacity : 1));
+	if (dumped == NULL) {
+		return RC_MEMORY_ALLOCATION_FAIL;
+	}
+
+	int numDumped = 0;
+	for (DbEventRing *ring = atomic_load(&eventRings); ring != NULL && numDumped < capacity; ring = ring->next) {
+		unsigned long last = atomic_load_explicit(&ring->numEvents, memory_order_acquire);
+		unsigned long first = last > DB_EVENT_RING_SIZE ? last - DB_EVENT_RING_SIZE : 0;
+		int start = numDumped;
+
+		for (unsigned long n = first; n < last && numDumped < capacity; n++) {
+			dumped[numDumped].event = ring->events[n & (DB_EVENT_RING_SIZE - 1)];
+			dumped[numDumped].ringNo = ring->ringNo;
+			numDumped++;
+		}
+
+		// the thread may have lapped the oldest events while they were copied
+		unsigned long now = atomic_load_explicit(&ring->numEvents, memory_order_acquire);
+		if (now > first + DB_EVENT_RING_SIZE) {
+			int overwritten = (int) (now - first - DB_EVENT_RING_SIZE);
+			if (overwritten > numDumped - start) {
+				overwritten = numDumped - start;
+			}
+			memmove(&dumped[start], &dumped[start + overwritten], sizeof(DumpedEvent) * (numDumped - start - overwritten));
+			numDumped -= overwritten;
+		}
+	}
+	qsort(dumped, numDumped, sizeof(DumpedEvent), compareDumpedEvents);
+
+	uint64_t baseTicks = clockBaseTicks, baseNanos = clockBaseNanos;
+	uint64_t ticks = eventClock(), nanos = monotonicNanos();
+	double nanosPerTick = (ticks > baseTicks && nanos > baseNanos) ? (double) (nanos - baseNanos) / (ticks - baseTicks) : 1.0;
+
+	FILE *out = fopen(fileName, "w");
+	if (out == NULL) {
+		free(dumped);
+		return RC_WRITE_FAILED;
+	}
+
+	fprintf(out, "# time ring event arg1 arg2:");
+	for (int i = 0; i < DB_NUM_EVENTS; i++) {
+		fprintf(out, " %s%s", dbEventNames[i], i + 1 < DB_NUM_EVENTS ? "," : "\n");
+	}
+	for (int i = 0; i < numDumped; i++) {
+		DbEvent *event = &dumped[i].event;
+		const char *name = event->id < DB_NUM_EVENTS ? dbEventNames[event->id] : "UNKNOWN";
+		long time = (long) baseNanos + (long) (((double) event->time - (double) baseTicks) * nanosPerTick);
+		fprintf(out, "%ld %d %.*s %ld %ld\n", time, dumped[i].ringNo,
+				(int) strcspn(name, " "), name, (long) event->arg1, (long) event->arg2);
+	}
+
+	bool written = !ferror(out);
+	written = fclose(out) == 0 && written;
+	free(dumped);
+	return written ? RC_OK : RC_WRITE_FAILED;
+}
@@ -0,0 +1,71 @@
+#ifndef DBLOG_H
+#define DBLOG_H
+
+#include <stdatomic.h>
+
+#include "dberror.h"
+#include "dt.h"
+
+/*
+ * Leveled logging that compiles out, and a per-thread event ring for hot paths.
+ *
+ * DB_LOG_LEVEL selects at build time what is logged, e.g. -DDB_LOG_LEVEL=DB_LOG_LEVEL_DEBUG.
+ * Messages above it are removed by the compiler, arguments included. Messages go to stderr.
+ *
+ * DB_EVENT records a binary event (time, id, two arguments) in a ring of the calling thread,
+ * without locks or system calls, while dbEnableEventTrace() has switched recording on.
+ * dbDumpEventTrace() writes the events of all threads to a file. Building with
+ * -DDB_NO_EVENT_TRACE removes the events entirely.
+ */
+
+#define DB_LOG_LEVEL_NONE 0
+#define DB_LOG_LEVEL_ERROR 1
+#define DB_LOG_LEVEL_WARN 2
+#define DB_LOG_LEVEL_INFO 3
+#define DB_LOG_LEVEL_DEBUG 4
+#define DB_LOG_LEVEL_TRACE 5
+
+#ifndef DB_LOG_LEVEL
+#define DB_LOG_LEVEL DB_LOG_LEVEL_WARN
+#endif
+
+#define DB_LOG(level, ...) \
+  do { if ((level) <= DB_LOG_LEVEL) dbLogPrint((level), __FILE__, __LINE__, __VA_ARGS__); } while (0)
+
+#define DB_LOG_ERROR(...) DB_LOG(DB_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define DB_LOG_WARN(...) DB_LOG(DB_LOG_LEVEL_WARN, __VA_ARGS__)
+#define DB_LOG_INFO(...) DB_LOG(DB_LOG_LEVEL_INFO, __VA_ARGS__)
+#define DB_LOG_DEBUG(...) DB_LOG(DB_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define DB_LOG_TRACE(...) DB_LOG(DB_LOG_LEVEL_TRACE, __VA_ARGS__)
+
+// events of the event ring, see dbEventNames in dblog.c for what their arguments are
+typedef enum DbEventId {
+  DB_EVENT_PIN_HIT = 0,
+  DB_EVENT_PIN_MISS = 1,
+  DB_EVENT_UNPIN = 2,
+  DB_EVENT_PAGE_READ = 3,
+  DB_EVENT_PAGE_WRITE = 4,
+  DB_EVENT_EVICT = 5,
+  DB_EVENT_FLUSH = 6,
+  DB_EVENT_EXTEND_FILE = 7,
+  DB_NUM_EVENTS = 8
+} DbEventId;
+
+#define DB_EVENT_RING_SIZE 4096 // events kept per thread, a power of two
+
+extern atomic_bool dbEventTraceOn;
+
+#ifdef DB_NO_EVENT_TRACE
+#define DB_EVENT(id, arg1, arg2) ((void) 0)
+#else
+#define DB_EVENT(id, arg1, arg2) \
+  do { if (atomic_load_explicit(&dbEventTraceOn, memory_order_relaxed)) dbRecordEvent((id), (arg1), (arg2)); } while (0)
+#endif
+
+void dbLogPrint (int level, const char *file, int line, const char *format, ...)
+  __attribute__((format(printf, 4, 5)));
+void dbRecordEvent (DbEventId id, long arg1, long arg2);
+void dbEnableEventTrace (bool enabled);
+RC dbDumpEventTrace (const char *fileName);
+
+#endif
@@ -0,0 +1,212 @@
+#include<string.h>
+#include<stdint.h>
+
+#include "page_compress.h"
+
+/*
+ * The compressed data is a list of sequences. Each one starts with a token byte: the high four
+ * bits are the number of literal bytes that follow the token, the low four bits the length of
+ * the match after them minus MIN_MATCH. A nibble of 15 is continued by length bytes that are
+ * added up until one of them is below 255. The literals come next, then the match offset as
+ * two bytes, little endian. The last sequence only has literals and ends the input.
+ */
+
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+#define HASH_BITS 12
+#define NIBBLE_MAX 15
+
+static uint32_t read32(const char *p) {
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint64_t read64(const char *p) {
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// number of equal bytes at `a` and `b`, at most `limit`, compared eight at a time
+static int matchLength(const char *a, const char *b, int limit) {
+	int length = 0;
+	while (length + 8 <= limit) {
+		uint64_t diff = read64(a + length) ^ read64(b + length);
+		if (diff != 0) {
+			return length + __builtin_ctzll(diff) / 8;
+		}
+		length += 8;
+	}
+	while (length < limit && a[length] == b[length]) {
+		length++;
+	}
+	return length;
+}
+
+static int hashOf(uint32_t sequence) {
+	return (int) ((sequence * 2654435761U) >> (32 - HASH_BITS));
+}
+
+// writes the extra bytes of a length that did not fit its nibble
+static char *writeLength(char *op, const char *end, int length) {
+	for (length -= NIBBLE_MAX; length >= 255; length -= 255) {
+		if (op >= end) {
+			return NULL;
+		}
+		*op++ = (char) 255;
+	}
+	if (op >= end) {
+		return NULL;
+	}
+	*op++ = (char) length;
+	return op;
+}
+
+/**
+ * Description:
+ * Writes one sequence: `numLiterals` literals and, unless `matchLength` is 0, a match.
+ *
+ * @return the position after the sequence, NULL if it does not fit before `end`.
+ */
+static char *writeSequence(char *op, const char *end, const char *literals, int numLiterals, int offset, int matchLength) {
+	if (op >= end) {
+		return NULL;
+	}
+	char *token = op++;
+	int matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+
+	*token = (char) (((numLiterals < NIBBLE_MAX ? numLiterals : NIBBLE_MAX) << 4)
+			| (matchCode < NIBBLE_MAX ? matchCode : NIBBLE_MAX));
+
+	if (numLiterals >= NIBBLE_MAX && (op = writeLength(op, end, numLiterals)) == NULL) {
+		return NULL;
+	}
+	if (end - op < numLiterals) {
+		return NULL;
+	}
+	memcpy(op, literals, numLiterals);
+	op += numLiterals;
+
+	if (matchLength > 0) {
+		if (end - op < 2) {
+			return NULL;
+		}
+		*op++ = (char) (offset & 0xFF);
+		*op++ = (char) (offset >> 8);
+		if (matchCode >= NIBBLE_MAX && (op = writeLength(op, end, matchCode)) == NULL) {
+			return NULL;
+		}
+	}
+	return op;
+}
+
+/**
+ * Description:
+ * Compresses a page. Matches are found through a table of the last position of every hashed
+ * four byte sequence, so each input byte is looked at about once. Positions are kept plus one
+ * in 16 bits, 0 for none, so `size` may be at most MAX_OFFSET.
+ *
+ * @return the compressed size, -1 if it would exceed `capacity`.
+ */
+int compressPage (const char *page, int size, char *out, int capacity) {
+	uint16_t lastSeen[1 << HASH_BITS];
+	memset(lastSeen, 0, sizeof(lastSeen));
+
+	char *op = out;
+	const char *end = out + capacity;
+	int anchor = 0, i = 0;
+
+	while (i + MIN_MATCH <= size) {
+		uint32_t sequence = read32(page + i);
+		int h = hashOf(sequence);
+		int candidate = lastSeen[h] - 1;
+		lastSeen[h] = (uint16_t) (i + 1);
+
+		if (candidate < 0 || i - candidate > MAX_OFFSET || read32(page + candidate) != sequence) {
+			i++;
+			continue;
+		}
+
+		int length = MIN_MATCH + matchLength(page + candidate + MIN_MATCH, page + i + MIN_MATCH, size - i - MIN_MATCH);
+
+		op = writeSequence(op, end, page + anchor, i - anchor, i - candidate, length);
+		if (op == NULL) {
+			return -1;
+		}
+		i += length;
+		anchor = i;
+	}
+
+	op = writeSequence(op, end, page + anchor, size - anchor, 0, 0);
+	return op == NULL ? -1 : (int) (op - out);
+}
+
+// reads the extra bytes of a length whose nibble was 15
+static const char *readLength(const char *ip, const char *end, int *length) {
+	unsigned char extra;
+	do {
+		if (ip >= end) {
+			return NULL;
+		}
+		extra = (unsigned char) *ip++;
+		*length += extra;
+	} while (extra == 255);
+	return ip;
+}
+
+/**
+ * Description:
+ * Decompresses a page written by compressPage().
+ *
+ * @return 0, or -1 if the input is damaged or does not decompress to exactly `size` bytes.
+ */
+int decompressPage (const char *in, int inSize, char *page, int size) {
+	const char *ip = in, *inEnd = in + inSize;
+	char *op = page, *outEnd = page + size;
+
+	while (ip < inEnd) {
+		unsigned char token = (unsigned char) *ip++;
+
+		int numLiterals = token >> 4;
+		if (numLiterals == NIBBLE_MAX && (ip = readLength(ip, inEnd, &numLiterals)) == NULL) {
+			return -1;
+		}
+		if (inEnd - ip < numLiterals || outEnd - op < numLiterals) {
+			return -1;
+		}
+		memcpy(op, ip, numLiterals);
+		ip += numLiterals;
+		op += numLiterals;
+
+		if (ip == inEnd) {
+			break;
+		}
+
+		if (inEnd - ip < 2) {
+			return -1;
+		}
+		int offset = (unsigned char) ip[0] | ((unsigned char) ip[1] << 8);
+		ip += 2;
+
+		int length = token & NIBBLE_MAX;
+		if (length == NIBBLE_MAX && (ip = readLength(ip, inEnd, &length)) == NULL) {
+			return -1;
+		}
+		length += MIN_MATCH;
+
+		if (offset == 0 || offset > op - page || outEnd - op < length) {
+			return -1;
+		}
+		// the match may overlap the bytes it produces. Those repeat with period `offset`, so each
+		// copy can take everything written since `match`, twice as much as the copy before
+		const char *match = op - offset;
+		for (int copied = 0; copied < length; ) {
+			int chunk = copied + offset < length - copied ? copied + offset : length - copied;
+			memcpy(op + copied, match, chunk);
+			copied += chunk;
+		}
+		op += length;
+	}
+	return op == outEnd ? 0 : -1;
+}
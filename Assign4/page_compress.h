@@ -0,0 +1,16 @@
+#ifndef PAGE_COMPRESS_H
+#define PAGE_COMPRESS_H
+
+/*
+ * A small LZ77 codec for pages, in the spirit of LZ4: fast rather than tight, and the
+ * decompressor checks every length against both buffers, so a damaged input is reported
+ * instead of read or written past.
+ */
+
+// compresses `size` bytes into `out`, returns the compressed size or -1 if it exceeds `capacity`
+int compressPage (const char *page, int size, char *out, int capacity);
+
+// restores exactly `size` bytes from `inSize` compressed bytes, returns 0 or -1 for a damaged input
+int decompressPage (const char *in, int inSize, char *page, int size);
+
+#endif
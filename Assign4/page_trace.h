@@ -0,0 +1,43 @@
+#ifndef PAGE_TRACE_H
+#define PAGE_TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Layout of a page reference trace, written by startPageTrace() and read by trace_sim.
+ *
+ * The file is a PageTraceHeader followed by `capacity` PageTraceEvent slots used as a ring:
+ * event i goes to slot i % capacity. `numEvents` counts all events ever recorded and is kept
+ * up to date while the trace runs, so the file can be read at any time. Once it exceeds
+ * `capacity` only the last `capacity` events are left, the oldest one in slot
+ * numEvents % capacity.
+ */
+
+#define PAGE_TRACE_MAGIC 0x45435254 // "TRCE"
+#define PAGE_TRACE_VERSION 1
+
+// kinds of trace events
+typedef enum PageTraceKind {
+  PAGE_TRACE_HIT = 0,   // pin of a page that was in the pool
+  PAGE_TRACE_MISS = 1,  // pin that had to read its page
+  PAGE_TRACE_UNPIN = 2
+} PageTraceKind;
+
+typedef struct PageTraceHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;  // event slots that follow the header
+  uint32_t numFrames; // frames of the pool when the trace was started
+  uint64_t numEvents; // events recorded so far
+  uint64_t startTime; // CLOCK_REALTIME of the start, in nanoseconds
+} PageTraceHeader;
+
+typedef struct PageTraceEvent {
+  uint64_t time;    // nanoseconds since the start of the trace
+  int32_t pageNum;
+  uint16_t fileId;  // slot of the page file in the pool, see openSharedBufferPool
+  uint8_t kind;     // PageTraceKind
+  uint8_t reserved;
+} PageTraceEvent;
+
+#endif
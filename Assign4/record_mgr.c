@@ -1,17 +1,122 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "record_mgr.h"
 #include "buffer_mgr.h"
 #include "storage_mgr.h"
+#include "dblog.h"
 
 /* Some constants taht are helpful for the assignment */
-const int MAXIMUM_PAGES = 100;
 const int SIZE_OF_ATTRIBUTE = 15;
 
+/*
+ * Layout of the data pages of a table, pages 1 and up (page 0 holds the counters of the table, its schema is in the catalog):
+ *
+ * | DataPageHeader | slot directory, a SlotEntry per slot -> | free space | <- records |
+ *
+ * Records are stacked down from the end of the page and found through their slot's entry, so
+ * they can have any length and can move on the page without their RID changing. Deleted and
+ * shrunk records leave holes, which are compacted away when an insert needs the room. The
+ * header has a bitmap of the used slots, so inserts find a free slot and scans the next record
+ * a word of slots at a time. A page of zeros is a data page that is not set up yet.
+ *
+ * A record is stored as its kind (StoredRecordKind), the end offset of each attribute and the
+ * values, strings without their padding:
+ *
+ * | kind | end of attr 0 | end of attr 1 | ... | value 0 | value 1 | ... |
+ *
+ * A string that would make the record longer than MAX_INLINE_RECORD, so that it would not fit a
+ * roomy page, is kept in a chain of overflow pages instead. Records without such strings may be
+ * up to MAX_RECORD_SIZE long and go to an empty page. Its end offset has OVERFLOW_FLAG set and its value is the first page
+ * of the chain and the string's length. A record that grows out of its page moves to another
+ * page as STORED_MOVED and leaves a STORED_FORWARD stub with its new RID in its slot, so its RID
+ * stays the same. Records take at least FORWARD_SIZE bytes, so a stub always fits in their place.
+ *
+ * Page 1 and every (FSM_ENTRIES_PER_PAGE + 1)th page after it are free-space map pages instead.
+ * Each holds FSM_BITS bits for each of the pages that follow it, how much room the page has (see
+ * FsmCategory), so an insert finds a page with room without reading the data pages. A zero
+ * entry is an empty page, so new map pages need no setting up either.
+ */
+typedef enum PageKind {
+	DATA_PAGE = 0,
+	OVERFLOW_PAGE = 1
+} PageKind;
+
+typedef struct SlotEntry {
+	uint16_t offset;
+	uint16_t length; // 0 for an unused entry
+} SlotEntry;
+
+#define FORWARD_SIZE (1 + 2 * (int) sizeof(int))
+
+// records take at least FORWARD_SIZE bytes, which bounds the slots a page can have
+#define MAX_PAGE_SLOTS (PAGE_SIZE / (FORWARD_SIZE + (int) sizeof(SlotEntry)))
+#define SLOT_BITMAP_WORDS ((MAX_PAGE_SLOTS + 63) / 64)
+
+typedef struct DataPageHeader {
+	int kind;            // PageKind
+	int numLive;         // records on the page, forwarding stubs included
+	int numSlots;        // entries of the slot directory
+	int freeSpaceOffset; // end of the slot directory
+	int dataOffset;      // start of the lowest record, 0 until the page is set up
+	int freeBytes;       // free bytes, the holes of deleted and shrunk records included
+	int firstFreeSlot;   // the lowest unused directory entry, numSlots if there is none
+	uint64_t usedSlots[SLOT_BITMAP_WORDS]; // bit i is set while slot i holds a record
+} DataPageHeader;
+
+// a page of an overflow chain, the part of the value on it follows the header
+typedef struct OverflowPageHeader {
+	int kind;     // OVERFLOW_PAGE
+	int nextPage; // NO_PAGE on the last page of the chain
+	int length;   // bytes of the value on this page
+} OverflowPageHeader;
+
+typedef enum StoredRecordKind {
+	STORED_RECORD = 0,
+	STORED_MOVED = 1,  // moved here by an update, reached through the stub in its home slot
+	STORED_FORWARD = 2 // stub of a moved record, followed by the page and slot it moved to
+} StoredRecordKind;
+
+#define OVERFLOW_FLAG 0x8000
+#define OVERFLOW_POINTER_SIZE (2 * (int) sizeof(int))
+#define OVERFLOW_CAPACITY (PAGE_SIZE - (int) sizeof(OverflowPageHeader))
+
+#define FSM_BITS 2
+#define FSM_ENTRIES_PER_PAGE (PAGE_SIZE * 8 / FSM_BITS)
+#define FSM_ROOMY_BYTES (PAGE_SIZE / 4)
+#define FSM_SOME_ROOM_BYTES (PAGE_SIZE / 16)
+#define MAX_INLINE_RECORD (FSM_ROOMY_BYTES - (int) sizeof(SlotEntry))
+#define MAX_RECORD_SIZE (PAGE_SIZE - (int) sizeof(DataPageHeader) - (int) sizeof(SlotEntry))
+
+// how much room a page has, as its free-space map entry says
+typedef enum FsmCategory {
+	FSM_EMPTY = 0,     // no records, or not set up yet
+	FSM_ROOMY = 1,     // at least FSM_ROOMY_BYTES free
+	FSM_SOME_ROOM = 2, // at least FSM_SOME_ROOM_BYTES free
+	FSM_FULL = 3       // less than that, or an overflow page
+} FsmCategory;
+
 /* custom functions declarations */ 
-int findFreeSlot(char *data, int recordSize);
 RC attributeOffset (Schema *schema, int attributeNumber, int *output) ;
+static int attributeLength(Schema *schema, int attrNum);
+static void initDataPage(char *page);
+static SlotEntry *slotEntry(char *page, int slot);
+static bool isSlotUsed(char *page, int slot);
+static int pageInsert(char *page, const char *stored, int length);
+static bool pageReplace(char *page, int slot, const char *stored, int length);
+static void pageRemove(char *page, int slot);
+static int nextLiveSlot(char *page, int from);
+static RID forwardTarget(const char *stored);
+static bool isFsmPage(int pageNum);
+static FsmCategory fsmCategoryOf(char *page);
 
 /* table and manager functions declarations */
 RC initRecordManager (void *mgmtData);
@@ -24,6 +129,8 @@ RC closeTable (RM_TableData *rel);
 
 /* handling records in a table functions declarations */
 RC insertRecord (RM_TableData *rel, Record *record);
+RC insertRecords (RM_TableData *rel, Record **records, int n, RID *rids);
+RC loadTableFromCSV (RM_TableData *rel, char *path, const RM_LoadOptions *options);
 RC deleteRecord (RM_TableData *rel, RID id);
 RC updateRecord (RM_TableData *rel, Record *record);
 RC getRecord (RM_TableData *rel, RID id, Record *record);
@@ -44,6 +151,15 @@ RC freeRecord (Record *record);
 RC getAttr (Record *record, Schema *schema, int attrNum, Value **value);
 RC setAttr (Record *record, Schema *schema, int attrNum, Value *value);
 
+// where the attributes of a table are in the data of its records, worked out once per table
+typedef struct TableLayout {
+	int numAttr;
+	int recordSize; // getRecordSize of the schema
+	int *offsets;   // attributeOffset of each attribute
+	int *lengths;   // bytes each attribute takes
+	bool *isString;
+} TableLayout;
+
 /* The Main Data Structure */
 typedef struct RecordM {
 	BM_BufferPool buffer;
@@ -53,45 +169,684 @@ typedef struct RecordM {
 	int tupleCount;
 	int freeCount;
 	int scanCount;
+	int numPages;
+	BM_AccessRing *accessRing;
+	struct CatalogEntry *entry; // the table in the catalog
+	Schema *schema;             // of the catalog entry, shared by every handle on the table
+	TableLayout *layout;
+	int openCount;              // openTable calls for the table that were not closed yet
 } RecordManagement;
 
-RecordManagement * manager;
+static void writeTableCounters(RecordManagement *recordManagement);
+static FsmCategory fullestFitting(int length);
+static RC findPageWithRoom(RecordManagement *recordManagement, int from, FsmCategory fullest, int *pageNum);
+static void setFsmCategory(RecordManagement *recordManagement, int pageNum, FsmCategory category);
+static RC encodeRecord(RecordManagement *recordManagement, char *data, char *stored, int *length);
+static RC decodeRecord(RecordManagement *recordManagement, const char *stored, char *data);
+static void freeOverflowValues(RecordManagement *recordManagement, const char *stored);
+static RC readStoredRecord(RecordManagement *recordManagement, RID id, char *stored, int *length);
+static RC placeRecord(RecordManagement *recordManagement, char *stored, int length, RID *id);
+static RC beginPageChange(RecordManagement *recordManagement, int pageNum, BM_PageHandle *handle, FsmCategory *before);
+static void endPageChange(RecordManagement *recordManagement, BM_PageHandle *handle, FsmCategory before);
+static void removeStoredRecord(RecordManagement *recordManagement, RID id);
+
+/*
+ * The catalog file CATALOG_FILE lists the tables: the page file each one is stored in and its
+ * schema, key attributes included. It is read when the record manager starts, kept in memory
+ * and written again whenever a table is created or deleted, to a temporary file that is then
+ * renamed over it, so a crash never leaves a torn catalog. Page 0 of a table holds only its
+ * counters. A table missing from the catalog that was created before there was one, with its
+ * schema on page 0, is added to the catalog when it is first opened.
+ *
+ * The catalog is binary: CATALOG_MAGIC, the version, then per table its name, its file name and
+ * its schema as encodeSchema encodes it, each as a varint length followed by the bytes. Numbers
+ * are varints, 7 bits a byte with the lowest bits first and the high bit set on all bytes but
+ * the last.
+ *
+ * In memory the catalog is a hash table by table name. An entry keeps the schema encoded, and
+ * the first open decodes it and works out its layout, which stay with the entry until the table
+ * is deleted. An open table's state hangs off its entry, so a table is set up once however many
+ * RM_TableData it is opened through, and opening a table that is open is one lookup. The catalog
+ * is guarded by tablesLock.
+ */
+#define CATALOG_FILE "table_catalog"
+#define CATALOG_MAGIC "RMCT"
+#define CATALOG_VERSION 2
+#define CATALOG_BUCKETS 256
+#define SCHEMA_IN_CATALOG -1 // on page 0 where tables created before the catalog have their number of attributes
+
+typedef struct CatalogEntry {
+	char *tableName;
+	char *fileName;
+	char *encodedSchema;     // the schema as the catalog file stores it
+	int encodedLength;
+	Schema *schema;          // decoded on the first open, shared by every handle on the table
+	TableLayout *layout;
+	RecordManagement *table; // state of the table while it is open, NULL otherwise
+	struct CatalogEntry *next; // next entry in the same bucket
+} CatalogEntry;
+
+static pthread_mutex_t tablesLock = PTHREAD_MUTEX_INITIALIZER;
+static CatalogEntry *catalog[CATALOG_BUCKETS];
+static bool catalogLoaded = false;
+
+/* ============================== catalog and table cache ========================== */
+
+// frees a schema and everything it points to, for the schemas the record manager made itself
+static void freeSchemaFully(Schema *schema) {
+	if (schema == NULL) {
+		return;
+	}
+	for (int i = 0; schema->attrNames != NULL && i < schema->numAttr; i++) {
+		free(schema->attrNames[i]);
+	}
+	free(schema->attrNames);
+	free(schema->dataTypes);
+	free(schema->typeLength);
+	free(schema->keyAttrs);
+	free(schema);
+}
+
+// allocates a schema of `numAttr` attributes and `numKeys` key attributes, its names not set
+static Schema *allocateSchema(int numAttr, int numKeys) {
+	Schema *schema = calloc(1, sizeof(Schema));
+	if (schema == NULL) {
+		return NULL;
+	}
+
+	int count = numAttr > 0 ? numAttr : 1;
+	schema->numAttr = numAttr;
+	schema->keySize = numKeys;
+	schema->attrNames = calloc(count, sizeof(char *));
+	schema->dataTypes = malloc(sizeof(DataType) * count);
+	schema->typeLength = malloc(sizeof(int) * count);
+	schema->keyAttrs = numKeys > 0 ? malloc(sizeof(int) * numKeys) : NULL;
+	if (schema->attrNames == NULL || schema->dataTypes == NULL || schema->typeLength == NULL || (numKeys > 0 && schema->keyAttrs == NULL)) {
+		freeSchemaFully(schema);
+		return NULL;
+	}
+	return schema;
+}
+
+// appends `value` to `out` as a varint, returns where the next byte goes
+static char *putVarint(char *out, unsigned int value) {
+	while (value >= 0x80) {
+		*out++ = (char) (value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (char) value;
+	return out;
+}
+
+// reads the varint at `*in` and moves past it, false if it runs past `end`
+static bool getVarint(const char **in, const char *end, unsigned int *value) {
+	unsigned int result = 0;
+
+	for (int shift = 0; *in < end && shift < 35; shift += 7) {
+		unsigned char byte = (unsigned char) *(*in)++;
+		result |= (unsigned int) (byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+// reads a varint length and the bytes after it, false if they run past `end`
+static bool getBytes(const char **in, const char *end, const char **bytes, unsigned int *length) {
+	if (!getVarint(in, end, length) || *length > (unsigned int) (end - *in)) {
+		return false;
+	}
+	*bytes = *in;
+	*in += *length;
+	return true;
+}
+
+/**
+ * Description:
+ * Encodes a schema for the catalog: the number of attributes and of key attributes, the data
+ * type, type length and name of each attribute, then the key attributes. Numbers are varints
+ * and names a varint length followed by their bytes, so names can have any length.
+ *
+ * @return the encoding with its length in `length`, NULL if there is no memory for it.
+ */
+static char *encodeSchema(Schema *schema, int *length) {
+	int numKeys = schema->keyAttrs != NULL ? schema->keySize : 0;
+	size_t size = 5 * (2 + 3 * (size_t) schema->numAttr + numKeys);
+
+	for (int i = 0; i < schema->numAttr; i++) {
+		size += strlen(schema->attrNames[i]);
+	}
+
+	char *encoded = malloc(size);
+	if (encoded == NULL) {
+		return NULL;
+	}
+
+	char *out = putVarint(encoded, schema->numAttr);
+	out = putVarint(out, numKeys);
+	for (int i = 0; i < schema->numAttr; i++) {
+		unsigned int nameLength = strlen(schema->attrNames[i]);
+		out = putVarint(out, schema->dataTypes[i]);
+		out = putVarint(out, schema->typeLength[i]);
+		out = putVarint(out, nameLength);
+		memcpy(out, schema->attrNames[i], nameLength);
+		out += nameLength;
+	}
+	for (int i = 0; i < numKeys; i++) {
+		out = putVarint(out, schema->keyAttrs[i]);
+	}
+
+	*length = out - encoded;
+	return encoded;
+}
+
+/**
+ * Description:
+ * Decodes a schema encoded by encodeSchema.
+ *
+ * @return RC_OK with the schema in `schema`, RC_RM_INVALID_CATALOG if the encoding is damaged or
+ * RC_MEMORY_ALLOCATION_ERROR.
+ */
+static RC decodeSchema(const char *encoded, int length, Schema **schema) {
+	const char *in = encoded, *end = encoded + length;
+	unsigned int numAttr, numKeys;
+
+	// every attribute takes at least three bytes, which bounds what a damaged count can allocate
+	if (!getVarint(&in, end, &numAttr) || !getVarint(&in, end, &numKeys) || numAttr > (unsigned int) length || numKeys > numAttr) {
+		return RC_RM_INVALID_CATALOG;
+	}
+
+	Schema *decoded = allocateSchema(numAttr, numKeys);
+	if (decoded == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+
+	for (int i = 0; i < (int) numAttr; i++) {
+		unsigned int dataType, typeLength, nameLength;
+		const char *name;
+		if (!getVarint(&in, end, &dataType) || !getVarint(&in, end, &typeLength) || !getBytes(&in, end, &name, &nameLength)
+				|| dataType > DT_BOOL) {
+			freeSchemaFully(decoded);
+			return RC_RM_INVALID_CATALOG;
+		}
+
+		decoded->dataTypes[i] = dataType;
+		decoded->typeLength[i] = typeLength;
+		decoded->attrNames[i] = malloc(nameLength + 1);
+		if (decoded->attrNames[i] == NULL) {
+			freeSchemaFully(decoded);
+			return RC_MEMORY_ALLOCATION_ERROR;
+		}
+		memcpy(decoded->attrNames[i], name, nameLength);
+		decoded->attrNames[i][nameLength] = '\0';
+	}
+
+	for (int i = 0; i < (int) numKeys; i++) {
+		unsigned int keyAttr;
+		if (!getVarint(&in, end, &keyAttr) || keyAttr >= numAttr) {
+			freeSchemaFully(decoded);
+			return RC_RM_INVALID_CATALOG;
+		}
+		decoded->keyAttrs[i] = keyAttr;
+	}
+
+	*schema = decoded;
+	return RC_OK;
+}
+
+static void freeLayout(TableLayout *layout) {
+	if (layout != NULL) {
+		free(layout->offsets);
+		free(layout->lengths);
+		free(layout->isString);
+		free(layout);
+	}
+}
+
+/**
+ * Description:
+ * Works out where the attributes of a schema are in the data of its records.
+ *
+ * @return the layout, NULL if there is no memory for it.
+ */
+static TableLayout *createLayout(Schema *schema) {
+	int count = schema->numAttr > 0 ? schema->numAttr : 1;
+	TableLayout *layout = calloc(1, sizeof(TableLayout));
+	if (layout == NULL) {
+		return NULL;
+	}
+
+	layout->numAttr = schema->numAttr;
+	layout->offsets = malloc(sizeof(int) * count);
+	layout->lengths = malloc(sizeof(int) * count);
+	layout->isString = malloc(sizeof(bool) * count);
+	if (layout->offsets == NULL || layout->lengths == NULL || layout->isString == NULL) {
+		freeLayout(layout);
+		return NULL;
+	}
+
+	// the data of a record starts with a byte of its own, see createRecord
+	int offset = 1;
+	for (int i = 0; i < schema->numAttr; i++) {
+		layout->offsets[i] = offset;
+		layout->lengths[i] = attributeLength(schema, i);
+		layout->isString[i] = schema->dataTypes[i] == DT_STRING;
+		offset += layout->lengths[i];
+	}
+	layout->recordSize = offset;
+	return layout;
+}
+
+static void freeCatalogEntry(CatalogEntry *entry) {
+	free(entry->tableName);
+	free(entry->fileName);
+	free(entry->encodedSchema);
+	freeSchemaFully(entry->schema);
+	freeLayout(entry->layout);
+	free(entry);
+}
+
+static unsigned int catalogBucket(const char *tableName) {
+	unsigned int hash = 2166136261u;
+	for (const char *c = tableName; *c != '\0'; c++) {
+		hash = (hash ^ (unsigned char) *c) * 16777619u;
+	}
+	return hash % CATALOG_BUCKETS;
+}
+
+// the catalog entry of a table, NULL if there is none. Call with tablesLock held.
+static CatalogEntry *findCatalogEntry(const char *tableName) {
+	CatalogEntry *entry = catalog[catalogBucket(tableName)];
+	while (entry != NULL && strcmp(entry->tableName, tableName) != 0) {
+		entry = entry->next;
+	}
+	return entry;
+}
+
+// takes an entry out of the catalog and frees it. Call with tablesLock held.
+static void removeCatalogEntry(CatalogEntry *entry) {
+	CatalogEntry **link = &catalog[catalogBucket(entry->tableName)];
+	while (*link != entry) {
+		link = &(*link)->next;
+	}
+	*link = entry->next;
+	freeCatalogEntry(entry);
+}
+
+/**
+ * Description:
+ * Adds a table to the catalog in memory, replacing an entry of the same name. The entry takes
+ * over `encodedSchema`, which is freed if it can not be added. Call with tablesLock held.
+ *
+ * @return RC_OK with the entry in `added`, or RC_MEMORY_ALLOCATION_ERROR.
+ */
+static RC addCatalogEntry(const char *tableName, int nameLength, const char *fileName, int fileLength,
+		char *encodedSchema, int encodedLength, CatalogEntry **added) {
+	CatalogEntry *entry = calloc(1, sizeof(CatalogEntry));
+	if (entry == NULL) {
+		free(encodedSchema);
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	entry->encodedSchema = encodedSchema;
+	entry->encodedLength = encodedLength;
+	entry->tableName = strndup(tableName, nameLength);
+	entry->fileName = strndup(fileName, fileLength);
+	if (entry->tableName == NULL || entry->fileName == NULL) {
+		freeCatalogEntry(entry);
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+
+	CatalogEntry *replaced = findCatalogEntry(entry->tableName);
+	if (replaced != NULL) {
+		removeCatalogEntry(replaced);
+	}
+
+	unsigned int bucket = catalogBucket(entry->tableName);
+	entry->next = catalog[bucket];
+	catalog[bucket] = entry;
+
+	if (added != NULL) {
+		*added = entry;
+	}
+	return RC_OK;
+}
+
+// drops the catalog in memory. Call with tablesLock held and no table open.
+static void clearCatalog(void) {
+	for (int i = 0; i < CATALOG_BUCKETS; i++) {
+		while (catalog[i] != NULL) {
+			CatalogEntry *next = catalog[i]->next;
+			freeCatalogEntry(catalog[i]);
+			catalog[i] = next;
+		}
+	}
+}
+
+/**
+ * Description:
+ * Reads the catalog into memory, unless it was read already. No catalog file is an empty catalog.
+ * Call with tablesLock held.
+ *
+ * @return RC_OK, RC_RM_INVALID_CATALOG or RC_MEMORY_ALLOCATION_ERROR.
+ */
+static RC loadCatalog(void) {
+	if (catalogLoaded) {
+		return RC_OK;
+	}
+
+	FILE *in = fopen(CATALOG_FILE, "rb");
+	if (in == NULL) {
+		catalogLoaded = true;
+		return RC_OK;
+	}
+
+	long size = -1;
+	if (fseek(in, 0, SEEK_END) == 0) {
+		size = ftell(in);
+		rewind(in);
+	}
+	char *contents = size >= 0 ? malloc(size > 0 ? size : 1) : NULL;
+	RC rc = contents != NULL && fread(contents, 1, size, in) == (size_t) size ? RC_OK : RC_RM_INVALID_CATALOG;
+	fclose(in);
+
+	const char *next = contents, *end = contents + (size > 0 ? size : 0);
+	unsigned int version;
+	if (rc == RC_OK && (size < (long) strlen(CATALOG_MAGIC) || memcmp(contents, CATALOG_MAGIC, strlen(CATALOG_MAGIC)) != 0)) {
+		rc = RC_RM_INVALID_CATALOG;
+	}
+	if (rc == RC_OK) {
+		next += strlen(CATALOG_MAGIC);
+		if (!getVarint(&next, end, &version) || version != CATALOG_VERSION) {
+			rc = RC_RM_INVALID_CATALOG;
+		}
+	}
+
+	while (rc == RC_OK && next < end) {
+		const char *tableName, *fileName, *schema;
+		unsigned int nameLength, fileLength, schemaLength;
+
+		if (!getBytes(&next, end, &tableName, &nameLength) || !getBytes(&next, end, &fileName, &fileLength)
+				|| !getBytes(&next, end, &schema, &schemaLength)) {
+			rc = RC_RM_INVALID_CATALOG;
+			break;
+		}
+
+		char *encodedSchema = malloc(schemaLength > 0 ? schemaLength : 1);
+		if (encodedSchema == NULL) {
+			rc = RC_MEMORY_ALLOCATION_ERROR;
+			break;
+		}
+		memcpy(encodedSchema, schema, schemaLength);
+		rc = addCatalogEntry(tableName, nameLength, fileName, fileLength, encodedSchema, schemaLength, NULL);
+	}
+	free(contents);
+
+	if (rc != RC_OK) {
+		DB_LOG_ERROR("The catalog %s can not be read, RC %d", CATALOG_FILE, rc);
+		clearCatalog();
+		return rc;
+	}
+
+	catalogLoaded = true;
+	return RC_OK;
+}
+
+// writes a varint length and `length` bytes to the catalog file
+static void writeCatalogBytes(FILE *out, const char *bytes, unsigned int length) {
+	char prefix[5];
+	fwrite(prefix, 1, putVarint(prefix, length) - prefix, out);
+	fwrite(bytes, 1, length, out);
+}
+
+/**
+ * Description:
+ * Writes the catalog in memory to CATALOG_FILE, through a temporary file renamed over it.
+ * Call with tablesLock held.
+ *
+ * @return RC_OK or RC_WRITE_FAILED.
+ */
+static RC saveCatalog(void) {
+	FILE *out = fopen(CATALOG_FILE ".tmp", "wb");
+	if (out == NULL) {
+		return RC_WRITE_FAILED;
+	}
+
+	char version[5];
+	fwrite(CATALOG_MAGIC, 1, strlen(CATALOG_MAGIC), out);
+	fwrite(version, 1, putVarint(version, CATALOG_VERSION) - version, out);
+
+	for (int i = 0; i < CATALOG_BUCKETS; i++) {
+		for (CatalogEntry *entry = catalog[i]; entry != NULL; entry = entry->next) {
+			writeCatalogBytes(out, entry->tableName, strlen(entry->tableName));
+			writeCatalogBytes(out, entry->fileName, strlen(entry->fileName));
+			writeCatalogBytes(out, entry->encodedSchema, entry->encodedLength);
+		}
+	}
+
+	bool written = !ferror(out);
+	written = fclose(out) == 0 && written;
+	if (written) {
+		written = rename(CATALOG_FILE ".tmp", CATALOG_FILE) == 0;
+	}
+	if (!written) {
+		remove(CATALOG_FILE ".tmp");
+		return RC_WRITE_FAILED;
+	}
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Adds a table to the catalog, or replaces its entry, and writes the catalog.
+ * Call with tablesLock held.
+ *
+ * @return RC_OK with the entry in `added` if it is not NULL, RC_MEMORY_ALLOCATION_ERROR or
+ * RC_WRITE_FAILED.
+ */
+static RC registerTable(const char *tableName, const char *fileName, Schema *schema, CatalogEntry **added) {
+	int encodedLength;
+	char *encodedSchema = encodeSchema(schema, &encodedLength);
+	if (encodedSchema == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+
+	RC rc = addCatalogEntry(tableName, strlen(tableName), fileName, strlen(fileName), encodedSchema, encodedLength, added);
+	if (rc != RC_OK) {
+		return rc;
+	}
+	return saveCatalog();
+}
+
+/**
+ * Description:
+ * Adds a table created before there was a catalog to the catalog, with the schema stored on its
+ * page 0. Page 0 does not keep which attributes are the key. Call with tablesLock held.
+ *
+ * @return RC_OK with the entry in `added`, RC_RM_INVALID_CATALOG if page 0 of the table expects
+ * its schema in the catalog, or the error of reading the page.
+ */
+static RC adoptTable(char *tableName, CatalogEntry **added) {
+	SM_FileHandle fileHandle;
+	char header[PAGE_SIZE];
+
+	// RC openPageFile (char *fileName, SM_FileHandle *fHandle)
+	RC rc = openPageFile(tableName, &fileHandle);
+	if (rc != RC_OK) {
+		return rc;
+	}
+	// RC readBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
+	rc = readBlock(0, &fileHandle, header);
+	closePageFile(&fileHandle);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	// the counters come first, then the number of attributes, the key size and the attributes
+	int *counters = (int *) header;
+	int numAttr = counters[3];
+	if (numAttr == SCHEMA_IN_CATALOG || numAttr < 0 || numAttr > PAGE_SIZE / (SIZE_OF_ATTRIBUTE + 2 * (int) sizeof(int))) {
+		return RC_RM_INVALID_CATALOG;
+	}
+
+	Schema *schema = allocateSchema(numAttr, 0);
+	if (schema == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	schema->keySize = counters[4];
+
+	char *attribute = (char *) &counters[5];
+	for (int i = 0; i < numAttr; i++) {
+		schema->attrNames[i] = calloc(SIZE_OF_ATTRIBUTE + 1, 1);
+		if (schema->attrNames[i] == NULL) {
+			freeSchemaFully(schema);
+			return RC_MEMORY_ALLOCATION_ERROR;
+		}
+		strncpy(schema->attrNames[i], attribute, SIZE_OF_ATTRIBUTE);
+		attribute = attribute + SIZE_OF_ATTRIBUTE;
+
+		schema->dataTypes[i] = *(int *) attribute;
+		attribute = attribute + sizeof(int);
+
+		schema->typeLength[i] = *(int *) attribute;
+		attribute = attribute + sizeof(int);
+	}
+
+	rc = registerTable(tableName, tableName, schema, added);
+	freeSchemaFully(schema);
+	return rc;
+}
+
+// frees the state of a table that was closed, its pages are written to its file first
+static void releaseTable(RecordManagement *table) {
+	if (table->buffer.mgmtData != NULL) {
+		shutdownBufferPool(&table->buffer);
+	}
+	free(table);
+}
+
+/**
+ * Description:
+ * Sets up the state of a table that is not open: opens its file on the shared pool and reads its
+ * counters from page 0. Its schema is decoded and its layout worked out on its first open only.
+ * Call with tablesLock held.
+ *
+ * @return RC_OK with the state in `table`, or the error of opening the table.
+ */
+static RC loadTable(CatalogEntry *entry, RecordManagement **table) {
+	BM_SharedPool *sharedPool;
+	RC rc = RC_OK;
+
+	if (entry->schema == NULL) {
+		rc = decodeSchema(entry->encodedSchema, entry->encodedLength, &entry->schema);
+		if (rc != RC_OK) {
+			return rc;
+		}
+	}
+	if (entry->layout == NULL) {
+		entry->layout = createLayout(entry->schema);
+		if (entry->layout == NULL) {
+			return RC_MEMORY_ALLOCATION_ERROR;
+		}
+	}
+
+	RecordManagement *loaded = calloc(1, sizeof(RecordManagement));
+	if (loaded == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	loaded->entry = entry;
+	loaded->schema = entry->schema;
+	loaded->layout = entry->layout;
+
+	// all tables and indexes share one pool, so its frames go to whichever of them is in use
+	// RC openSharedBufferPool(BM_BufferPool *const bm, BM_SharedPool *pool, const char *const pageFileName, int quota)
+	rc = getGlobalSharedPool(&sharedPool);
+	if (rc == RC_OK) {
+		rc = openSharedBufferPool(&loaded->buffer, sharedPool, entry->fileName, 0);
+	}
+	if (rc != RC_OK) {
+		loaded->buffer.mgmtData = NULL;
+		releaseTable(loaded);
+		return rc;
+	}
+
+	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
+	rc = pinPage(&loaded->buffer, &loaded->pHandler, 0);
+	if (rc != RC_OK) {
+		releaseTable(loaded);
+		return rc;
+	}
+
+	// number of tuples, first page that may have a free slot, pages of the table
+	int *counters = (int *) loaded->pHandler.data;
+	loaded->tupleCount = counters[0];
+	loaded->freeCount = counters[1];
+	loaded->numPages = counters[2];
+
+	// RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page)
+	unpinPage(&loaded->buffer, &loaded->pHandler);
+
+	*table = loaded;
+	return RC_OK;
+}
 
 /* ============================== table and manager ========================== */
 
 /**
  * @author : Deneshwara Sai Ila
- * @details : The function `initRecordManager` initializes the storage manager and prints a message indicating the
- * completion of the initialization process.
+ * @details : The function `initRecordManager` initializes the storage manager and reads the catalog of tables,
+ * then prints a message indicating the completion of the initialization process.
  * 
  * @param mgmtData : The `mgmtData` parameter is a pointer to any information that may be needed for managing records.
  * 
- * @return RC_OK
+ * @return RC_OK, or RC_RM_INVALID_CATALOG if the catalog file can not be read.
  */
 RC initRecordManager (void *mgmtData) {
 	initStorageManager();
-	printf("\nInitialization of storage manager is done here\n");
-	return RC_OK;
+	DB_LOG_INFO("Initialization of storage manager is done here");
+
+	pthread_mutex_lock(&tablesLock);
+	RC rc = loadCatalog();
+	pthread_mutex_unlock(&tablesLock);
+
+	return rc;
 }
 
 /**
  * @author : Prudhvi Teja Kari
- * @details : The function `shutdownRecordManager` deallocates memory for the storage manager and prints a message
- * indicating the shutdown process is complete.
+ * @details : The function `shutdownRecordManager` closes the tables that are still open, drops the
+ * catalog from memory and prints a message indicating the shutdown process is complete.
  * 
  * @return RC_OK
  */
 RC shutdownRecordManager () {
-	manager = NULL;
-	free(manager);
-	printf("\nShutting down storage manager is done here\n");
+	pthread_mutex_lock(&tablesLock);
+
+	// tables still open are closed
+	for (int i = 0; i < CATALOG_BUCKETS; i++) {
+		for (CatalogEntry *entry = catalog[i]; entry != NULL; entry = entry->next) {
+			if (entry->table != NULL) {
+				releaseTable(entry->table);
+				entry->table = NULL;
+			}
+		}
+	}
+
+	clearCatalog();
+	catalogLoaded = false;
+
+	pthread_mutex_unlock(&tablesLock);
+
+	DB_LOG_INFO("Shutting down storage manager is done here");
 	return RC_OK;
 }
 
 /**
  * @author : Deneshwara Sai Ila
- * @details : The `createTable` function creates a table with the specified name and schema, storing the schema
- * information in a newly created page file.
+ * @details : The `createTable` function creates a table with the specified name and schema, storing its
+ * counters in a newly created page file and its schema in the catalog. A table of the same name that is
+ * not open is replaced.
  * 
  * @param name : The `name` parameter is a character pointer that represents the name of the table being opened. 
  * 
@@ -100,169 +855,175 @@ RC shutdownRecordManager () {
  * 
  * @return The function `createTable` is returning an `RC` (Return Code) value. 
  * If block of code execution is successful, it will return `RC_OK`. 
- * else returns the repective error code.
+ * else returns the repective error code, RC_INVALID_TABLE_NAME for an empty name, RC_RM_TABLE_IN_USE
+ * if the table is open.
  */
 RC createTable (char *name, Schema *schema) {
 	int output;
 	char data[PAGE_SIZE];
 	char *pHandler = data;
-	int i = 0;
 	SM_FileHandle fileHandle;
 
-	manager = (RecordManagement *) malloc(sizeof(RecordManagement));
+	if (name == NULL || name[0] == '\0') {
+		return RC_INVALID_TABLE_NAME;
+	}
 
-	// initBufferPool(BM_BufferPool *const bm, const char *const pageFileName, const int numPages, ReplacementStrategy strategy, void *stratData)
-	initBufferPool(&manager->buffer, name, MAXIMUM_PAGES, RS_LRU, NULL);
+	memset(data, 0, PAGE_SIZE);
 
+	// number of tuples, first page that may have a free slot, pages of the table
 	*(int*)pHandler = 0;
 	pHandler = pHandler + sizeof(int);
 
 	*(int*)pHandler = 1;
 	pHandler = pHandler + sizeof(int);
 
-	*(int*)pHandler = schema->numAttr;
-	pHandler = pHandler + sizeof(int);
-
-	*(int*)pHandler = schema->keySize;
+	*(int*)pHandler = 1;
 	pHandler = pHandler + sizeof(int);
 
-	while (i < schema->numAttr) {
-		strncpy(pHandler, schema->attrNames[i], SIZE_OF_ATTRIBUTE);
-		pHandler = pHandler + SIZE_OF_ATTRIBUTE;
-
-		*(int*)pHandler = (int)schema->dataTypes[i];
-		pHandler = pHandler + sizeof(int);
+	// where tables from before the catalog have their schema, so they are not mistaken for one
+	*(int*)pHandler = SCHEMA_IN_CATALOG;
 
-		*(int*)pHandler = (int) schema->typeLength[i];
-		pHandler = pHandler + sizeof(int);
+	pthread_mutex_lock(&tablesLock);
 
-		i++;
+	// an open table keeps its file, so it is not replaced underneath
+	output = loadCatalog();
+	if (output == RC_OK) {
+		CatalogEntry *entry = findCatalogEntry(name);
+		if (entry != NULL && entry->table != NULL) {
+			output = RC_RM_TABLE_IN_USE;
+		}
 	}
 
 	// createPageFile (char *fileName)
-	output = createPageFile(name);
-	if (output != RC_OK)
-		return output;
+	if (output == RC_OK)
+		output = createPageFile(name);
 
 	// RC openPageFile (char *fileName, SM_FileHandle *fHandle)
-	output = openPageFile(name, &fileHandle);
-	if(output != RC_OK)
-		return output;
+	if (output == RC_OK)
+		output = openPageFile(name, &fileHandle);
 
 	// writeBlock (int pageNum, SM_FileHandle *fHandle, SM_PageHandle memPage)
-	output = writeBlock(0, &fileHandle, data);
-	if(output != RC_OK)
-		return output;
+	if (output == RC_OK) {
+		output = writeBlock(0, &fileHandle, data);
 
-	// RC closePageFile (SM_FileHandle *fHandle)
-	output = closePageFile(&fileHandle);
-	if(output != RC_OK)
-		return output;
+		// RC closePageFile (SM_FileHandle *fHandle)
+		RC closed = closePageFile(&fileHandle);
+		output = output == RC_OK ? closed : output;
+	}
 
-	return RC_OK;
+	if (output == RC_OK)
+		output = registerTable(name, name, schema, NULL);
+
+	pthread_mutex_unlock(&tablesLock);
+	return output;
 }
 
 /**
  * @author : Prudhvi Teja Kari
  * @details : The function `openTable` reads table information from a buffer manager and initializes the table
- * data structure accordingly.
+ * data structure accordingly. A table that is open already is shared with the other RM_TableData it
+ * was opened through, its schema included, so opening it is one lookup in the catalog; each
+ * openTable needs its closeTable.
  * 
  * @param rel : `rel` is a pointer to the `RM_TableData` structure, which contains information about the
  * table such as schema and management data.
  * @param name : The `name` parameter is a character pointer that represents the name of the table being opened. 
  * 
- * @return RC_OK
+ * @return RC_OK, or the error of reading the catalog or page 0 of the table.
  */
 RC openTable (RM_TableData *rel, char *name) {
-	int count, i = 0;
-	Schema *schema;
-	SM_PageHandle pHandler;
-	
-	schema = (Schema*) malloc(sizeof(Schema));
-
-	rel->name = name;
-	rel->mgmtData = manager;
-
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&manager->buffer, &manager->pHandler, 0);
-
-	pHandler = (char*) manager->pHandler.data;
-
-	manager->tupleCount = *(int*)pHandler;
-	pHandler = pHandler + sizeof(int);
-
-	manager->freeCount= *(int*) pHandler;
-    pHandler = pHandler + sizeof(int);
-
-    count = *(int*)pHandler;
-	pHandler = pHandler + sizeof(int);
-
-	schema->attrNames = (char**) malloc(sizeof(char*) *count);
-	schema->typeLength = (int*) malloc(sizeof(int) *count);
-	schema->dataTypes = (DataType*) malloc(sizeof(DataType) *count);
-	schema->numAttr = count;
-	rel->schema = schema;
-
-	i=0;
-	while (i < count) {
-		schema->attrNames[i]= (char*) malloc(SIZE_OF_ATTRIBUTE);
-		i++;
+	pthread_mutex_lock(&tablesLock);
+
+	// a table that is open already is shared, otherwise it is set up and kept with its entry
+	CatalogEntry *entry = NULL;
+	RC rc = loadCatalog();
+	if (rc == RC_OK) {
+		entry = findCatalogEntry(name);
+		if (entry == NULL) {
+			rc = adoptTable(name, &entry);
+		}
 	}
-
-	i=0;
-	while (i<schema->numAttr) {
-		strncpy(schema->attrNames[i], pHandler, SIZE_OF_ATTRIBUTE);
-		pHandler = pHandler + SIZE_OF_ATTRIBUTE;
-
-		schema->dataTypes[i]= *(int*) pHandler;
-		pHandler = pHandler + sizeof(int);
-
-		schema->typeLength[i]= *(int*)pHandler;
-		pHandler = pHandler + sizeof(int);
-		
-		i++;
+	if (rc == RC_OK && entry->table == NULL) {
+		rc = loadTable(entry, &entry->table);
 	}
 
-	// rel->schema = schema;
+	RecordManagement *table = rc == RC_OK ? entry->table : NULL;
 
-	// RC unpinPage (BM_BufferPool *const bm, BM_PageHandle *const page)
-	unpinPage(&manager->buffer, &manager->pHandler);
-
-	// RC forcePage (BM_BufferPool *const bm, BM_PageHandle *const page)
-	forcePage(&manager->buffer, &manager->pHandler);
+	if (rc == RC_OK) {
+		table->openCount++;
+		rel->name = name;
+		rel->mgmtData = table;
+		rel->schema = table->schema;
+	}
 
-	return RC_OK;
+	pthread_mutex_unlock(&tablesLock);
+	return rc;
 }
 
 /**
  * @author : Deneshwara Sai Ila
- * @details : The closeTable function closes a table by shutting down the buffer pool.
+ * @details : The closeTable function closes a table. The last close of a table shuts down its buffer
+ * pool, which writes its pages to its file. Its schema stays in the catalog for the next open.
  * 
  * @param rel : `rel` is a pointer to the `RM_TableData` structure, which contains information about the
  * table such as schema and management data.
  * 
- * @return RC_OK
+ * @return RC_OK, or RC_TABLE_DATA_NOT_FOUND if `rel` is not open.
  */
 
 RC closeTable (RM_TableData *rel) {
-	RecordManagement * recordManagement = rel->mgmtData;
-	shutdownBufferPool(&recordManagement->buffer);
+	RecordManagement *recordManagement = rel->mgmtData;
+	if (recordManagement == NULL) {
+		return RC_TABLE_DATA_NOT_FOUND;
+	}
+	rel->mgmtData = NULL;
+
+	pthread_mutex_lock(&tablesLock);
+
+	// the last close takes the table off its catalog entry
+	recordManagement->openCount--;
+	if (recordManagement->openCount == 0) {
+		recordManagement->entry->table = NULL;
+		releaseTable(recordManagement);
+	}
+
+	pthread_mutex_unlock(&tablesLock);
 	return RC_OK;
 }
 
 /**
  * @author : Prudhvi Teja Kari
- * @details : The function `deleteTable` deletes a table by destroying its page file.
+ * @details : The function `deleteTable` deletes a table by destroying its page file and removing it
+ * from the catalog.
  * 
  * @param name The `name` parameter in the `deleteTable` function is a pointer to a character array
  * that represents the name of the table to be deleted.
  * 
- * @return returns an `RC` (Return Code) value, specifically `RC_OK`.
+ * @return returns an `RC` (Return Code) value, `RC_OK`, RC_RM_TABLE_IN_USE if the table is open, or the
+ * error of writing the catalog.
  */
 
 RC deleteTable (char *name) {
-	destroyPageFile(name);
-	return RC_OK;
+	pthread_mutex_lock(&tablesLock);
+
+	RC rc = loadCatalog();
+	CatalogEntry *entry = rc == RC_OK ? findCatalogEntry(name) : NULL;
+	if (entry != NULL && entry->table != NULL) {
+		rc = RC_RM_TABLE_IN_USE;
+	}
+
+	if (rc == RC_OK) {
+		if (entry != NULL) {
+			destroyPageFile(entry->fileName);
+			removeCatalogEntry(entry);
+			rc = saveCatalog();
+		} else {
+			destroyPageFile(name);
+		}
+	}
+
+	pthread_mutex_unlock(&tablesLock);
+	return rc;
 }
 
 /**
@@ -286,10 +1047,10 @@ int getNumTuples (RM_TableData *rel) {
 /**
  * @author : Deneshwara Sai Ila
  * @details : The insertRecord function inserts a record into a table by 
- * 1) finding a free available slot in a page, 
- * 2) marking the page as dirty, 
- * 3) copying the record data into the slot, and 
- * 4) updating the tuple count.
+ * 1) encoding it with its strings unpadded, moving strings too long for a page to overflow pages, 
+ * 2) finding a page with room for it through the table's free-space map, 
+ * 3) copying the encoded record onto the page and giving it a slot, and 
+ * 4) updating the tuple count, the counters on page 0 and the page's free-space map entry.
  * 
  * @param rel : `rel` is a pointer to the `RM_TableData` structure, which contains information about the
  * table such as schema and management data.
@@ -299,53 +1060,165 @@ int getNumTuples (RM_TableData *rel) {
  * @return this function returns an error code of `RC_OK` upon successful completion.
  */
 RC insertRecord (RM_TableData *rel, Record *record) {
-	int recordSize = getRecordSize(rel->schema);
-	char *dataPtr, *inSlotPtr;
 	RecordManagement *recordManagement = rel->mgmtData;
-	RID *rids = &record->id;
+	char stored[PAGE_SIZE];
+	int length;
 
-	rids->page = recordManagement->freeCount;
-	
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&recordManagement->buffer, &recordManagement->pHandler, rids->page);
+	RC rc = encodeRecord(recordManagement, record->data, stored, &length);
+	if (rc != RC_OK) {
+		return rc;
+	}
 
-	dataPtr = recordManagement->pHandler.data;
-	rids->slot = findFreeSlot(dataPtr, recordSize);
+	rc = placeRecord(recordManagement, stored, length, &record->id);
+	if (rc != RC_OK) {
+		freeOverflowValues(recordManagement, stored);
+		return rc;
+	}
 
-	while(rids->slot == -1) {
-		unpinPage(&recordManagement->buffer, &recordManagement->pHandler);
-		rids->page++;
+	recordManagement->tupleCount++;
+	writeTableCounters(recordManagement);
 
-		pinPage(&recordManagement->buffer, &recordManagement->pHandler, rids->page);
-		dataPtr = recordManagement->pHandler.data;
+	return RC_OK;
+}
 
-		rids->slot = findFreeSlot(dataPtr, recordSize);
-	}
+/**
+ * Description:
+ * Inserts `n` records like n calls of insertRecord, but fills each page it picks with as many of
+ * them as fit under one pin and one latch. Past the end of the table it takes up to
+ * BULK_EXTENT_PAGES new pages at once, which the buffer pool appends to the file together
+ * without reading them. The tuple count and page 0 are updated once for the whole batch.
+ *
+ * @param rel the table.
+ * @param records the records to insert, their ids are set.
+ * @param n number of records.
+ * @param rids receives the id of each record, may be NULL.
+ *
+ * @return RC_OK, or the error of the record that could not be inserted. The records before it
+ * are inserted.
+ */
+RC insertRecords (RM_TableData *rel, Record **records, int n, RID *rids) {
+	RecordManagement *recordManagement = rel->mgmtData;
+	BM_PageHandle extent[BULK_EXTENT_PAGES];
+	PageNumber extentPages[BULK_EXTENT_PAGES];
+	char stored[PAGE_SIZE];
+	int length = 0, inserted = 0, skipTo = 0;
+	bool encoded = false;
+	RC rc = RC_OK;
+
+	while (inserted < n && rc == RC_OK) {
+		if (!encoded) {
+			rc = encodeRecord(recordManagement, records[inserted]->data, stored, &length);
+			if (rc != RC_OK) {
+				break;
+			}
+			encoded = true;
+		}
 
-	inSlotPtr = dataPtr;
+		int pageNum;
+		int from = recordManagement->freeCount > skipTo ? recordManagement->freeCount : skipTo;
+		rc = findPageWithRoom(recordManagement, from, fullestFitting(length), &pageNum);
+		if (rc != RC_OK) {
+			break;
+		}
 
-	// RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
-	markDirty(&recordManagement->buffer, &recordManagement->pHandler);
+		// past the end of the table, as many new pages as the rest of the records look to need
+		int numExtent = 1;
+		extentPages[0] = pageNum;
+		if (pageNum >= recordManagement->numPages) {
+			long wanted = (long) (n - inserted) * (length + sizeof(SlotEntry)) / (PAGE_SIZE - sizeof(DataPageHeader)) + 1;
+			while (numExtent < wanted && numExtent < BULK_EXTENT_PAGES) {
+				int nextPage = extentPages[numExtent - 1] + 1;
+				extentPages[numExtent++] = isFsmPage(nextPage) ? nextPage + 1 : nextPage;
+			}
+		}
 
-	inSlotPtr = inSlotPtr + (rids->slot * recordSize);
-	*inSlotPtr = '+';
+		// RC pinPages (BM_BufferPool *const bm, BM_PageHandle *const pages, const PageNumber *pageNums, int n)
+		rc = pinPages(&recordManagement->buffer, extent, extentPages, numExtent);
+		if (rc == RC_PINNED_PAGES_IN_BUFFER && numExtent > 1) {
+			numExtent = 1;
+			rc = pinPages(&recordManagement->buffer, extent, extentPages, numExtent);
+		}
+		if (rc != RC_OK) {
+			break;
+		}
+		// the extent belongs to the table now, so overflow pages go after it
+		if (extentPages[numExtent - 1] >= recordManagement->numPages) {
+			recordManagement->numPages = extentPages[numExtent - 1] + 1;
+		}
 
-	memcpy(++inSlotPtr, (record->data + 1), (recordSize - 1));
+		for (int e = 0; e < numExtent; e++) {
+			char *page = extent[e].data;
+			DataPageHeader *header = (DataPageHeader *) page;
+			int filled = 0;
 
-	// RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-	unpinPage(&recordManagement->buffer, &recordManagement->pHandler);
+			// pages of the extent that are not needed stay empty data pages
+			if (inserted == n || rc != RC_OK) {
+				unpinPage(&recordManagement->buffer, &extent[e]);
+				continue;
+			}
 
-	recordManagement->tupleCount++;
+			latchPage(&recordManagement->buffer, &extent[e], BM_LATCH_EXCLUSIVE);
+			FsmCategory before = fsmCategoryOf(page);
+			if (header->kind == DATA_PAGE && header->dataOffset == 0) {
+				initDataPage(page);
+			}
 
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&recordManagement->buffer, &recordManagement->pHandler, 0);
+			while (inserted < n) {
+				if (!encoded) {
+					rc = encodeRecord(recordManagement, records[inserted]->data, stored, &length);
+					if (rc != RC_OK) {
+						break;
+					}
+					encoded = true;
+				}
+
+				int slot = header->kind == DATA_PAGE ? pageInsert(page, stored, length) : -1;
+				if (slot == -1) {
+					break;
+				}
+				records[inserted]->id.page = extentPages[e];
+				records[inserted]->id.slot = slot;
+				if (rids != NULL) {
+					rids[inserted] = records[inserted]->id;
+				}
+				inserted++;
+				encoded = false;
+				filled++;
+			}
 
-	return RC_OK;
+			FsmCategory after = fsmCategoryOf(page);
+			unlatchPage(&recordManagement->buffer, &extent[e], BM_LATCH_EXCLUSIVE);
+			if (filled > 0) {
+				markDirty(&recordManagement->buffer, &extent[e]);
+			}
+			unpinPage(&recordManagement->buffer, &extent[e]);
+
+			// a page that took nothing may have had a map entry that was behind it, the record
+			// is looked for a place after it
+			if (after != before || filled == 0) {
+				setFsmCategory(recordManagement, extentPages[e], after);
+			}
+			skipTo = filled == 0 && rc == RC_OK ? extentPages[e] + 1 : 0;
+			if (after == FSM_FULL && extentPages[e] == recordManagement->freeCount) {
+				recordManagement->freeCount++;
+			}
+		}
+	}
+
+	if (encoded) {
+		freeOverflowValues(recordManagement, stored);
+	}
+
+	recordManagement->tupleCount += inserted;
+	writeTableCounters(recordManagement);
+
+	return rc;
 }
 
 /**
  * @author : Prudhvi Teja Kari
- * @details : The deleteRecord function deletes a record from a table by marking it as deleted in the buffer pool.
+ * @details : The deleteRecord function deletes a record from a table by freeing its slot and its bytes on the page,
+ * so the next insert into the page can take them again, and the overflow pages of its values.
  * 
  * @param rel : `rel` is a pointer to the `RM_TableData` structure, which contains information about the
  * table such as schema and management data.
@@ -355,31 +1228,40 @@ RC insertRecord (RM_TableData *rel, Record *record) {
  * @return This function returns an `RC` (Return Code) value, specifically `RC_OK`.
  */
 RC deleteRecord (RM_TableData *rel, RID id) {
-
-	int recSize = getRecordSize(rel->schema);
 	RecordManagement * recordManagement = rel->mgmtData;
+	char stored[PAGE_SIZE];
+	int length;
 
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&recordManagement->buffer, &recordManagement->pHandler, id.page);
-
-	recordManagement->freeCount = id.page;
-
-	char *dataPtr = recordManagement->pHandler.data;
-	dataPtr = dataPtr + (id.slot * recSize);
-	*dataPtr = '-';
+	RC rc = readStoredRecord(recordManagement, id, stored, &length);
+	if (rc != RC_OK) {
+		return rc;
+	}
+	if (stored[0] == STORED_MOVED) {
+		return RC_RM_NO_TUPLE_WITH_GIVEN_RID;
+	}
 
-	// RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
-	markDirty(&recordManagement->buffer, &recordManagement->pHandler);
+	// a moved record goes with its stub
+	if (stored[0] == STORED_FORWARD) {
+		RID target = forwardTarget(stored);
+		if (readStoredRecord(recordManagement, target, stored, &length) == RC_OK) {
+			freeOverflowValues(recordManagement, stored);
+			removeStoredRecord(recordManagement, target);
+		}
+	} else {
+		freeOverflowValues(recordManagement, stored);
+	}
+	removeStoredRecord(recordManagement, id);
 
-	// RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-	unpinPage(&recordManagement->buffer, &recordManagement->pHandler);
+	recordManagement->tupleCount--;
+	writeTableCounters(recordManagement);
 
 	return RC_OK;
 }
 
 /**
  * @author : Prudhvi Teja Kari
- * @details : Updates a record in the specified table by modifying data on disk.
+ * @details : Updates a record in the specified table by modifying data on disk. A record that no longer fits
+ * its page moves to another one and leaves a forwarding stub behind, so its RID does not change.
  * 
  * @param rel : `rel` is a pointer to the `RM_TableData` structure, which contains information about the
  * table such as schema and management data.
@@ -389,25 +1271,70 @@ RC deleteRecord (RM_TableData *rel, RID id) {
  * @return RC_OK on success, error code otherwise.
  */
 RC updateRecord (RM_TableData *rel, Record *record) {
-	char *dataPtr;
 	RecordManagement *recordManagement = rel->mgmtData;
-	int recSize = getRecordSize(rel->schema);
-	RID rids = record->id;
+	RID home = record->id, target = record->id, moved;
+	char stored[PAGE_SIZE], updated[PAGE_SIZE];
+	int length, updatedLength;
+	BM_PageHandle handle;
+	FsmCategory before;
+
+	RC rc = readStoredRecord(recordManagement, home, stored, &length);
+	if (rc != RC_OK) {
+		return rc;
+	}
+	if (stored[0] == STORED_MOVED) {
+		return RC_RM_NO_TUPLE_WITH_GIVEN_RID;
+	}
+	if (stored[0] == STORED_FORWARD) {
+		target = forwardTarget(stored);
+		rc = readStoredRecord(recordManagement, target, stored, &length);
+		if (rc != RC_OK) {
+			return rc;
+		}
+	}
 
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&recordManagement->buffer, &recordManagement->pHandler, record->id.page);
+	rc = encodeRecord(recordManagement, record->data, updated, &updatedLength);
+	if (rc != RC_OK) {
+		return rc;
+	}
+	updated[0] = (target.page == home.page && target.slot == home.slot) ? STORED_RECORD : STORED_MOVED;
 
-	dataPtr = recordManagement->pHandler.data;
-	dataPtr = dataPtr + (rids.slot * recSize);
-	*dataPtr = '+';
+	// the record stays where it is if its page has the room
+	rc = beginPageChange(recordManagement, target.page, &handle, &before);
+	if (rc != RC_OK) {
+		freeOverflowValues(recordManagement, updated);
+		return rc;
+	}
+	bool fits = isSlotUsed(handle.data, target.slot) && pageReplace(handle.data, target.slot, updated, updatedLength);
+	endPageChange(recordManagement, &handle, before);
+
+	// otherwise it moves and its home slot forwards to it
+	if (!fits) {
+		updated[0] = STORED_MOVED;
+		rc = placeRecord(recordManagement, updated, updatedLength, &moved);
+		if (rc != RC_OK) {
+			freeOverflowValues(recordManagement, updated);
+			return rc;
+		}
+		if (target.page != home.page || target.slot != home.slot) {
+			removeStoredRecord(recordManagement, target);
+		}
 
-	memcpy(++dataPtr, (record->data + 1), (recSize - 1));
+		char stub[FORWARD_SIZE];
+		stub[0] = STORED_FORWARD;
+		memcpy(stub + 1, &moved.page, sizeof(int));
+		memcpy(stub + 1 + sizeof(int), &moved.slot, sizeof(int));
 
-	// RC markDirty(BM_BufferPool *const bm, BM_PageHandle *const page)
-	markDirty(&recordManagement->buffer, &recordManagement->pHandler);
+		rc = beginPageChange(recordManagement, home.page, &handle, &before);
+		if (rc != RC_OK) {
+			return rc;
+		}
+		pageReplace(handle.data, home.slot, stub, FORWARD_SIZE);
+		endPageChange(recordManagement, &handle, before);
+	}
 
-	// RC unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-	unpinPage(&recordManagement->buffer, &recordManagement->pHandler);
+	freeOverflowValues(recordManagement, stored);
+	writeTableCounters(recordManagement);
 
 	return RC_OK;
 }
@@ -423,33 +1350,469 @@ RC updateRecord (RM_TableData *rel, Record *record) {
  * @param record : The `record` parameter in the `getRecord` function is a pointer to a `Record` struct
  * where the retrieved record data will be stored. 
  * 
+ * The slot is read optimistically: instead of latching the page, the copy is validated against
+ * the page version afterwards and simply repeated if a writer got in between.
+ *
  * @return RC (Return Code) 
  * 1) If the record is successfully retrieved, it returns RC_OK. 
  * 2) If there is no tuple with the given RID (Record ID), it returns RC_RM_NO_TUPLE_WITH_GIVEN_RID.
  */
 RC getRecord (RM_TableData *rel, RID id, Record *record) {
-	int recSize = getRecordSize(rel->schema);
 	RecordManagement *recordManagement = rel->mgmtData;
+	char stored[PAGE_SIZE];
+	int length;
+
+	RC rc = readStoredRecord(recordManagement, id, stored, &length);
+	if (rc == RC_OK && stored[0] == STORED_FORWARD) {
+		rc = readStoredRecord(recordManagement, forwardTarget(stored), stored, &length);
+	} else if (rc == RC_OK && stored[0] == STORED_MOVED) {
+		rc = RC_RM_NO_TUPLE_WITH_GIVEN_RID;
+	}
+
+	if(rc != RC_OK) {
+		return rc;
+	}
+
+	rc = decodeRecord(recordManagement, stored, record->data);
+	if (rc == RC_OK) {
+		record->id = id;
+	}
+
+	return rc;
+}
+
+/* ======================= LOADING TABLES FROM CSV FILES ===================== */
+
+/*
+ * loadTableFromCSV maps the file and cuts it into chunks of about chunkBytes bytes, a line
+ * belonging to the chunk its first byte is in. Parser threads take the chunks in order and turn
+ * their lines into records. The calling thread is the only writer: it inserts the chunks with
+ * insertRecords in the order of the file as they become ready, so the rows fill the table's pages
+ * in that order. Chunk i is parsed into slot i % numSlots and the slot is only reused once the
+ * chunk is inserted, which bounds how far the parsers get ahead of the writer.
+ */
+
+#define LOAD_CHUNK_BYTES (4 * 1024 * 1024) // default chunk size
+#define LOAD_SLOTS_PER_THREAD 2
+#define LOAD_NUMBER_LENGTH 64 // longest int, float or bool field
+
+typedef struct LoadChunk {
+	long number;      // chunk the slot is for, the parsers wait for their slot to get to their chunk
+	bool parsed;
+	RC rc;            // RC_OK, or why the line after the last record could not be parsed
+	long errorOffset; // byte of the file that line starts at
+	int numRecords;
+	int capacity;     // records the buffers have room for
+	char *data;       // the records, getRecordSize bytes each
+	Record *records;
+	Record **recordPtrs;
+} LoadChunk;
+
+typedef struct CsvLoad {
+	RM_LoadOptions options;
+	Schema *schema;
+	const char *file;
+	long fileSize;
+	long numChunks;
+	int recordSize;
+	int *attrOffsets; // of the table's layout
+	int fieldLength; // longest field a parser has to hold
+
+	pthread_mutex_t lock;
+	pthread_cond_t changed;
+	long nextChunk; // next chunk a parser takes
+	bool stop;      // the writer gave up, parsers quit
+	int numSlots;
+	LoadChunk *slots;
+} CsvLoad;
+
+// first byte of the first line that starts in chunk `number`, the file size past the last chunk
+static long chunkStart(CsvLoad *load, long number) {
+	long position = number * load->options.chunkBytes;
+	if (number == 0 || position >= load->fileSize) {
+		return position < load->fileSize ? position : load->fileSize;
+	}
+
+	const char *newline = memchr(load->file + position - 1, '\n', load->fileSize - position + 1);
+	return newline != NULL ? newline - load->file + 1 : load->fileSize;
+}
+
+/**
+ * Description:
+ * Cuts the next field off the line at `*position`, which ends at `end`, and unquotes it into
+ * `field`. A field in double quotes may hold the delimiter and "" for a quote, but no line break.
+ *
+ * @return RC_OK with `*position` after the field, or RC_RM_CSV_PARSE_ERROR if the field is longer
+ * than `maxLength` or its quotes are not closed.
+ */
+static RC nextCsvField(const char **position, const char *end, char delimiter, char *field, int maxLength, int *length) {
+	const char *next = *position;
+	int n = 0;
+
+	if (next < end && *next == '"') {
+		for (next++; ; next++) {
+			if (next == end) {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			if (*next == '"') {
+				if (next + 1 < end && next[1] == '"') {
+					next++;
+				} else {
+					next++;
+					break;
+				}
+			}
+			if (n == maxLength) {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			field[n++] = *next;
+		}
+		if (next < end && *next != delimiter) {
+			return RC_RM_CSV_PARSE_ERROR;
+		}
+	} else {
+		for (; next < end && *next != delimiter; next++) {
+			if (n == maxLength) {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			field[n++] = *next;
+		}
+	}
+
+	field[n] = '\0';
+	*length = n;
+	*position = next;
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Stores a field in its attribute of a record, typed like stringToValue types values: a bool is
+ * true if it starts with 't', 'T' or '1' and false if it starts with 'f', 'F' or '0'.
+ *
+ * @return RC_OK, or RC_RM_CSV_PARSE_ERROR if the field is no value of the attribute's type.
+ */
+static RC storeCsvField(CsvLoad *load, char *record, int attrNum, const char *field, int length) {
+	char *data = record + load->attrOffsets[attrNum];
+	char *rest;
+
+	switch (load->schema->dataTypes[attrNum]) {
+		case DT_INT: {
+			errno = 0;
+			long intValue = strtol(field, &rest, 10);
+			if (length == 0 || *rest != '\0' || errno != 0 || intValue < INT_MIN || intValue > INT_MAX) {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			int value = (int) intValue;
+			memcpy(data, &value, sizeof(int));
+			return RC_OK;
+		}
+
+		case DT_FLOAT: {
+			float value = strtof(field, &rest);
+			if (length == 0 || *rest != '\0') {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			memcpy(data, &value, sizeof(float));
+			return RC_OK;
+		}
+
+		case DT_BOOL: {
+			bool value;
+			if (field[0] == 't' || field[0] == 'T' || field[0] == '1') {
+				value = TRUE;
+			} else if (field[0] == 'f' || field[0] == 'F' || field[0] == '0') {
+				value = FALSE;
+			} else {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			memcpy(data, &value, sizeof(bool));
+			return RC_OK;
+		}
+
+		case DT_STRING:
+			if (length > load->schema->typeLength[attrNum]) {
+				return RC_RM_CSV_PARSE_ERROR;
+			}
+			memcpy(data, field, length);
+			return RC_OK;
+	}
+	return RC_RM_CSV_PARSE_ERROR;
+}
+
+// makes room for twice as many records in a chunk
+static RC growChunk(CsvLoad *load, LoadChunk *chunk) {
+	int capacity = chunk->capacity > 0 ? chunk->capacity * 2 : 1024;
+
+	char *data = realloc(chunk->data, (size_t) capacity * load->recordSize);
+	if (data == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	chunk->data = data;
+
+	Record *records = realloc(chunk->records, sizeof(Record) * capacity);
+	if (records == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	chunk->records = records;
+
+	Record **recordPtrs = realloc(chunk->recordPtrs, sizeof(Record *) * capacity);
+	if (recordPtrs == NULL) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	chunk->recordPtrs = recordPtrs;
+
+	chunk->capacity = capacity;
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Parses the lines of chunk `number` into records in its slot, one record per line. Empty lines
+ * are skipped, as is the header line when the file has one. Parsing stops at the first line that
+ * does not fit the schema, with the records before it kept.
+ */
+static void parseChunk(CsvLoad *load, long number, LoadChunk *chunk, char *field) {
+	const char *line = load->file + chunkStart(load, number);
+	const char *chunkEnd = load->file + chunkStart(load, number + 1);
+	char delimiter = load->options.delimiter;
+
+	chunk->numRecords = 0;
+	chunk->rc = RC_OK;
+
+	if (number == 0 && load->options.hasHeader) {
+		const char *newline = memchr(line, '\n', chunkEnd - line);
+		line = newline != NULL ? newline + 1 : chunkEnd;
+	}
+
+	for (const char *next = line; line < chunkEnd; line = next) {
+		const char *end = memchr(line, '\n', chunkEnd - line);
+		next = end != NULL ? end + 1 : chunkEnd;
+		end = end != NULL ? end : chunkEnd;
+		if (end > line && end[-1] == '\r') {
+			end--;
+		}
+		if (end == line) {
+			continue;
+		}
+
+		if (chunk->numRecords == chunk->capacity) {
+			chunk->rc = growChunk(load, chunk);
+			if (chunk->rc != RC_OK) {
+				break;
+			}
+		}
+		char *record = chunk->data + (size_t) chunk->numRecords * load->recordSize;
+		memset(record, 0, load->recordSize);
+		record[0] = '-';
+
+		const char *position = line;
+		for (int i = 0; i < load->schema->numAttr && chunk->rc == RC_OK; i++) {
+			int length;
+			chunk->rc = nextCsvField(&position, end, delimiter, field, load->fieldLength, &length);
+			if (chunk->rc == RC_OK) {
+				chunk->rc = storeCsvField(load, record, i, field, length);
+			}
+			// a delimiter follows every field but the last, which ends the line
+			bool isLast = i == load->schema->numAttr - 1;
+			if (chunk->rc == RC_OK && (isLast ? position != end : position == end)) {
+				chunk->rc = RC_RM_CSV_PARSE_ERROR;
+			}
+			position++;
+		}
+		if (chunk->rc != RC_OK) {
+			chunk->errorOffset = line - load->file;
+			break;
+		}
+		chunk->numRecords++;
+	}
+
+	for (int i = 0; i < chunk->numRecords; i++) {
+		chunk->records[i].id.page = -1;
+		chunk->records[i].id.slot = -1;
+		chunk->records[i].data = chunk->data + (size_t) i * load->recordSize;
+		chunk->recordPtrs[i] = &chunk->records[i];
+	}
+}
+
+// parser thread of loadTableFromCSV
+static void *csvParser(void *arg) {
+	CsvLoad *load = arg;
+	char *field = malloc(load->fieldLength + 1);
+
+	pthread_mutex_lock(&load->lock);
+	while (!load->stop && load->nextChunk < load->numChunks) {
+		long number = load->nextChunk++;
+		LoadChunk *chunk = &load->slots[number % load->numSlots];
+
+		// the slot gets to this chunk once the writer inserted the one before it in the slot
+		while (!load->stop && chunk->number != number) {
+			pthread_cond_wait(&load->changed, &load->lock);
+		}
+		if (load->stop) {
+			break;
+		}
+		pthread_mutex_unlock(&load->lock);
+
+		if (field != NULL) {
+			parseChunk(load, number, chunk, field);
+		} else {
+			chunk->numRecords = 0;
+			chunk->rc = RC_MEMORY_ALLOCATION_ERROR;
+		}
+
+		pthread_mutex_lock(&load->lock);
+		chunk->parsed = true;
+		pthread_cond_broadcast(&load->changed);
+	}
+	pthread_mutex_unlock(&load->lock);
+
+	free(field);
+	return NULL;
+}
+
+/**
+ * Description:
+ * Appends the rows of the CSV file `path` to a table, one record per line, the fields in the
+ * order of the schema's attributes. The file is parsed by several threads while the calling
+ * thread inserts the rows with insertRecords, in the order of the file. Unless
+ * `options->deferFlush` is set the table's pages are written to its file after each chunk,
+ * so a load that fails keeps the rows before the chunk; with it they are written once at the end.
+ *
+ * @param rel the table.
+ * @param path the CSV file.
+ * @param options how to read the file, NULL for DEFAULT_LOAD_OPTIONS.
+ *
+ * @return RC_OK, RC_FILE_NOT_FOUND, RC_RM_CSV_PARSE_ERROR for a line that does not fit the schema
+ * (its position is logged), or the error of inserting or writing the rows. The rows before the
+ * failing one are in the table.
+ */
+RC loadTableFromCSV (RM_TableData *rel, char *path, const RM_LoadOptions *options) {
+	RecordManagement *recordManagement = rel->mgmtData;
+	CsvLoad load;
+	struct stat fileInfo;
+	RC rc = RC_OK;
+
+	load.options = options != NULL ? *options : DEFAULT_LOAD_OPTIONS;
+	if (load.options.chunkBytes <= 0) {
+		load.options.chunkBytes = LOAD_CHUNK_BYTES;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return RC_FILE_NOT_FOUND;
+	}
+	if (fstat(fd, &fileInfo) < 0) {
+		close(fd);
+		return RC_FILE_NOT_FOUND;
+	}
+	if (fileInfo.st_size == 0) {
+		close(fd);
+		return RC_OK;
+	}
+
+	void *file = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (file == MAP_FAILED) {
+		return RC_MEMORY_ALLOCATION_ERROR;
+	}
+	madvise(file, fileInfo.st_size, MADV_SEQUENTIAL);
+
+	load.schema = rel->schema;
+	load.file = file;
+	load.fileSize = fileInfo.st_size;
+	load.numChunks = (load.fileSize + load.options.chunkBytes - 1) / load.options.chunkBytes;
+	load.recordSize = recordManagement->layout->recordSize;
+	load.attrOffsets = recordManagement->layout->offsets;
+	load.fieldLength = LOAD_NUMBER_LENGTH;
+	for (int i = 0; i < rel->schema->numAttr; i++) {
+		if (rel->schema->dataTypes[i] == DT_STRING && rel->schema->typeLength[i] > load.fieldLength) {
+			load.fieldLength = rel->schema->typeLength[i];
+		}
+	}
+
+	int numThreads = load.options.numThreads > 0 ? load.options.numThreads : (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if (numThreads < 1) {
+		numThreads = 1;
+	}
+	if (numThreads > load.numChunks) {
+		numThreads = (int) load.numChunks;
+	}
+
+	pthread_mutex_init(&load.lock, NULL);
+	pthread_cond_init(&load.changed, NULL);
+	load.nextChunk = 0;
+	load.stop = false;
+	load.numSlots = numThreads * LOAD_SLOTS_PER_THREAD;
+	load.slots = calloc(load.numSlots, sizeof(LoadChunk));
+	pthread_t *parsers = malloc(sizeof(pthread_t) * numThreads);
+
+	int numStarted = 0;
+	if (load.slots == NULL || parsers == NULL) {
+		rc = RC_MEMORY_ALLOCATION_ERROR;
+	} else {
+		for (int i = 0; i < load.numSlots; i++) {
+			load.slots[i].number = i;
+		}
+		while (numStarted < numThreads && pthread_create(&parsers[numStarted], NULL, csvParser, &load) == 0) {
+			numStarted++;
+		}
+		if (numStarted == 0) {
+			rc = RC_MEMORY_ALLOCATION_ERROR;
+		}
+	}
 
-	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-	pinPage(&recordManagement->buffer, &recordManagement->pHandler, id.page);
+	for (long number = 0; number < load.numChunks && rc == RC_OK; number++) {
+		LoadChunk *chunk = &load.slots[number % load.numSlots];
 
-	char *actualData = recordManagement->pHandler.data;
-	actualData = actualData + (id.slot * recSize);
+		pthread_mutex_lock(&load.lock);
+		while (!(chunk->number == number && chunk->parsed)) {
+			pthread_cond_wait(&load.changed, &load.lock);
+		}
+		pthread_mutex_unlock(&load.lock);
 
-	if(*actualData != '+') {
-		return RC_RM_NO_TUPLE_WITH_GIVEN_RID;
-	} else {
-		record->id = id;
+		if (chunk->numRecords > 0) {
+			rc = insertRecords(rel, chunk->recordPtrs, chunk->numRecords, NULL);
+		}
+		if (rc == RC_OK) {
+			rc = chunk->rc;
+			if (rc == RC_RM_CSV_PARSE_ERROR) {
+				DB_LOG_ERROR("%s: the line at byte %ld does not fit the schema of the table", path, chunk->errorOffset);
+			}
+		}
+		if (rc == RC_OK && !load.options.deferFlush) {
+			// RC forceFlushPool(BM_BufferPool *const bm)
+			rc = forceFlushPool(&recordManagement->buffer);
+		}
 
-		char *dataPtr = record->data;
-		memcpy(++dataPtr, (actualData + 1), (recSize - 1));
+		pthread_mutex_lock(&load.lock);
+		chunk->number = number + load.numSlots;
+		chunk->parsed = false;
+		load.stop = rc != RC_OK;
+		pthread_cond_broadcast(&load.changed);
+		pthread_mutex_unlock(&load.lock);
 	}
 
-	// Unpin the page after the record is retrieved since the page is no longer required to be in memory
-	unpinPage(&recordManagement->buffer, &recordManagement->pHandler);
+	if (load.options.deferFlush) {
+		RC flushed = forceFlushPool(&recordManagement->buffer);
+		rc = rc == RC_OK ? flushed : rc;
+	}
 
-	return RC_OK;
+	for (int i = 0; i < numStarted; i++) {
+		pthread_join(parsers[i], NULL);
+	}
+	for (int i = 0; load.slots != NULL && i < load.numSlots; i++) {
+		free(load.slots[i].data);
+		free(load.slots[i].records);
+		free(load.slots[i].recordPtrs);
+	}
+	free(load.slots);
+	free(parsers);
+	pthread_cond_destroy(&load.changed);
+	pthread_mutex_destroy(&load.lock);
+	munmap(file, fileInfo.st_size);
+
+	return rc;
 }
 
 /* ======================= SCANS ===================== */
@@ -480,9 +1843,6 @@ RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond) {
 	RecordManagement * scanManagement;
 	RecordManagement * tableManagement;
 
-	// RC openTable(RM_TableData *rel, char *name)
-	openTable(rel, "TableScaning");
-
 	scanManagement = (RecordManagement *) malloc (sizeof(RecordManagement));
 
 	scanManagement->scanCount = 0;
@@ -493,6 +1853,13 @@ RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond) {
 
 	tableManagement = rel->mgmtData;
 
+	// a scan reads the table through a small ring of frames and leaves the rest of the pool alone
+	RC rc = createAccessRing(&tableManagement->buffer, BM_ACCESS_BULK_READ, &scanManagement->accessRing);
+	if (rc != RC_OK) {
+		free(scanManagement);
+		return rc;
+	}
+
 	scan->rel = rel;
 	scan->mgmtData = scanManagement; 
 
@@ -502,7 +1869,8 @@ RC startScan (RM_TableData *rel, RM_ScanHandle *scan, Expr *cond) {
 /**
  * @author : Prudhvi Teja Kari
  * @details : The function `next` iterates through records in a table based on a scan condition and returns the
- * next record that satisfies the condition.
+ * next record that satisfies the condition. Only the used slots of the data pages are read, and a moved record
+ * is read through its forwarding stub.
  * 
  * @param scan : The `scan` parameter contains information about a scan operation in a record manager.
  * @param record : The `record` parameter is a part of Record Struct.
@@ -521,62 +1889,77 @@ RC next (RM_ScanHandle *scan, Record *record) {
 	}
 
 	RecordManagement *tableManager = scan->rel->mgmtData;
-    Schema *schema = scan->rel->schema;
-	char *actualData;
-	Value *result = (Value *) malloc(sizeof(Value));
-	int scanCount = scanManager->scanCount;
-	int tuplesCount = tableManager->tupleCount;
-	int recordSize = getRecordSize(schema);
-	int totalSlots = PAGE_SIZE / recordSize;
-	char *dataPointer = record->data;
-
-	if (tuplesCount == 0)
+	Schema *schema = scan->rel->schema;
+	Value *result;
+	char forwarded[PAGE_SIZE];
+	int length;
+
+	if (tableManager->tupleCount == 0)
 		return RC_RM_NO_MORE_TUPLES;
 
-	while(scanCount <= tuplesCount) {
+	while (scanManager->recordId.page < tableManager->numPages) {
 
-		if (scanCount > 0) {
-			scanManager->recordId.slot++;
+		if (isFsmPage(scanManager->recordId.page)) {
+			scanManager->recordId.page++;
+			continue;
+		}
 
-			if(scanManager->recordId.slot >= totalSlots) {
-				scanManager->recordId.slot = 0;
-				scanManager->recordId.page++;
-			}
-		} else {
-			scanManager->recordId.page = 1;
-			scanManager->recordId.slot = 0;
+		// pinPageWithStrategy(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum, BM_AccessRing *ring)
+		RC rc = pinPageWithStrategy(&tableManager->buffer, &scanManager->pHandler, scanManager->recordId.page, scanManager->accessRing);
+		if (rc != RC_OK) {
+			return rc;
 		}
 
-		// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
-		pinPage(&tableManager->buffer, &scanManager->pHandler, scanManager->recordId.page);
+		char *page = scanManager->pHandler.data;
 
-		record->id.page = scanManager->recordId.page;
-		record->id.slot = scanManager->recordId.slot;
+		// only the used slots of a data page are looked at
+		int slot;
+		while ((slot = nextLiveSlot(page, scanManager->recordId.slot)) != -1) {
+			scanManager->recordId.slot = slot + 1;
 
-		actualData = scanManager->pHandler.data;
-		actualData = actualData + (scanManager->recordId.slot * recordSize);
+			char *stored = page + slotEntry(page, slot)->offset;
 
-		*dataPointer = '-';
+			// a moved record is returned at its stub, under the RID it was inserted with
+			if (stored[0] == STORED_MOVED) {
+				continue;
+			}
+			if (stored[0] == STORED_FORWARD) {
+				if (readStoredRecord(tableManager, forwardTarget(stored), forwarded, &length) != RC_OK) {
+					continue;
+				}
+				stored = forwarded;
+			}
+			scanManager->scanCount++;
 
-		scanManager->scanCount++;
-		scanCount++;
+			record->data[0] = '-';
+			rc = decodeRecord(tableManager, stored, record->data);
+			if (rc != RC_OK) {
+				unpinPage(&tableManager->buffer, &scanManager->pHandler);
+				return rc;
+			}
 
-		memcpy(++dataPointer, (actualData + 1), (recordSize - 1));
+			// evalExpr(Record *record, Schema *schema, Expr *expr, Value **result)
+			evalExpr(record, schema, scanManager->constraint, &result);
+			bool matches = result->v.boolV == TRUE;
+			freeVal(result);
 
-		// evalExpr(Record *record, Schema *schema, Expr *expr, Value **result)
-		evalExpr(record, schema, scanManager->constraint, &result);
+			if (matches) {
+				record->id.page = scanManager->recordId.page;
+				record->id.slot = slot;
 
-		if(result->v.boolV == TRUE) {
+				// unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+				unpinPage(&tableManager->buffer, &scanManager->pHandler);
 
-			// unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-			unpinPage(&tableManager->buffer, &scanManager->pHandler);
-			
-			return RC_OK;
+				return RC_OK;
+			}
 		}
-	}
 
-	// unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-	unpinPage(&tableManager->buffer, &scanManager->pHandler);
+		// unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
+		unpinPage(&tableManager->buffer, &scanManager->pHandler);
+
+		scanManager->recordId.page++;
+		scanManager->recordId.slot = 0;
+	}
 
 	scanManager->recordId.page = 1;
 	scanManager->scanCount = 0;
@@ -596,24 +1979,17 @@ RC next (RM_ScanHandle *scan, Record *record) {
 RC closeScan (RM_ScanHandle *scan) {
 
 	if (scan == NULL) {
-		printf("The RM_ScanHandle is null");
+		DB_LOG_ERROR("The RM_ScanHandle is null");
 		exit(-1);
 	}
 
-	RecordManagement * recordManagement = scan->rel->mgmtData;
 	RecordManagement * scanManagement = scan->mgmtData;
 
-	if(scanManagement->scanCount > 0) {
-		scanManagement->recordId.slot = 0;
-		scanManagement->scanCount = 0;
-		scanManagement->recordId.page = 1;
-
-		// unpinPage(BM_BufferPool *const bm, BM_PageHandle *const page)
-		unpinPage(&recordManagement->buffer, &scanManagement->pHandler);
-	}
+	// next() unpins every page before it returns, so only the ring and the scan state are left to free
+	freeAccessRing(scanManagement->accessRing);
 
+	free(scanManagement);
 	scan->mgmtData = NULL;
-	free(scan->mgmtData);
 
 	return RC_OK;
 }
@@ -797,7 +2173,7 @@ RC getAttr (Record *record, Schema *schema, int attrNum, Value **value) {
 				break;
 
 		default:
-			printf("No such datatype under the desired datatype \n");
+			DB_LOG_ERROR("No such datatype under the desired datatype");
 			break;
 	}
 
@@ -849,7 +2225,7 @@ RC setAttr (Record *record, Schema *schema, int attrNum, Value *value) {
 					data = data + sizeof(bool);
 					break;
 		default:
-			printf("Serializer not defined for the given datatype. \n");
+			DB_LOG_ERROR("Serializer not defined for the given datatype.");
 			exit(0);
 	}
 	return RC_OK;
@@ -896,25 +2272,686 @@ RC attributeOffset (Schema *schema, int attributeNumber, int *output) {
 	return RC_OK;
 }
 
+// bytes an attribute takes in a Record
+static int attributeLength(Schema *schema, int attrNum) {
+	switch (schema->dataTypes[attrNum]) {
+		case DT_INT:
+			return sizeof(int);
+		case DT_FLOAT:
+			return sizeof(float);
+		case DT_BOOL:
+			return sizeof(bool);
+		case DT_STRING:
+			return schema->typeLength[attrNum];
+	}
+	return 0;
+}
+
+// sets up an empty data page
+static void initDataPage(char *page) {
+	DataPageHeader *header = (DataPageHeader *) page;
+
+	memset(header, 0, sizeof(DataPageHeader));
+	header->kind = DATA_PAGE;
+	header->freeSpaceOffset = sizeof(DataPageHeader);
+	header->dataOffset = PAGE_SIZE;
+	header->freeBytes = PAGE_SIZE - sizeof(DataPageHeader);
+}
+
+static SlotEntry *slotEntry(char *page, int slot) {
+	return (SlotEntry *) (page + sizeof(DataPageHeader)) + slot;
+}
+
+static bool isSlotUsed(char *page, int slot) {
+	DataPageHeader *header = (DataPageHeader *) page;
+	if (header->kind != DATA_PAGE || slot < 0 || slot >= header->numSlots) {
+		return false;
+	}
+	return (header->usedSlots[slot / 64] >> (slot % 64)) & 1;
+}
+
+// the first slot from `from` on whose bit in the used slots bitmap is `used`, numSlots if there is none
+static int findSlot(DataPageHeader *header, int from, bool used) {
+	for (int word = from / 64; word * 64 < header->numSlots; word++) {
+		uint64_t bits = used ? header->usedSlots[word] : ~header->usedSlots[word];
+		if (word == from / 64) {
+			bits &= ~0UL << (from % 64);
+		}
+		if (bits != 0) {
+			int slot = word * 64 + __builtin_ctzll(bits);
+			return slot < header->numSlots ? slot : header->numSlots;
+		}
+	}
+	return header->numSlots;
+}
+
+// moves the records of a page together at its end, so its free bytes are in one piece
+static void compactPage(char *page) {
+	DataPageHeader *header = (DataPageHeader *) page;
+	char copy[PAGE_SIZE];
+	int offset = PAGE_SIZE;
+
+	memcpy(copy, page, PAGE_SIZE);
+	for (int slot = 0; slot < header->numSlots; slot++) {
+		SlotEntry *entry = slotEntry(page, slot);
+		if (entry->length != 0) {
+			offset -= entry->length;
+			memcpy(page + offset, copy + entry->offset, entry->length);
+			entry->offset = offset;
+		}
+	}
+	header->dataOffset = offset;
+}
+
 /**
- * @author : Prudhvi Teja Kari
- * @details: The function `findFreeSlot` searches for the first available free slot in a character data array based on a record size.
- * 
- * @param data The `data` parameter is a pointer to the beginning of a memory block where records are
- * stored. 
- * @param recordSize Record size is the size of each record in bytes. It is used to calculate the total
- * number of slots that can fit in a page.
- * 
- * @return The function `findFreeSlot` returns the index of the first free slot in the data array.
+ * Description:
+ * Stores a record of `length` bytes on a data page, in its lowest unused slot.
+ *
+ * @return the slot, -1 if the page does not have the room.
+ */
+static int pageInsert(char *page, const char *stored, int length) {
+	DataPageHeader *header = (DataPageHeader *) page;
+	int slot = header->firstFreeSlot;
+	int needed = length + (slot == header->numSlots ? sizeof(SlotEntry) : 0);
+
+	if (header->freeBytes < needed) {
+		return -1;
+	}
+	if (header->dataOffset - header->freeSpaceOffset < needed) {
+		compactPage(page);
+	}
+	if (slot == header->numSlots) {
+		header->numSlots++;
+		header->freeSpaceOffset += sizeof(SlotEntry);
+	}
+
+	header->dataOffset -= length;
+	memcpy(page + header->dataOffset, stored, length);
+	slotEntry(page, slot)->offset = header->dataOffset;
+	slotEntry(page, slot)->length = length;
+	header->usedSlots[slot / 64] |= 1UL << (slot % 64);
+	header->numLive++;
+	header->freeBytes -= needed;
+
+	header->firstFreeSlot = findSlot(header, slot + 1, false);
+	return slot;
+}
+
+/**
+ * Description:
+ * Replaces the record in a used slot by `length` other bytes, in place if they are no longer
+ * and elsewhere on the page otherwise.
+ *
+ * @return whether the page had the room.
+ */
+static bool pageReplace(char *page, int slot, const char *stored, int length) {
+	DataPageHeader *header = (DataPageHeader *) page;
+	SlotEntry *entry = slotEntry(page, slot);
+	int oldLength = entry->length;
+
+	if (length <= oldLength) {
+		memcpy(page + entry->offset, stored, length);
+		entry->length = length;
+		header->freeBytes += oldLength - length;
+		return true;
+	}
+	if (header->freeBytes + oldLength < length) {
+		return false;
+	}
+
+	// the old bytes are let go first, so compacting can reuse them
+	entry->length = 0;
+	header->freeBytes += oldLength;
+	if (header->dataOffset - header->freeSpaceOffset < length) {
+		compactPage(page);
+	}
+
+	header->dataOffset -= length;
+	memcpy(page + header->dataOffset, stored, length);
+	entry->offset = header->dataOffset;
+	entry->length = length;
+	header->freeBytes -= length;
+	return true;
+}
+
+// frees a used slot, and the whole page with its directory once its last record is gone
+static void pageRemove(char *page, int slot) {
+	DataPageHeader *header = (DataPageHeader *) page;
+	SlotEntry *entry = slotEntry(page, slot);
+
+	header->freeBytes += entry->length;
+	entry->length = 0;
+	header->usedSlots[slot / 64] &= ~(1UL << (slot % 64));
+	header->numLive--;
+	if (slot < header->firstFreeSlot) {
+		header->firstFreeSlot = slot;
+	}
+	if (header->numLive == 0) {
+		initDataPage(page);
+	}
+}
+
+// the first used slot from `from` on, -1 if there is none
+static int nextLiveSlot(char *page, int from) {
+	DataPageHeader *header = (DataPageHeader *) page;
+
+	if (header->kind != DATA_PAGE || from >= header->numSlots) {
+		return -1;
+	}
+	int slot = findSlot(header, from, true);
+	return slot < header->numSlots ? slot : -1;
+}
+
+// the RID a forwarding stub points to
+static RID forwardTarget(const char *stored) {
+	RID target;
+	memcpy(&target.page, stored + 1, sizeof(int));
+	memcpy(&target.slot, stored + 1 + sizeof(int), sizeof(int));
+	return target;
+}
+
+// a page number at the end of the table, for an overflow page
+static int allocatePage(RecordManagement *recordManagement) {
+	int pageNum = recordManagement->numPages;
+	if (isFsmPage(pageNum)) {
+		pageNum++;
+	}
+	recordManagement->numPages = pageNum + 1;
+	return pageNum;
+}
+
+/**
+ * Description:
+ * Writes a value to a chain of new overflow pages. They are marked full in the free-space map,
+ * so inserts leave them alone.
+ *
+ * @return RC_OK with the first page of the chain in `firstPage`, or the error of pinning a page.
  */
-int findFreeSlot(char *data, int recordSize) {
-	int i = 0, totalNoOfSlots = PAGE_SIZE / recordSize;
+static RC writeOverflowChain(RecordManagement *recordManagement, const char *value, int length, int *firstPage) {
+	BM_PageHandle handle;
+	int pageNum = allocatePage(recordManagement);
+
+	*firstPage = pageNum;
+	for (int written = 0; written < length; ) {
+		int chunk = length - written < OVERFLOW_CAPACITY ? length - written : OVERFLOW_CAPACITY;
+		int nextPage = written + chunk < length ? allocatePage(recordManagement) : NO_PAGE;
+
+		RC rc = pinPage(&recordManagement->buffer, &handle, pageNum);
+		if (rc != RC_OK) {
+			return rc;
+		}
+
+		latchPage(&recordManagement->buffer, &handle, BM_LATCH_EXCLUSIVE);
+		OverflowPageHeader *header = (OverflowPageHeader *) handle.data;
+		memset(handle.data, 0, PAGE_SIZE);
+		header->kind = OVERFLOW_PAGE;
+		header->nextPage = nextPage;
+		header->length = chunk;
+		memcpy(handle.data + sizeof(OverflowPageHeader), value + written, chunk);
+		unlatchPage(&recordManagement->buffer, &handle, BM_LATCH_EXCLUSIVE);
+
+		markDirty(&recordManagement->buffer, &handle);
+		unpinPage(&recordManagement->buffer, &handle);
+		setFsmCategory(recordManagement, pageNum, FSM_FULL);
+
+		written += chunk;
+		pageNum = nextPage;
+	}
+	return RC_OK;
+}
 
-	while(i < totalNoOfSlots) {
-		if (data[i * recordSize] != '+') {
-			return i;
+// reads `length` bytes of a value from the overflow chain that starts at `pageNum`
+static RC readOverflowChain(RecordManagement *recordManagement, int pageNum, int length, char *value) {
+	BM_PageHandle handle;
+
+	for (int copied = 0; copied < length; ) {
+		RC rc = pageNum == NO_PAGE ? RC_RM_BROKEN_OVERFLOW_CHAIN : pinPage(&recordManagement->buffer, &handle, pageNum);
+		if (rc != RC_OK) {
+			return rc;
 		}
-		i++;
+
+		OverflowPageHeader *header = (OverflowPageHeader *) handle.data;
+		int chunk = header->length < length - copied ? header->length : length - copied;
+		if (header->kind != OVERFLOW_PAGE || chunk <= 0 || chunk > OVERFLOW_CAPACITY) {
+			unpinPage(&recordManagement->buffer, &handle);
+			return RC_RM_BROKEN_OVERFLOW_CHAIN;
+		}
+		memcpy(value + copied, handle.data + sizeof(OverflowPageHeader), chunk);
+		pageNum = header->nextPage;
+
+		unpinPage(&recordManagement->buffer, &handle);
+		copied += chunk;
+	}
+	return RC_OK;
+}
+
+// turns the pages of an overflow chain back into empty data pages
+static void freeOverflowChain(RecordManagement *recordManagement, int pageNum) {
+	BM_PageHandle handle;
+
+	while (pageNum != NO_PAGE) {
+		if (pinPage(&recordManagement->buffer, &handle, pageNum) != RC_OK) {
+			return;
+		}
+
+		latchPage(&recordManagement->buffer, &handle, BM_LATCH_EXCLUSIVE);
+		OverflowPageHeader *header = (OverflowPageHeader *) handle.data;
+		int nextPage = header->kind == OVERFLOW_PAGE ? header->nextPage : NO_PAGE;
+		memset(handle.data, 0, PAGE_SIZE);
+		unlatchPage(&recordManagement->buffer, &handle, BM_LATCH_EXCLUSIVE);
+
+		markDirty(&recordManagement->buffer, &handle);
+		unpinPage(&recordManagement->buffer, &handle);
+		setFsmCategory(recordManagement, pageNum, FSM_EMPTY);
+		if (pageNum < recordManagement->freeCount) {
+			recordManagement->freeCount = pageNum;
+		}
+
+		pageNum = nextPage;
+	}
+}
+
+/**
+ * Description:
+ * Encodes the record `data` for a page, see the layout at the top of the file. While the record
+ * is longer than MAX_INLINE_RECORD, its longest string goes to an overflow chain. A record that
+ * is still longer has no strings left to move and is kept whole if it fits an empty page.
+ *
+ * @return RC_OK with the encoded length in `length`, RC_RM_RECORD_TOO_LARGE if the record is
+ * longer than MAX_RECORD_SIZE even so, or the error of writing an overflow chain.
+ */
+static RC encodeRecord(RecordManagement *recordManagement, char *data, char *stored, int *length) {
+	TableLayout *layout = recordManagement->layout;
+	int numAttr = layout->numAttr;
+	int *offsets = layout->offsets;
+	int lengths[numAttr];
+	bool overflows[numAttr];
+	int total = 1 + numAttr * sizeof(uint16_t);
+
+	for (int i = 0; i < numAttr; i++) {
+		lengths[i] = layout->lengths[i];
+		if (layout->isString[i]) {
+			lengths[i] = strnlen(data + offsets[i], layout->lengths[i]);
+		}
+		overflows[i] = false;
+		total += lengths[i];
+	}
+
+	while (total > MAX_INLINE_RECORD) {
+		int longest = -1;
+		for (int i = 0; i < numAttr; i++) {
+			if (layout->isString[i] && !overflows[i] && lengths[i] > OVERFLOW_POINTER_SIZE
+					&& (longest == -1 || lengths[i] > lengths[longest])) {
+				longest = i;
+			}
+		}
+		if (longest == -1) {
+			break;
+		}
+		overflows[longest] = true;
+		total -= lengths[longest] - OVERFLOW_POINTER_SIZE;
+	}
+	if (total > MAX_RECORD_SIZE) {
+		return RC_RM_RECORD_TOO_LARGE;
+	}
+
+	stored[0] = STORED_RECORD;
+	int position = 1 + numAttr * sizeof(uint16_t);
+
+	for (int i = 0; i < numAttr; i++) {
+		uint16_t end;
+
+		if (overflows[i]) {
+			int firstPage;
+			RC rc = writeOverflowChain(recordManagement, data + offsets[i], lengths[i], &firstPage);
+			if (rc != RC_OK) {
+				return rc;
+			}
+			memcpy(stored + position, &firstPage, sizeof(int));
+			memcpy(stored + position + sizeof(int), &lengths[i], sizeof(int));
+			position += OVERFLOW_POINTER_SIZE;
+			end = position | OVERFLOW_FLAG;
+		} else {
+			memcpy(stored + position, data + offsets[i], lengths[i]);
+			position += lengths[i];
+			end = position;
+		}
+		memcpy(stored + 1 + i * sizeof(uint16_t), &end, sizeof(uint16_t));
+	}
+
+	if (position < FORWARD_SIZE) {
+		memset(stored + position, 0, FORWARD_SIZE - position);
+		position = FORWARD_SIZE;
+	}
+	*length = position;
+	return RC_OK;
+}
+
+/**
+ * Description:
+ * Decodes a stored record into the attributes of a Record, `data`, padding its strings again.
+ * Leaves the tombstone byte data[0] alone.
+ *
+ * @return RC_OK, or the error of reading an overflow chain.
+ */
+static RC decodeRecord(RecordManagement *recordManagement, const char *stored, char *data) {
+	TableLayout *layout = recordManagement->layout;
+	int start = 1 + layout->numAttr * sizeof(uint16_t);
+
+	for (int i = 0; i < layout->numAttr; i++) {
+		int size = layout->lengths[i];
+		int offset = layout->offsets[i];
+		int valueLength;
+		uint16_t end;
+
+		memcpy(&end, stored + 1 + i * sizeof(uint16_t), sizeof(uint16_t));
+
+		if (end & OVERFLOW_FLAG) {
+			int firstPage;
+			memcpy(&firstPage, stored + start, sizeof(int));
+			memcpy(&valueLength, stored + start + sizeof(int), sizeof(int));
+			if (valueLength > size) {
+				return RC_RM_BROKEN_OVERFLOW_CHAIN;
+			}
+			RC rc = readOverflowChain(recordManagement, firstPage, valueLength, data + offset);
+			if (rc != RC_OK) {
+				return rc;
+			}
+		} else {
+			valueLength = (end - start) < size ? (end - start) : size;
+			memcpy(data + offset, stored + start, valueLength);
+		}
+		memset(data + offset + valueLength, 0, size - valueLength);
+
+		start = end & ~OVERFLOW_FLAG;
+	}
+	return RC_OK;
+}
+
+// frees the overflow chains of a stored record's values
+static void freeOverflowValues(RecordManagement *recordManagement, const char *stored) {
+	int numAttr = recordManagement->layout->numAttr;
+	int start = 1 + numAttr * sizeof(uint16_t);
+
+	if (stored[0] == STORED_FORWARD) {
+		return;
+	}
+	for (int i = 0; i < numAttr; i++) {
+		uint16_t end;
+		memcpy(&end, stored + 1 + i * sizeof(uint16_t), sizeof(uint16_t));
+
+		if (end & OVERFLOW_FLAG) {
+			int firstPage;
+			memcpy(&firstPage, stored + start, sizeof(int));
+			freeOverflowChain(recordManagement, firstPage);
+		}
+		start = end & ~OVERFLOW_FLAG;
+	}
+}
+
+/**
+ * Description:
+ * Copies the stored bytes of the record in slot `id` to `stored`. The page is read optimistically:
+ * the copy is validated against the page version and repeated if a writer got in between.
+ *
+ * @return RC_OK with the length in `length`, RC_RM_NO_TUPLE_WITH_GIVEN_RID if the slot is not
+ * used, or the error of pinning the page.
+ */
+static RC readStoredRecord(RecordManagement *recordManagement, RID id, char *stored, int *length) {
+	BM_PageHandle handle;
+	unsigned long version;
+	bool isUsed;
+
+	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
+	RC rc = pinPage(&recordManagement->buffer, &handle, id.page);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	do {
+		// unsigned long startOptimisticRead(BM_BufferPool *const bm, BM_PageHandle *const page)
+		version = startOptimisticRead(&recordManagement->buffer, &handle);
+
+		isUsed = isSlotUsed(handle.data, id.slot);
+		if (isUsed) {
+			SlotEntry entry = *slotEntry(handle.data, id.slot);
+			isUsed = entry.offset + entry.length <= PAGE_SIZE;
+			if (isUsed) {
+				memcpy(stored, handle.data + entry.offset, entry.length);
+				*length = entry.length;
+			}
+		}
+	} while (!validateOptimisticRead(&recordManagement->buffer, &handle, version));
+
+	unpinPage(&recordManagement->buffer, &handle);
+
+	return isUsed ? RC_OK : RC_RM_NO_TUPLE_WITH_GIVEN_RID;
+}
+
+// pins and latches a page to change it, remembering its free-space map category
+static RC beginPageChange(RecordManagement *recordManagement, int pageNum, BM_PageHandle *handle, FsmCategory *before) {
+	// pinPage(BM_BufferPool *const bm, BM_PageHandle *const page, const PageNumber pageNum)
+	RC rc = pinPage(&recordManagement->buffer, handle, pageNum);
+	if (rc != RC_OK) {
+		return rc;
+	}
+
+	latchPage(&recordManagement->buffer, handle, BM_LATCH_EXCLUSIVE);
+	*before = fsmCategoryOf(handle->data);
+	return RC_OK;
+}
+
+// releases a page changed after beginPageChange and brings the free-space map up to date
+static void endPageChange(RecordManagement *recordManagement, BM_PageHandle *handle, FsmCategory before) {
+	int pageNum = handle->pageNum;
+	FsmCategory after = fsmCategoryOf(handle->data);
+
+	unlatchPage(&recordManagement->buffer, handle, BM_LATCH_EXCLUSIVE);
+	markDirty(&recordManagement->buffer, handle);
+	unpinPage(&recordManagement->buffer, handle);
+
+	if (after != before) {
+		setFsmCategory(recordManagement, pageNum, after);
+	}
+	if (after != FSM_FULL && pageNum < recordManagement->freeCount) {
+		recordManagement->freeCount = pageNum;
+	}
+}
+
+/**
+ * Description:
+ * Stores an encoded record on a page with room for it, named by the free-space map. Pages before
+ * freeCount are full; records too long for a page with only some room skip those pages as well,
+ * and records too long for a roomy page go to an empty one.
+ *
+ * @return RC_OK with the record's RID in `id`, or the error of pinning a page.
+ */
+static RC placeRecord(RecordManagement *recordManagement, char *stored, int length, RID *id) {
+	FsmCategory fullest = fullestFitting(length);
+	int pageNum, from = recordManagement->freeCount;
+	BM_PageHandle handle;
+	FsmCategory before;
+
+	while (true) {
+		RC rc = findPageWithRoom(recordManagement, from, fullest, &pageNum);
+		if (rc == RC_OK) {
+			rc = beginPageChange(recordManagement, pageNum, &handle, &before);
+		}
+		if (rc != RC_OK) {
+			return rc;
+		}
+
+		DataPageHeader *header = (DataPageHeader *) handle.data;
+		if (header->kind == DATA_PAGE && header->dataOffset == 0) {
+			initDataPage(handle.data);
+		}
+		int slot = header->kind == DATA_PAGE ? pageInsert(handle.data, stored, length) : -1;
+		if (slot != -1) {
+			endPageChange(recordManagement, &handle, before);
+			id->page = pageNum;
+			id->slot = slot;
+			break;
+		}
+
+		// the map was behind the page, e.g. after a crash before the map was written
+		FsmCategory actual = fsmCategoryOf(handle.data);
+		unlatchPage(&recordManagement->buffer, &handle, BM_LATCH_EXCLUSIVE);
+		unpinPage(&recordManagement->buffer, &handle);
+		setFsmCategory(recordManagement, pageNum, actual);
+		from = pageNum + 1;
+	}
+
+	if (fullest == FSM_SOME_ROOM) {
+		recordManagement->freeCount = id->page;
+	}
+	if (id->page >= recordManagement->numPages) {
+		recordManagement->numPages = id->page + 1;
+	}
+	return RC_OK;
+}
+
+// frees the slot of a stored record
+static void removeStoredRecord(RecordManagement *recordManagement, RID id) {
+	BM_PageHandle handle;
+	FsmCategory before;
+
+	if (beginPageChange(recordManagement, id.page, &handle, &before) != RC_OK) {
+		return;
+	}
+	if (isSlotUsed(handle.data, id.slot)) {
+		pageRemove(handle.data, id.slot);
+	}
+	endPageChange(recordManagement, &handle, before);
+}
+
+/**
+ * Description:
+ * Writes the tuple count, the first page that may have a free slot and the number of pages of a
+ * table to its page 0, so openTable finds them again.
+ */
+static void writeTableCounters(RecordManagement *recordManagement) {
+	BM_PageHandle header;
+
+	if (pinPageWithPriority(&recordManagement->buffer, &header, 0, BM_PRIORITY_HIGH) != RC_OK) {
+		return;
+	}
+
+	latchPage(&recordManagement->buffer, &header, BM_LATCH_EXCLUSIVE);
+	int *counters = (int *) header.data;
+	counters[0] = recordManagement->tupleCount;
+	counters[1] = recordManagement->freeCount;
+	counters[2] = recordManagement->numPages;
+	unlatchPage(&recordManagement->buffer, &header, BM_LATCH_EXCLUSIVE);
+
+	markDirty(&recordManagement->buffer, &header);
+	unpinPage(&recordManagement->buffer, &header);
+}
+
+// whether `pageNum` is a free-space map page rather than a data page
+static bool isFsmPage(int pageNum) {
+	return pageNum >= 1 && (pageNum - 1) % (FSM_ENTRIES_PER_PAGE + 1) == 0;
+}
+
+// the free-space map page that has the entry of data page `pageNum`
+static int fsmPageOf(int pageNum) {
+	return 1 + (pageNum - 1) / (FSM_ENTRIES_PER_PAGE + 1) * (FSM_ENTRIES_PER_PAGE + 1);
+}
+
+static FsmCategory fsmCategoryOf(char *page) {
+	DataPageHeader *header = (DataPageHeader *) page;
+
+	if (header->kind != DATA_PAGE) {
+		return FSM_FULL;
+	}
+	if (header->numLive == 0) {
+		return FSM_EMPTY;
 	}
-	return -1;
+	if (header->freeBytes >= FSM_ROOMY_BYTES) {
+		return FSM_ROOMY;
+	}
+	return header->freeBytes >= FSM_SOME_ROOM_BYTES ? FSM_SOME_ROOM : FSM_FULL;
+}
+
+// the fullest free-space map category of a page that surely has room for a record of `length`
+static FsmCategory fullestFitting(int length) {
+	if (length + (int) sizeof(SlotEntry) <= FSM_SOME_ROOM_BYTES) {
+		return FSM_SOME_ROOM;
+	}
+	return length + (int) sizeof(SlotEntry) <= FSM_ROOMY_BYTES ? FSM_ROOMY : FSM_EMPTY;
+}
+
+/**
+ * Description:
+ * Looks up the first data page from `from` on whose free-space map entry is `fullest` or has
+ * more room. The entries are tested a word at a time: an entry is full when both of its bits are
+ * set, empty or roomy when its high bit is clear and empty when both are clear.
+ *
+ * @return RC_OK with the page in `pageNum`, or the error of pinning a map page.
+ */
+static RC findPageWithRoom(RecordManagement *recordManagement, int from, FsmCategory fullest, int *pageNum) {
+	const uint64_t lowBits = 0x5555555555555555UL;
+	BM_PageHandle fsm;
+
+	if (from < 2) {
+		from = 2;
+	}
+	if (isFsmPage(from)) {
+		from++;
+	}
+
+	for (int fsmPage = fsmPageOf(from); ; fsmPage += FSM_ENTRIES_PER_PAGE + 1) {
+		int entry = from > fsmPage ? from - fsmPage - 1 : 0;
+
+		RC rc = pinPageWithPriority(&recordManagement->buffer, &fsm, fsmPage, BM_PRIORITY_HIGH);
+		if (rc != RC_OK) {
+			return rc;
+		}
+
+		latchPage(&recordManagement->buffer, &fsm, BM_LATCH_SHARED);
+		uint64_t *words = (uint64_t *) fsm.data;
+		int found = -1;
+
+		for (int word = entry * FSM_BITS / 64; word < PAGE_SIZE / 8 && found == -1; word++) {
+			uint64_t fitting = ~(words[word] & (words[word] >> 1)) & lowBits;
+			if (fullest == FSM_ROOMY) {
+				fitting = ~(words[word] >> 1) & lowBits;
+			} else if (fullest == FSM_EMPTY) {
+				fitting = ~(words[word] | (words[word] >> 1)) & lowBits;
+			}
+			if (word == entry * FSM_BITS / 64) {
+				fitting &= ~0UL << (entry * FSM_BITS % 64);
+			}
+			if (fitting != 0) {
+				found = (word * 64 + __builtin_ctzll(fitting)) / FSM_BITS;
+			}
+		}
+
+		unlatchPage(&recordManagement->buffer, &fsm, BM_LATCH_SHARED);
+		unpinPage(&recordManagement->buffer, &fsm);
+
+		if (found != -1) {
+			*pageNum = fsmPage + 1 + found;
+			return RC_OK;
+		}
+	}
+}
+
+// sets the free-space map entry of data page `pageNum`
+static void setFsmCategory(RecordManagement *recordManagement, int pageNum, FsmCategory category) {
+	int fsmPage = fsmPageOf(pageNum);
+	int entry = pageNum - fsmPage - 1;
+	BM_PageHandle fsm;
+
+	if (pinPageWithPriority(&recordManagement->buffer, &fsm, fsmPage, BM_PRIORITY_HIGH) != RC_OK) {
+		return;
+	}
+
+	latchPage(&recordManagement->buffer, &fsm, BM_LATCH_EXCLUSIVE);
+	uint64_t *word = (uint64_t *) fsm.data + entry * FSM_BITS / 64;
+	int shift = entry * FSM_BITS % 64;
+	*word = (*word & ~(3UL << shift)) | ((uint64_t) category << shift);
+	unlatchPage(&recordManagement->buffer, &fsm, BM_LATCH_EXCLUSIVE);
+
+	markDirty(&recordManagement->buffer, &fsm);
+	unpinPage(&recordManagement->buffer, &fsm);
 }
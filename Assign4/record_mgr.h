@@ -12,6 +12,22 @@ typedef struct RM_ScanHandle
 	void *mgmtData;
 } RM_ScanHandle;
 
+// Options of loadTableFromCSV
+typedef struct RM_LoadOptions
+{
+	char delimiter;  // between the fields of a line
+	bool hasHeader;  // the first line names the columns and is skipped
+	int numThreads;  // threads parsing the file, 0 for one per CPU
+	int chunkBytes;  // bytes of the file a thread parses at a time, 0 for a default
+	bool deferFlush; // write the table's pages to its file only when the load is done, not after each chunk
+} RM_LoadOptions;
+
+#define DEFAULT_LOAD_OPTIONS ((RM_LoadOptions) { .delimiter = ',', .hasHeader = false, .numThreads = 0, \
+                                                 .chunkBytes = 0, .deferFlush = false })
+
+// most new pages insertRecords appends to a table at once
+#define BULK_EXTENT_PAGES 16
+
 // table and manager
 extern RC initRecordManager (void *mgmtData);
 extern RC shutdownRecordManager ();
@@ -23,6 +39,8 @@ extern int getNumTuples (RM_TableData *rel);
 
 // handling records in a table
 extern RC insertRecord (RM_TableData *rel, Record *record);
+extern RC insertRecords (RM_TableData *rel, Record **records, int n, RID *rids);
+extern RC loadTableFromCSV (RM_TableData *rel, char *path, const RM_LoadOptions *options);
 extern RC deleteRecord (RM_TableData *rel, RID id);
 extern RC updateRecord (RM_TableData *rel, Record *record);
 extern RC getRecord (RM_TableData *rel, RID id, Record *record);
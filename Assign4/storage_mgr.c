@@ -5,11 +5,18 @@
 #include<unistd.h>
 #include<string.h>
 #include<math.h>
+#include<fcntl.h>
+#include<errno.h>
+#include<sys/uio.h>
 
 #include "storage_mgr.h"
+#include "dblog.h"
 
 FILE *pageFile;
 
+#define WRITE_BATCH_PAGES 64 // pages handed to one pwritev() call by writeBlocks
+#define READ_BATCH_PAGES 64 // pages handed to one preadv() call by readBlocks
+
 /* manipulating page files */
 
 /**
@@ -20,7 +27,7 @@ FILE *pageFile;
  */
 
 void initStorageManager (void) {
-    printf("The storage manager has been initiated!");
+    DB_LOG_INFO("The storage manager has been initiated!");
     pageFile = NULL;
 }
 
@@ -48,9 +55,9 @@ RC createPageFile (char *fileName) {
     SM_PageHandle emptyPageHandler = (SM_PageHandle)calloc(PAGE_SIZE, sizeof(char));
     
     if(fwrite(emptyPageHandler, sizeof(char), PAGE_SIZE, pageFile) < PAGE_SIZE)
-        printf("The write operation got error! Please the logs.\n");
+        DB_LOG_ERROR("Writing the first page of %s failed.", fileName);
     else
-        printf("The write operation executed successfully.\n");
+        DB_LOG_DEBUG("Created page file %s.", fileName);
     
     fclose(pageFile);
     free(emptyPageHandler);
@@ -232,7 +239,7 @@ RC readFirstBlock (SM_FileHandle *fHandle, SM_PageHandle memPage) {
     } if (memPage == NULL) {
         return RC_WRITE_FAILED;
     }
-    printf("FILE NAME : %s\n", fHandle->fileName);
+    DB_LOG_TRACE("FILE NAME : %s", fHandle->fileName);
 
     return readBlock(0, fHandle, memPage);
 }
@@ -344,13 +351,76 @@ RC readLastBlock (SM_FileHandle *fHandle, SM_PageHandle memPage){
     }
 
     int lastPageNumber = fHandle->totalNumPages - 1;
-    printf("LAST PAGE : %d -> fHandle last page : %d\n", lastPageNumber, (fHandle->totalNumPages));
+    DB_LOG_TRACE("LAST PAGE : %d -> fHandle last page : %d", lastPageNumber, (fHandle->totalNumPages));
     if(lastPageNumber == -1) {
         return RC_READ_NON_EXISTING_PAGE;
     }
     return readBlock(lastPageNumber, fHandle, memPage);	
 }
 
+/**
+ * Reads `numPages` consecutive pages, starting at page `firstPageNum`, with vectored reads
+ * instead of one read per page. Like writeBlocks() it uses a file descriptor of its own.
+ *
+ * @param firstPageNum The page number of the first page to read.
+ * @param numPages The number of pages to read.
+ * @param fHandle Pointer to the file handle structure.
+ * @param memPages The memory pages to read into, one per page.
+ *
+ * @returns RC_OK if all pages were read, otherwise returns an error code:
+ *          - RC_FILE_HANDLE_NOT_INIT if the file handle is not initialized.
+ *          - RC_READ_NON_EXISTING_PAGE if a page is beyond the end of the file.
+ *          - RC_FILE_NOT_FOUND if the file is not found.
+ *          - RC_ERROR if a read fails.
+ */
+RC readBlocks (int firstPageNum, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages) {
+    if (fHandle == NULL) {
+        return RC_FILE_HANDLE_NOT_INIT;
+    } if (memPages == NULL || numPages < 1) {
+        return RC_ERROR;
+    } if (firstPageNum < 0 || firstPageNum + numPages > fHandle->totalNumPages) {
+        return RC_READ_NON_EXISTING_PAGE;
+    }
+
+	int fd = open(fHandle->fileName, O_RDONLY);
+	if (fd < 0) {
+		return RC_FILE_NOT_FOUND;
+	}
+
+	struct iovec vectors[READ_BATCH_PAGES];
+	int pagesRead = 0;
+	RC rc = RC_OK;
+
+	while (pagesRead < numPages) {
+		int batch = numPages - pagesRead;
+		if (batch > READ_BATCH_PAGES) {
+			batch = READ_BATCH_PAGES;
+		}
+		for (int i = 0; i < batch; i++) {
+			vectors[i].iov_base = memPages[pagesRead + i];
+			vectors[i].iov_len = PAGE_SIZE;
+		}
+
+		ssize_t numRead = preadv(fd, vectors, batch, (off_t) (firstPageNum + pagesRead) * PAGE_SIZE);
+		if (numRead < 0 && errno == EINTR) {
+			continue;
+		} if (numRead < 0) {
+			rc = RC_ERROR;
+			break;
+		} if (numRead == 0) {
+			rc = RC_READ_NON_EXISTING_PAGE;
+			break;
+		}
+		// after a short read the page that was cut off is read again as a whole
+		pagesRead += numRead / PAGE_SIZE;
+	}
+
+	close(fd);
+
+	fHandle->curPagePos = (firstPageNum + pagesRead) * PAGE_SIZE;
+	return rc;
+}
+
 
 /* ----------------- writing blocks to a page file ----------------- */
 /*
@@ -440,11 +510,15 @@ RC writeCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage) {
 		return RC_FILE_NOT_FOUND;
     }
 	
-	appendEmptyBlock(fHandle);
+	// only a write at the end of the file makes it grow
+	if (fHandle->curPagePos >= fHandle->totalNumPages * PAGE_SIZE) {
+		appendEmptyBlock(fHandle);
+	}
 
 	fseek(pageFile, fHandle->curPagePos, SEEK_SET);
-	
-	fwrite(memPage, sizeof(char), strlen(memPage), pageFile);
+
+	// pages are binary, a zero byte does not end them
+	fwrite(memPage, sizeof(char), PAGE_SIZE, pageFile);
 
     fHandle->curPagePos = ftell(pageFile);
 
@@ -452,6 +526,70 @@ RC writeCurrentBlock (SM_FileHandle *fHandle, SM_PageHandle memPage) {
 	return RC_OK;
 }
 
+/**
+ * Writes `numPages` consecutive pages, starting at page `firstPageNum`, with vectored writes
+ * instead of one write per page. The run may start at most at the end of the file and grows
+ * the file if it reaches past it. Each call uses a file descriptor of its own, so writes to
+ * different handles can run in parallel.
+ *
+ * @param firstPageNum The page number of the first page to write.
+ * @param numPages The number of pages to write.
+ * @param fHandle Pointer to the file handle structure.
+ * @param memPages The memory pages to be written, one per page.
+ *
+ * @returns RC_OK if all pages were written, otherwise returns an error code:
+ *          - RC_FILE_HANDLE_NOT_INIT if the file handle is not initialized.
+ *          - RC_WRITE_FAILED if the pages are out of range or the write fails.
+ *          - RC_FILE_NOT_FOUND if the file is not found.
+ */
+RC writeBlocks (int firstPageNum, int numPages, SM_FileHandle *fHandle, SM_PageHandle *memPages) {
+    if (fHandle == NULL) {
+        return RC_FILE_HANDLE_NOT_INIT;
+    } if (memPages == NULL || numPages < 1) {
+        return RC_WRITE_FAILED;
+    } if (firstPageNum < 0 || firstPageNum > fHandle->totalNumPages) {
+        return RC_WRITE_FAILED;
+    }
+
+	int fd = open(fHandle->fileName, O_WRONLY);
+	if (fd < 0) {
+		return RC_FILE_NOT_FOUND;
+	}
+
+	struct iovec vectors[WRITE_BATCH_PAGES];
+	int pagesWritten = 0;
+	RC rc = RC_OK;
+
+	while (pagesWritten < numPages) {
+		int batch = numPages - pagesWritten;
+		if (batch > WRITE_BATCH_PAGES) {
+			batch = WRITE_BATCH_PAGES;
+		}
+		for (int i = 0; i < batch; i++) {
+			vectors[i].iov_base = memPages[pagesWritten + i];
+			vectors[i].iov_len = PAGE_SIZE;
+		}
+
+		ssize_t written = pwritev(fd, vectors, batch, (off_t) (firstPageNum + pagesWritten) * PAGE_SIZE);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		} if (written <= 0) {
+			rc = RC_WRITE_FAILED;
+			break;
+		}
+		// after a short write the page that was cut off is written again as a whole
+		pagesWritten += written / PAGE_SIZE;
+	}
+
+	close(fd);
+
+	fHandle->curPagePos = (firstPageNum + pagesWritten) * PAGE_SIZE;
+	if (firstPageNum + pagesWritten > fHandle->totalNumPages) {
+		fHandle->totalNumPages = firstPageNum + pagesWritten;
+	}
+	return rc;
+}
+
 /**
  * Author : Deneshwara Sai Ila
  * Appends an empty block to the file associated with the given file handle.
@@ -504,8 +642,6 @@ ensureCapacity – If the file has less than numberOfPages pages then increase t
  */
 extern RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle) {
 
-    printf("\nScanning pages (totalNumPages) : %d -> %d\n", (fHandle->totalNumPages), numberOfPages);
-    
     if (fHandle == NULL) {
         return RC_FILE_HANDLE_NOT_INIT;
     } if(numberOfPages < 1) {
@@ -520,19 +656,16 @@ extern RC ensureCapacity (int numberOfPages, SM_FileHandle *fHandle) {
         return RC_FILE_NOT_FOUND;
     }
 
-    printf("\nScanning pages (totalNumPages) : %d", (fHandle->totalNumPages));
-    printf("\nScanning pages : %d\n", (numberOfPages - fHandle->totalNumPages));
+    DB_LOG_DEBUG("Extending %s from %d to %d pages", fHandle->fileName, fHandle->totalNumPages, numberOfPages);
+    DB_EVENT(DB_EVENT_EXTEND_FILE, fHandle->totalNumPages, numberOfPages);
 	
 	while(numberOfPages > fHandle->totalNumPages){
 		int responseCode = appendEmptyBlock(fHandle);
-        printf("RESPONSE CODE : %d\n", responseCode);
         if (responseCode != RC_OK) {
+            DB_LOG_ERROR("Appending a page to %s failed with RC %d", fHandle->fileName, responseCode);
             return responseCode;
         }
     }
-
-    printf("\nAFTER : Scanning pages (totalNumPages) : %d", (fHandle->totalNumPages));
-    printf("\nAFTER : Scanning pages : %d\n", (numberOfPages - fHandle->totalNumPages));
 	
 	fclose(pageFile);
 	return RC_OK;
@@ -0,0 +1,901 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "dberror.h"
+#include "storage_mgr.h"
+#include "buffer_mgr.h"
+#include "test_helper.h"
+
+#define TEST_FILE "testbuffer.bin"
+#define NUM_THREADS 8
+#define PINS_PER_THREAD 20000
+#define NUM_TEST_PAGES 256
+#define HOT_PAGES 4
+#define VICTIM_FILE "testbuffer.victim"
+#define SMALL_POOL_PAGES 10
+#define SEQUENTIAL_PAGES 200
+#define SEQUENTIAL_ROUNDS 500
+#define MANIFEST_FILE "testbuffer.manifest"
+#define MANIFEST_PAGES 48
+#define TIER_PAGES 64
+#define TIER_BYTES (1024 * 1024)
+#define PREFETCHED_PAGES 8
+#define VICTIM_TEST_PAGES 40
+#define VICTIM_CACHE_PAGES 128
+#define RESIZE_MIN_PAGES 16
+#define RESIZE_MAX_PAGES 64
+#define UNPIN_DELAY_US 100000
+#define HELD_PAGES 5
+#define BATCH_PAGES 7
+#define RING_POOL_PAGES 64
+#define RING_HOT_PAGES 32
+#define FLUSH_POOL_PAGES 128
+#define FLUSH_GAP 5
+#define PRIORITY_POOL_PAGES 32
+#define HIGH_PRIORITY_PAGES 4
+#define CLEANER_POOL_PAGES 32
+#define CLEAN_FRACTION 0.5
+
+// test methods
+static void testConcurrentPinUnpin (void);
+static void testHotPagesStayResident (void);
+static void testSequentialReadAheadSmallPool (void);
+static void testShutdownWithManifest (void);
+static void testCompressedTier (void);
+static void testVictimCache (void);
+static void testResizePool (void);
+static void testPinPagesAllOrNone (void);
+static void testScanKeepsHotSet (void);
+static void testFlushWritesEveryPage (void);
+static void testHighPriorityPagesSurviveScan (void);
+static void testPageCleaner (void);
+
+// helper methods
+static void createTestFile (int numPages);
+static void *pinUnpinWorker (void *arg);
+static void *hotPagesWorker (void *arg);
+static void *delayedUnpinWorker (void *arg);
+static bool isResident (BM_BufferPool *bm, PageNumber pageNum);
+static int fixCountOf (BM_BufferPool *bm, PageNumber pageNum);
+static int numDirtyFrames (BM_BufferPool *bm);
+static int manifestPages (void);
+static void fillPage (char *data, PageNumber pageNum, int version);
+static bool pageHolds (char *data, PageNumber pageNum, int version);
+
+// test name
+char *testName;
+
+// a worker thread and the pool it pins pages in
+typedef struct Worker {
+  BM_BufferPool *bm;
+  unsigned int seed;
+  int pins;
+  RC rc;
+} Worker;
+
+// pinned pages a thread unpins after a while
+typedef struct PinnedPages {
+  BM_BufferPool *bm;
+  BM_PageHandle *pages;
+  int n;
+} PinnedPages;
+
+// main method
+int
+main (void)
+{
+  testName = "";
+
+  initStorageManager();
+
+  testConcurrentPinUnpin();
+  testHotPagesStayResident();
+  testSequentialReadAheadSmallPool();
+  testShutdownWithManifest();
+  testCompressedTier();
+  testVictimCache();
+  testResizePool();
+  testPinPagesAllOrNone();
+  testScanKeepsHotSet();
+  testFlushWritesEveryPage();
+  testHighPriorityPagesSurviveScan();
+  testPageCleaner();
+
+  return 0;
+}
+
+// ************************************************************
+void
+testConcurrentPinUnpin (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  pthread_t threads[NUM_THREADS];
+  Worker workers[NUM_THREADS];
+  int i, total = 0;
+  testName = "Threads pinning, changing and unpinning pages";
+
+  createTestFile(NUM_TEST_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, 64, RS_LRU, NULL));
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      workers[i].bm = bm;
+      workers[i].seed = i + 1;
+      workers[i].pins = 0;
+      workers[i].rc = RC_OK;
+      pthread_create(&threads[i], NULL, pinUnpinWorker, &workers[i]);
+    }
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_join(threads[i], NULL);
+      TEST_CHECK(workers[i].rc);
+      total += workers[i].pins;
+    }
+
+  int *fixCounts = getFixCounts(bm);
+  for (i = 0; i < bm->numPages; i++)
+    ASSERT_EQUALS_INT(0, fixCounts[i], "no page is left pinned");
+  free(fixCounts);
+  TEST_CHECK(shutdownBufferPool(bm));
+
+  // every increment has to be in the file
+  int sum = 0;
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, 64, RS_FIFO, NULL));
+  for (i = 0; i < NUM_TEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      sum += *(int *) h->data;
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  ASSERT_EQUALS_INT(total, sum, "the counters on the pages add up to the pins");
+  TEST_CHECK(shutdownBufferPool(bm));
+
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testHotPagesStayResident (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  pthread_t threads[NUM_THREADS];
+  Worker workers[NUM_THREADS];
+  BM_PoolStats stats;
+  int i;
+  testName = "Hot pages stay resident while threads also pin cold pages";
+
+  createTestFile(NUM_TEST_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, 64, RS_LRU, NULL));
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      workers[i].bm = bm;
+      workers[i].seed = i + 1;
+      workers[i].pins = 0;
+      workers[i].rc = RC_OK;
+      pthread_create(&threads[i], NULL, hotPagesWorker, &workers[i]);
+    }
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      pthread_join(threads[i], NULL);
+      TEST_CHECK(workers[i].rc);
+    }
+
+  for (i = 0; i < HOT_PAGES; i++)
+    ASSERT_TRUE(isResident(bm, i), "hot page is resident");
+
+  TEST_CHECK(getPoolStats(bm, &stats));
+  ASSERT_TRUE(stats.hits + stats.misses >= (long) NUM_THREADS * PINS_PER_THREAD, "every pin was counted");
+  ASSERT_TRUE(stats.misses < (long) NUM_THREADS * PINS_PER_THREAD / 2, "hot pages are pinned without reading them again");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testSequentialReadAheadSmallPool (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+  int round, i;
+  testName = "Pinning pages in order while read ahead fills a small pool";
+
+  createTestFile(SEQUENTIAL_PAGES);
+  options.prefetchWindow = 8;
+  options.victimCacheFile = VICTIM_FILE;
+  options.victimCachePages = 64;
+
+  // read ahead holds frames of the pool while it reads, a pin must still find one
+  for (round = 0; round < SEQUENTIAL_ROUNDS; round++)
+    {
+      TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, SMALL_POOL_PAGES, RS_LRU, NULL, &options));
+      for (i = 0; i < SEQUENTIAL_PAGES; i++)
+        {
+          TEST_CHECK(pinPage(bm, h, i));
+          TEST_CHECK(unpinPage(bm, h));
+        }
+      TEST_CHECK(shutdownBufferPool(bm));
+    }
+
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  remove(VICTIM_FILE);
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testShutdownWithManifest (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *kept = MAKE_PAGE_HANDLE();
+  BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+  int i, pages;
+  RC rc;
+  testName = "Shutting down a pool with a manifest";
+
+  createTestFile(NUM_TEST_PAGES);
+  remove(MANIFEST_FILE);
+  options.prefetchWindow = 4;
+  options.manifestFile = MANIFEST_FILE;
+  TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, 64, RS_LRU, NULL, &options));
+
+  for (i = 0; i < MANIFEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(pinPage(bm, kept, MANIFEST_PAGES));
+
+  // a failed shutdown leaves the pool running and the manifest alone
+  rc = shutdownBufferPool(bm);
+  ASSERT_EQUALS_INT(RC_PINNED_PAGES_IN_BUFFER, rc, "shutdown with a pinned page");
+  pages = manifestPages();
+  ASSERT_EQUALS_INT(-1, pages, "no manifest is written by a failed shutdown");
+  TEST_CHECK(pinPage(bm, h, MANIFEST_PAGES + 1));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(unpinPage(bm, kept));
+  TEST_CHECK(shutdownBufferPool(bm));
+  pages = manifestPages();
+  ASSERT_TRUE(pages >= MANIFEST_PAGES + 2, "the manifest lists the pages of the pool");
+
+  // a shutdown right after the start, while the pool may still be warmed up, keeps every page
+  TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, 64, RS_LRU, NULL, &options));
+  TEST_CHECK(shutdownBufferPool(bm));
+  ASSERT_TRUE(manifestPages() >= pages, "the manifest does not shrink");
+
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  remove(MANIFEST_FILE);
+  free(bm);
+  free(h);
+  free(kept);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testCompressedTier (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+  BM_PoolStats before, after;
+  PageNumber pageNums[PREFETCHED_PAGES];
+  int i, waits;
+  testName = "Replaced pages come back from the compressed tier as they were";
+
+  createTestFile(TIER_PAGES);
+  options.compressedCacheBytes = TIER_BYTES;
+  TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, SMALL_POOL_PAGES, RS_LRU, NULL, &options));
+
+  for (i = 0; i < TIER_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      fillPage(h->data, i, 0);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(forceFlushPool(bm));
+
+  // all but the last pages were replaced, written back and kept compressed
+  TEST_CHECK(getPoolStats(bm, &before));
+  for (i = 0; i < TIER_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      ASSERT_TRUE(pageHolds(h->data, i, 0), "a page from the tier is the page that was replaced");
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &after));
+  ASSERT_TRUE(after.compressedHits - before.compressedHits >= TIER_PAGES - 2 * SMALL_POOL_PAGES, "pins are served from the tier");
+  ASSERT_TRUE(after.reads - before.reads <= 2 * SMALL_POOL_PAGES, "pages served from the tier are not read");
+
+  // a page changed after it was compressed is never served from its old copy
+  for (i = 0; i < TIER_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      fillPage(h->data, i, 1);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  for (i = 0; i < TIER_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      ASSERT_TRUE(pageHolds(h->data, i, 1), "a page dirtied after it was compressed has its changes");
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  // pages read ahead from the tier are not pins, so they are no compressed hits
+  TEST_CHECK(getPoolStats(bm, &before));
+  for (i = 0; i < PREFETCHED_PAGES; i++)
+    pageNums[i] = i;
+  TEST_CHECK(prefetchPages(bm, pageNums, PREFETCHED_PAGES));
+  for (waits = 0; waits < 1000; waits++)
+    {
+      TEST_CHECK(getPoolStats(bm, &after));
+      if (after.prefetchReads >= before.prefetchReads + PREFETCHED_PAGES)
+        break;
+      usleep(1000);
+    }
+  ASSERT_TRUE(after.prefetchReads > before.prefetchReads, "pages were read ahead");
+  ASSERT_EQUALS_INT((int) before.compressedHits, (int) after.compressedHits, "read ahead is not counted as compressed hits");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testVictimCache (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+  BM_PoolStats before, after;
+  int i, waits;
+  testName = "Replaced pages are read back from the victim cache until they are written";
+
+  createTestFile(VICTIM_TEST_PAGES);
+  options.victimCacheFile = VICTIM_FILE;
+  options.victimCachePages = VICTIM_CACHE_PAGES;
+  TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, SMALL_POOL_PAGES, RS_LRU, NULL, &options));
+
+  for (i = 0; i < VICTIM_TEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      fillPage(h->data, i, 0);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(forceFlushPool(bm));
+  for (waits = 0; waits < 1000; waits++)
+    {
+      TEST_CHECK(getPoolStats(bm, &before));
+      if (before.victimCacheWrites >= VICTIM_TEST_PAGES - SMALL_POOL_PAGES)
+        break;
+      usleep(1000);
+    }
+  ASSERT_TRUE(before.victimCacheWrites >= VICTIM_TEST_PAGES - SMALL_POOL_PAGES, "replaced pages are written to the victim cache");
+
+  for (i = 0; i < SMALL_POOL_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      ASSERT_TRUE(pageHolds(h->data, i, 0), "a page from the victim cache is the page that was replaced");
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &after));
+  ASSERT_EQUALS_INT(SMALL_POOL_PAGES, (int) (after.victimCacheHits - before.victimCacheHits), "every miss is served from the victim cache");
+  ASSERT_EQUALS_INT((int) before.reads, (int) after.reads, "nothing is read from the page file");
+
+  // pages 0 and 1 are in the pool and still in the victim cache, writing them back drops the copies
+  TEST_CHECK(pinPage(bm, h, 0));
+  fillPage(h->data, 0, 1);
+  TEST_CHECK(markDirty(bm, h));
+  TEST_CHECK(forcePage(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 1));
+  fillPage(h->data, 1, 1);
+  TEST_CHECK(markDirty(bm, h));
+  TEST_CHECK(unpinPage(bm, h));
+
+  for (i = SMALL_POOL_PAGES; i < VICTIM_TEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(pinPage(bm, h, 0));
+  ASSERT_TRUE(pageHolds(h->data, 0, 1), "a page forced to disk is not read from its old copy");
+  TEST_CHECK(unpinPage(bm, h));
+  TEST_CHECK(pinPage(bm, h, 1));
+  ASSERT_TRUE(pageHolds(h->data, 1, 1), "a page written back when it was replaced is not read from its old copy");
+  TEST_CHECK(unpinPage(bm, h));
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  remove(VICTIM_FILE);
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testResizePool (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle pinned[RESIZE_MAX_PAGES];
+  BM_PoolOptions options = DEFAULT_POOL_OPTIONS;
+  BM_PoolStats before, after;
+  PinnedPages unpinner;
+  pthread_t thread;
+  int i;
+  RC rc;
+  testName = "Growing and shrinking a pool in use";
+
+  createTestFile(NUM_TEST_PAGES);
+  options.maxPages = RESIZE_MAX_PAGES;
+  TEST_CHECK(initBufferPoolWithOptions(bm, TEST_FILE, RESIZE_MIN_PAGES, RS_LRU, NULL, &options));
+
+  for (i = 0; i < RESIZE_MIN_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      fillPage(h->data, i, 0);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  rc = resizeBufferPool(bm, RESIZE_MAX_PAGES + 1);
+  ASSERT_EQUALS_INT(RC_POOL_CAPACITY_EXCEEDED, rc, "growing beyond maxPages");
+  rc = resizeBufferPool(bm, 0);
+  ASSERT_EQUALS_INT(RC_INVALID_INPUT, rc, "shrinking to no frames");
+
+  // the new frames take more pages without replacing any
+  TEST_CHECK(resizeBufferPool(bm, RESIZE_MAX_PAGES));
+  ASSERT_EQUALS_INT(RESIZE_MAX_PAGES, bm->numPages, "frames after growing");
+  TEST_CHECK(getPoolStats(bm, &before));
+  for (i = 0; i < RESIZE_MAX_PAGES; i++)
+    TEST_CHECK(pinPage(bm, &pinned[i], i));
+  TEST_CHECK(getPoolStats(bm, &after));
+  ASSERT_EQUALS_INT((int) before.evictions, (int) after.evictions, "no page is replaced");
+
+  // every page stays pinned, so the shrink gives up and the pool keeps its frames
+  rc = resizeBufferPool(bm, RESIZE_MIN_PAGES);
+  ASSERT_EQUALS_INT(RC_PINNED_PAGES_IN_BUFFER, rc, "shrinking while every page is pinned");
+  ASSERT_EQUALS_INT(RESIZE_MAX_PAGES, bm->numPages, "frames after the failed shrink");
+  for (i = 0; i < RESIZE_MAX_PAGES; i++)
+    ASSERT_TRUE(isResident(bm, i), "pages stay resident after the failed shrink");
+
+  // pins that end while the shrink waits let it finish
+  unpinner.bm = bm;
+  unpinner.pages = pinned;
+  unpinner.n = RESIZE_MAX_PAGES;
+  pthread_create(&thread, NULL, delayedUnpinWorker, &unpinner);
+  TEST_CHECK(resizeBufferPool(bm, RESIZE_MIN_PAGES));
+  pthread_join(thread, NULL);
+  ASSERT_EQUALS_INT(RESIZE_MIN_PAGES, bm->numPages, "frames after shrinking");
+
+  // dirty pages of the removed frames were written back, and the pool works with fewer frames
+  for (i = 0; i < RESIZE_MIN_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      ASSERT_TRUE(pageHolds(h->data, i, 0), "a page written before the shrink");
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  for (i = 0; i < NUM_TEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPinPagesAllOrNone (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle held[HELD_PAGES];
+  BM_PageHandle batch[BATCH_PAGES];
+  PageNumber pageNums[BATCH_PAGES];
+  int i;
+  RC rc;
+  testName = "A batch pin that does not fit the pool pins none of its pages";
+
+  createTestFile(NUM_TEST_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, SMALL_POOL_PAGES, RS_LRU, NULL));
+  for (i = 0; i < HELD_PAGES; i++)
+    TEST_CHECK(pinPage(bm, &held[i], i));
+
+  // a page that is already pinned and more new pages than there are frames left
+  pageNums[0] = HELD_PAGES - 1;
+  for (i = 1; i < BATCH_PAGES; i++)
+    pageNums[i] = 100 + i;
+  rc = pinPages(bm, batch, pageNums, BATCH_PAGES);
+  ASSERT_EQUALS_INT(RC_PINNED_PAGES_IN_BUFFER, rc, "a batch larger than the unpinned frames");
+  for (i = 0; i < HELD_PAGES; i++)
+    ASSERT_EQUALS_INT(1, fixCountOf(bm, i), "pages pinned before the batch keep their pin only");
+  for (i = 1; i < BATCH_PAGES; i++)
+    ASSERT_EQUALS_INT(0, fixCountOf(bm, pageNums[i]), "no page of the failed batch is pinned");
+
+  // one page less fits
+  TEST_CHECK(pinPages(bm, batch, pageNums, BATCH_PAGES - 1));
+  ASSERT_EQUALS_INT(2, fixCountOf(bm, HELD_PAGES - 1), "the page pinned twice");
+  for (i = 1; i < BATCH_PAGES - 1; i++)
+    ASSERT_EQUALS_INT(1, fixCountOf(bm, pageNums[i]), "the pages of the batch are pinned");
+  TEST_CHECK(unpinPages(bm, batch, BATCH_PAGES - 1));
+
+  for (i = 0; i < HELD_PAGES; i++)
+    TEST_CHECK(unpinPage(bm, &held[i]));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testScanKeepsHotSet (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_AccessRing *ring;
+  int i;
+  testName = "A scan through an access ring leaves the hot pages in the pool";
+
+  createTestFile(NUM_TEST_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, RING_POOL_PAGES, RS_LRU, NULL));
+  for (i = 0; i < RING_HOT_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  // the scan reads several times as many pages as the pool has frames
+  TEST_CHECK(createAccessRing(bm, BM_ACCESS_BULK_READ, &ring));
+  for (i = RING_HOT_PAGES; i < NUM_TEST_PAGES; i++)
+    {
+      TEST_CHECK(pinPageWithStrategy(bm, h, i, ring));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(freeAccessRing(ring));
+
+  for (i = 0; i < RING_HOT_PAGES; i++)
+    ASSERT_TRUE(isResident(bm, i), "a hot page is still resident after the scan");
+  ASSERT_TRUE(isResident(bm, NUM_TEST_PAGES - 1), "the last page of the scan is resident");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testFlushWritesEveryPage (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PageHandle *kept = MAKE_PAGE_HANDLE();
+  SM_FileHandle fh;
+  char onDisk[PAGE_SIZE], zeros[PAGE_SIZE];
+  bool *dirty;
+  int i, pageNum, numDirty = 0, writes;
+  testName = "A flush writes runs of dirty pages in parallel, each to its place";
+
+  createTestFile(FLUSH_POOL_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, FLUSH_POOL_PAGES, RS_LRU, NULL));
+
+  // out of order, with clean pages between the runs
+  for (i = 0; i < FLUSH_POOL_PAGES; i++)
+    {
+      pageNum = (i * 37) % FLUSH_POOL_PAGES;
+      TEST_CHECK(pinPage(bm, h, pageNum));
+      if (pageNum % FLUSH_GAP != 0)
+        {
+          fillPage(h->data, pageNum, 0);
+          TEST_CHECK(markDirty(bm, h));
+          numDirty++;
+        }
+      TEST_CHECK(unpinPage(bm, h));
+    }
+
+  // a pinned page is not written
+  TEST_CHECK(pinPage(bm, kept, 1));
+  writes = getNumWriteIO(bm);
+  TEST_CHECK(forceFlushPool(bm));
+  ASSERT_EQUALS_INT(numDirty - 1, getNumWriteIO(bm) - writes, "every unpinned dirty page is written once");
+
+  dirty = getDirtyFlags(bm);
+  for (i = 0; i < FLUSH_POOL_PAGES; i++)
+    ASSERT_TRUE(dirty[i] == (i == kept->frameIndex), "only the pinned page is still dirty");
+  free(dirty);
+
+  memset(zeros, 0, PAGE_SIZE);
+  TEST_CHECK(openPageFile(TEST_FILE, &fh));
+  for (pageNum = 0; pageNum < FLUSH_POOL_PAGES; pageNum++)
+    {
+      TEST_CHECK(readBlock(pageNum, &fh, onDisk));
+      if (pageNum % FLUSH_GAP == 0 || pageNum == 1)
+        ASSERT_TRUE(memcmp(onDisk, zeros, PAGE_SIZE) == 0, "a page that was not written");
+      else
+        ASSERT_TRUE(pageHolds(onDisk, pageNum, 0), "a written page is at its place in the file");
+    }
+  TEST_CHECK(closePageFile(&fh));
+
+  TEST_CHECK(unpinPage(bm, kept));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  free(kept);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testHighPriorityPagesSurviveScan (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  ReplacementStrategy strategies[] = { RS_FIFO, RS_LRU, RS_CLOCK };
+  int s, i;
+  testName = "High priority pages outlast a scan of twice the pool";
+
+  createTestFile(NUM_TEST_PAGES);
+  for (s = 0; s < 3; s++)
+    {
+      TEST_CHECK(initBufferPool(bm, TEST_FILE, PRIORITY_POOL_PAGES, strategies[s], NULL));
+      for (i = 0; i < HIGH_PRIORITY_PAGES; i++)
+        {
+          TEST_CHECK(pinPageWithPriority(bm, h, i, BM_PRIORITY_HIGH));
+          TEST_CHECK(unpinPage(bm, h));
+        }
+      TEST_CHECK(pinPage(bm, h, HIGH_PRIORITY_PAGES));
+      TEST_CHECK(unpinPage(bm, h));
+
+      // each page of the scan is pinned once, as a page of a table scan would be
+      for (i = HIGH_PRIORITY_PAGES + 1; i <= HIGH_PRIORITY_PAGES + 2 * PRIORITY_POOL_PAGES; i++)
+        {
+          TEST_CHECK(pinPage(bm, h, i));
+          TEST_CHECK(unpinPage(bm, h));
+        }
+
+      for (i = 0; i < HIGH_PRIORITY_PAGES; i++)
+        ASSERT_TRUE(isResident(bm, i), "a high priority page is still resident");
+      ASSERT_TRUE(!isResident(bm, HIGH_PRIORITY_PAGES), "a normal page read before the scan is replaced");
+      TEST_CHECK(shutdownBufferPool(bm));
+    }
+
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testPageCleaner (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  BM_PoolStats before, after;
+  int i, waits, numClean = (int) (CLEANER_POOL_PAGES * CLEAN_FRACTION);
+  testName = "The page cleaner keeps frames clean so that replacements need no writes";
+
+  createTestFile(NUM_TEST_PAGES);
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, CLEANER_POOL_PAGES, RS_LRU, NULL));
+  TEST_CHECK(startPageCleaner(bm, CLEAN_FRACTION));
+
+  for (i = 0; i < CLEANER_POOL_PAGES; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      fillPage(h->data, i, 0);
+      TEST_CHECK(markDirty(bm, h));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  for (waits = 0; waits < 1000 && numDirtyFrames(bm) > CLEANER_POOL_PAGES - numClean; waits++)
+    usleep(1000);
+  ASSERT_TRUE(numDirtyFrames(bm) <= CLEANER_POOL_PAGES - numClean, "the cleaner reaches its clean fraction");
+
+  TEST_CHECK(getPoolStats(bm, &before));
+  ASSERT_TRUE(before.cleanerWrites >= numClean, "the cleaner wrote the pages");
+  ASSERT_TRUE(before.cleanerWrites < CLEANER_POOL_PAGES, "the cleaner writes no more pages than its target needs");
+
+  // the least recently used pages are the clean ones, replacing them writes nothing
+  for (i = CLEANER_POOL_PAGES; i < CLEANER_POOL_PAGES + numClean; i++)
+    {
+      TEST_CHECK(pinPage(bm, h, i));
+      TEST_CHECK(unpinPage(bm, h));
+    }
+  TEST_CHECK(getPoolStats(bm, &after));
+  ASSERT_EQUALS_INT((int) before.dirtyEvictions, (int) after.dirtyEvictions, "no replaced page had to be written first");
+  ASSERT_EQUALS_INT(numClean, (int) (after.evictions - before.evictions), "a page was replaced for each new one");
+
+  TEST_CHECK(stopPageCleaner(bm));
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+// creates TEST_FILE with numPages pages of zeros
+void
+createTestFile (int numPages)
+{
+  SM_FileHandle fh;
+
+  TEST_CHECK(createPageFile(TEST_FILE));
+  TEST_CHECK(openPageFile(TEST_FILE, &fh));
+  TEST_CHECK(ensureCapacity(numPages, &fh));
+  TEST_CHECK(closePageFile(&fh));
+}
+
+// pins random pages and increments the counter at their start under an exclusive latch
+void *
+pinUnpinWorker (void *arg)
+{
+  Worker *worker = arg;
+  BM_PageHandle h;
+  int i;
+
+  for (i = 0; i < PINS_PER_THREAD && worker->rc == RC_OK; i++)
+    {
+      worker->rc = pinPage(worker->bm, &h, rand_r(&worker->seed) % NUM_TEST_PAGES);
+      if (worker->rc != RC_OK)
+        break;
+
+      latchPage(worker->bm, &h, BM_LATCH_EXCLUSIVE);
+      (*(int *) h.data)++;
+      unlatchPage(worker->bm, &h, BM_LATCH_EXCLUSIVE);
+
+      worker->rc = markDirty(worker->bm, &h);
+      if (worker->rc == RC_OK)
+        worker->rc = unpinPage(worker->bm, &h);
+      if (worker->rc == RC_OK)
+        worker->pins++;
+    }
+  return NULL;
+}
+
+// pins the hot pages most of the time and a random cold page otherwise
+void *
+hotPagesWorker (void *arg)
+{
+  Worker *worker = arg;
+  BM_PageHandle h;
+  int i;
+
+  for (i = 0; i < PINS_PER_THREAD && worker->rc == RC_OK; i++)
+    {
+      PageNumber pageNum = (i % 4 != 3) ? rand_r(&worker->seed) % HOT_PAGES
+        : HOT_PAGES + rand_r(&worker->seed) % (NUM_TEST_PAGES - HOT_PAGES);
+
+      worker->rc = pinPage(worker->bm, &h, pageNum);
+      if (worker->rc == RC_OK)
+        worker->rc = unpinPage(worker->bm, &h);
+    }
+  return NULL;
+}
+
+// unpins the pages after a moment, while the main thread waits in a shrink
+void *
+delayedUnpinWorker (void *arg)
+{
+  PinnedPages *pinned = arg;
+  int i;
+
+  usleep(UNPIN_DELAY_US);
+  for (i = 0; i < pinned->n; i++)
+    TEST_CHECK(unpinPage(pinned->bm, &pinned->pages[i]));
+  return NULL;
+}
+
+// whether a page is in one of the frames of the pool
+bool
+isResident (BM_BufferPool *bm, PageNumber pageNum)
+{
+  PageNumber *contents = getFrameContents(bm);
+  bool found = FALSE;
+  int i;
+
+  for (i = 0; i < bm->numPages; i++)
+    if (contents[i] == pageNum)
+      found = TRUE;
+  free(contents);
+  return found;
+}
+
+// the number of pages MANIFEST_FILE lists, -1 if there is none
+int
+manifestPages (void)
+{
+  FILE *in = fopen(MANIFEST_FILE, "r");
+  char line[256];
+  int pages = -1;
+
+  if (in == NULL)
+    return -1;
+  while (fgets(line, sizeof(line), in) != NULL)
+    if (sscanf(line, "pages %d", &pages) == 1)
+      break;
+  fclose(in);
+  return pages;
+}
+
+
+// fills a page with a text that names the page and the version of its contents
+void
+fillPage (char *data, PageNumber pageNum, int version)
+{
+  int i;
+
+  memset(data, 0, PAGE_SIZE);
+  for (i = 0; i + 32 <= PAGE_SIZE; i += 32)
+    sprintf(data + i, "page %d version %d", pageNum, version);
+}
+
+// whether a page holds what fillPage wrote to it
+bool
+pageHolds (char *data, PageNumber pageNum, int version)
+{
+  char expected[PAGE_SIZE];
+
+  fillPage(expected, pageNum, version);
+  return memcmp(data, expected, PAGE_SIZE) == 0;
+}
+
+// the fix count of a page, 0 if it is not in the pool
+int
+fixCountOf (BM_BufferPool *bm, PageNumber pageNum)
+{
+  PageNumber *contents = getFrameContents(bm);
+  int *fixCounts = getFixCounts(bm);
+  int fixCount = 0;
+  int i;
+
+  for (i = 0; i < bm->numPages; i++)
+    if (contents[i] == pageNum)
+      fixCount = fixCounts[i];
+  free(contents);
+  free(fixCounts);
+  return fixCount;
+}
+
+// the number of frames with a dirty page
+int
+numDirtyFrames (BM_BufferPool *bm)
+{
+  bool *dirty = getDirtyFlags(bm);
+  int numDirty = 0;
+  int i;
+
+  for (i = 0; i < bm->numPages; i++)
+    if (dirty[i])
+      numDirty++;
+  free(dirty);
+  return numDirty;
+}
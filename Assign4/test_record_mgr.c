@@ -0,0 +1,617 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "dberror.h"
+#include "expr.h"
+#include "record_mgr.h"
+#include "tables.h"
+#include "test_helper.h"
+
+#define ASSERT_EQUALS_RID(_l,_r, message)				\
+  do {									\
+    ASSERT_TRUE((_l).page == (_r).page && (_l).slot == (_r).slot, message); \
+  } while(0)
+
+#define TEST_TABLE "test_table_rm"
+#define OTHER_TABLE "test_table_rm2"
+#define TEST_CSV "test_table_rm.csv"
+#define LONG_STRING_LENGTH 10000
+#define WIDE_COLUMNS 300
+#define BULK_RECORDS 1000
+
+// test methods
+static void testSlotReuse (void);
+static void testUpdateMovesRecord (void);
+static void testOverflowStrings (void);
+static void testWideRecords (void);
+static void testInsertRecords (void);
+static void testLoadFromCSV (void);
+static void testTwoTablesOpen (void);
+static void testCatalogReload (void);
+static void testTableInUse (void);
+
+// helper methods
+static Schema *testSchema (int stringLength);
+static Record *testRecord (Schema *schema, int a, char *b);
+static char *repeatedString (char c, int length);
+static void checkRecord (RM_TableData *table, RID id, int a, char *b);
+static int countRecords (RM_TableData *table);
+
+// test name
+char *testName;
+
+// main method
+int
+main (void)
+{
+  testName = "";
+
+  testSlotReuse();
+  testUpdateMovesRecord();
+  testOverflowStrings();
+  testWideRecords();
+  testInsertRecords();
+  testLoadFromCSV();
+  testTwoTablesOpen();
+  testCatalogReload();
+  testTableInUse();
+
+  return 0;
+}
+
+// ************************************************************
+void
+testSlotReuse (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(20);
+  Record *r, *probe;
+  RID rids[20];
+  int i, count;
+  testName = "a deleted record's slot is used again";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  for (i = 0; i < 20; i++)
+    {
+      r = testRecord(schema, i, "record");
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+      freeRecord(r);
+    }
+
+  TEST_CHECK(deleteRecord(table, rids[5]));
+  TEST_CHECK(createRecord(&probe, schema));
+  ASSERT_ERROR(getRecord(table, rids[5], probe), "a deleted record is gone");
+  ASSERT_EQUALS_INT(19, getNumTuples(table), "tuples after the delete");
+
+  r = testRecord(schema, 100, "again");
+  TEST_CHECK(insertRecord(table, r));
+  ASSERT_EQUALS_RID(rids[5], r->id, "the insert takes the freed slot");
+  freeRecord(r);
+
+  checkRecord(table, rids[5], 100, "again");
+  checkRecord(table, rids[6], 6, "record");
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(20, count, "a scan finds every record once");
+
+  freeRecord(probe);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testUpdateMovesRecord (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(1000);
+  char *big = repeatedString('g', 900);
+  Record *r;
+  RID first, id;
+  int i, count;
+  testName = "a record keeps its id when an update grows it off its page and shrinks it again";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  // fill the first data page
+  for (i = 0; ; i++)
+    {
+      r = testRecord(schema, i, "small");
+      TEST_CHECK(insertRecord(table, r));
+      id = r->id;
+      freeRecord(r);
+      if (i == 0)
+        first = id;
+      else if (id.page != first.page)
+        break;
+    }
+
+  r = testRecord(schema, 0, big);
+  r->id = first;
+  TEST_CHECK(updateRecord(table, r));
+  freeRecord(r);
+  checkRecord(table, first, 0, big);
+
+  r = testRecord(schema, 0, "tiny");
+  r->id = first;
+  TEST_CHECK(updateRecord(table, r));
+  freeRecord(r);
+  checkRecord(table, first, 0, "tiny");
+
+  // and after it was written out
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  checkRecord(table, first, 0, "tiny");
+  ASSERT_EQUALS_INT(i + 1, getNumTuples(table), "updates leave the number of tuples alone");
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(i + 1, count, "a moved record is scanned once");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  free(big);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testOverflowStrings (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(LONG_STRING_LENGTH);
+  char *longA = repeatedString('a', LONG_STRING_LENGTH - 1);
+  char *longB = repeatedString('b', LONG_STRING_LENGTH / 2);
+  Record *r;
+  RID id, other;
+  int count;
+  testName = "strings longer than a page";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  r = testRecord(schema, 1, longA);
+  TEST_CHECK(insertRecord(table, r));
+  id = r->id;
+  freeRecord(r);
+  r = testRecord(schema, 2, "short");
+  TEST_CHECK(insertRecord(table, r));
+  other = r->id;
+  freeRecord(r);
+  checkRecord(table, id, 1, longA);
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  checkRecord(table, id, 1, longA);
+
+  r = testRecord(schema, 1, longB);
+  r->id = id;
+  TEST_CHECK(updateRecord(table, r));
+  freeRecord(r);
+  checkRecord(table, id, 1, longB);
+  checkRecord(table, other, 2, "short");
+
+  TEST_CHECK(deleteRecord(table, id));
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(1, count, "the other record is left");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  free(longA);
+  free(longB);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testWideRecords (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  char **names = (char **) malloc(sizeof(char *) * WIDE_COLUMNS);
+  DataType *dataTypes = (DataType *) malloc(sizeof(DataType) * WIDE_COLUMNS);
+  int *sizes = (int *) malloc(sizeof(int) * WIDE_COLUMNS);
+  int *keys = (int *) malloc(sizeof(int));
+  char name[16];
+  Schema *schema;
+  Record *r;
+  Value *value;
+  RID rids[20];
+  int i, j, count;
+  testName = "records of many integer columns, longer than a quarter page";
+
+  for (j = 0; j < WIDE_COLUMNS; j++)
+    {
+      sprintf(name, "c%d", j);
+      names[j] = strdup(name);
+      dataTypes[j] = DT_INT;
+      sizes[j] = 0;
+    }
+  keys[0] = 0;
+  schema = createSchema(WIDE_COLUMNS, names, dataTypes, sizes, 1, keys);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  TEST_CHECK(createRecord(&r, schema));
+  for (i = 0; i < 20; i++)
+    {
+      for (j = 0; j < WIDE_COLUMNS; j++)
+        {
+          MAKE_VALUE(value, DT_INT, i * WIDE_COLUMNS + j);
+          TEST_CHECK(setAttr(r, schema, j, value));
+          freeVal(value);
+        }
+      TEST_CHECK(insertRecord(table, r));
+      rids[i] = r->id;
+    }
+
+  TEST_CHECK(getRecord(table, rids[3], r));
+  MAKE_VALUE(value, DT_INT, -1);
+  TEST_CHECK(setAttr(r, schema, WIDE_COLUMNS - 1, value));
+  freeVal(value);
+  TEST_CHECK(updateRecord(table, r));
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  for (i = 0; i < 20; i++)
+    {
+      TEST_CHECK(getRecord(table, rids[i], r));
+      TEST_CHECK(getAttr(r, schema, 0, &value));
+      ASSERT_EQUALS_INT(i * WIDE_COLUMNS, value->v.intV, "the first column");
+      freeVal(value);
+      TEST_CHECK(getAttr(r, schema, WIDE_COLUMNS - 1, &value));
+      ASSERT_EQUALS_INT(i == 3 ? -1 : (i + 1) * WIDE_COLUMNS - 1, value->v.intV, "the last column");
+      freeVal(value);
+    }
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(20, count, "a scan finds every record");
+
+  freeRecord(r);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testInsertRecords (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(300);
+  char *filler = repeatedString('f', 200);
+  Record *records[BULK_RECORDS];
+  RID rids[BULK_RECORDS];
+  int i, count;
+  testName = "insertRecords over several extents";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  for (i = 0; i < BULK_RECORDS; i++)
+    records[i] = testRecord(schema, i, filler);
+  TEST_CHECK(insertRecords(table, records, BULK_RECORDS, rids));
+  ASSERT_TRUE(rids[BULK_RECORDS - 1].page > 2 * BULK_EXTENT_PAGES, "the records take more than two extents");
+  ASSERT_EQUALS_INT(BULK_RECORDS, getNumTuples(table), "tuples after the batch");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  for (i = 0; i < BULK_RECORDS; i++)
+    {
+      ASSERT_EQUALS_RID(rids[i], records[i]->id, "the record got its id");
+      checkRecord(table, rids[i], i, filler);
+    }
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(BULK_RECORDS, count, "a scan finds every record");
+
+  for (i = 0; i < BULK_RECORDS; i++)
+    freeRecord(records[i]);
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  free(filler);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testLoadFromCSV (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(40);
+  RM_LoadOptions options = DEFAULT_LOAD_OPTIONS;
+  RM_ScanHandle *scan = (RM_ScanHandle *) malloc(sizeof(RM_ScanHandle));
+  char *expected[] = { "plain", "with, delimiter", "say \"hi\"" };
+  FILE *csv;
+  Expr *all;
+  Record *r;
+  RC rc;
+  int i, count;
+  testName = "loading a CSV file with a header, quoted fields and a bad line";
+
+  csv = fopen(TEST_CSV, "w");
+  fprintf(csv, "a,b\n");
+  fprintf(csv, "1,plain\n");
+  fprintf(csv, "2,\"with, delimiter\"\n");
+  fprintf(csv, "3,\"say \"\"hi\"\"\"\n");
+  fprintf(csv, "not a number,bad\n");
+  fprintf(csv, "5,after\n");
+  fclose(csv);
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  options.hasHeader = TRUE;
+  rc = loadTableFromCSV(table, TEST_CSV, &options);
+  ASSERT_EQUALS_INT(RC_RM_CSV_PARSE_ERROR, rc, "the bad line is reported");
+  ASSERT_EQUALS_INT(3, getNumTuples(table), "the rows before the bad line are kept");
+  count = countRecords(table);
+  ASSERT_EQUALS_INT(3, count, "a scan finds the rows before the bad line");
+
+  // the rows are inserted in the order of the file, which is the order a scan returns them in
+  MAKE_CONS(all, stringToValue("btrue"));
+  TEST_CHECK(createRecord(&r, schema));
+  TEST_CHECK(startScan(table, scan, all));
+  for (i = 0; i < 3; i++)
+    {
+      TEST_CHECK(next(scan, r));
+      checkRecord(table, r->id, i + 1, expected[i]);
+    }
+  TEST_CHECK(closeScan(scan));
+  freeRecord(r);
+  freeExpr(all);
+
+  rc = loadTableFromCSV(table, "missing.csv", &options);
+  ASSERT_EQUALS_INT(RC_FILE_NOT_FOUND, rc, "a missing file");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  remove(TEST_CSV);
+  freeSchema(schema);
+  free(table);
+  free(scan);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testTwoTablesOpen (void)
+{
+  RM_TableData *first = (RM_TableData *) malloc(sizeof(RM_TableData));
+  RM_TableData *second = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *firstSchema = testSchema(10);
+  Schema *secondSchema = testSchema(100);
+  Record *r;
+  RID firstIds[50], secondIds[50];
+  int i, count;
+  testName = "two tables open at the same time";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, firstSchema));
+  TEST_CHECK(createTable(OTHER_TABLE, secondSchema));
+  TEST_CHECK(openTable(first, TEST_TABLE));
+  TEST_CHECK(openTable(second, OTHER_TABLE));
+
+  for (i = 0; i < 50; i++)
+    {
+      r = testRecord(firstSchema, i, "one");
+      TEST_CHECK(insertRecord(first, r));
+      firstIds[i] = r->id;
+      freeRecord(r);
+
+      r = testRecord(secondSchema, -i, "the other table");
+      TEST_CHECK(insertRecord(second, r));
+      secondIds[i] = r->id;
+      freeRecord(r);
+    }
+  TEST_CHECK(deleteRecord(first, firstIds[0]));
+
+  ASSERT_EQUALS_INT(49, getNumTuples(first), "tuples of the first table");
+  ASSERT_EQUALS_INT(50, getNumTuples(second), "tuples of the second table");
+  count = countRecords(second);
+  ASSERT_EQUALS_INT(50, count, "a delete in one table leaves the other alone");
+  for (i = 1; i < 50; i++)
+    {
+      checkRecord(first, firstIds[i], i, "one");
+      checkRecord(second, secondIds[i], -i, "the other table");
+    }
+
+  TEST_CHECK(closeTable(first));
+  checkRecord(second, secondIds[7], -7, "the other table");
+  TEST_CHECK(closeTable(second));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(deleteTable(OTHER_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(firstSchema);
+  freeSchema(secondSchema);
+  free(first);
+  free(second);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testCatalogReload (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(25);
+  Record *r;
+  RID id;
+  int i;
+  testName = "tables are found in the catalog after a restart";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  for (i = 0; i < 10; i++)
+    {
+      r = testRecord(schema, i, "persistent");
+      TEST_CHECK(insertRecord(table, r));
+      id = r->id;
+      freeRecord(r);
+    }
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(shutdownRecordManager());
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+  ASSERT_EQUALS_INT(2, table->schema->numAttr, "attributes of the schema");
+  ASSERT_EQUALS_STRING("a", table->schema->attrNames[0], "name of the first attribute");
+  ASSERT_EQUALS_STRING("b", table->schema->attrNames[1], "name of the second attribute");
+  ASSERT_EQUALS_INT(DT_STRING, table->schema->dataTypes[1], "type of the second attribute");
+  ASSERT_EQUALS_INT(25, table->schema->typeLength[1], "length of the second attribute");
+  ASSERT_EQUALS_INT(10, getNumTuples(table), "tuples after the restart");
+  checkRecord(table, id, 9, "persistent");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testTableInUse (void)
+{
+  RM_TableData *table = (RM_TableData *) malloc(sizeof(RM_TableData));
+  Schema *schema = testSchema(10);
+  RC rc;
+  testName = "an open table is neither deleted nor created again";
+
+  TEST_CHECK(initRecordManager(NULL));
+  TEST_CHECK(createTable(TEST_TABLE, schema));
+  TEST_CHECK(openTable(table, TEST_TABLE));
+
+  rc = deleteTable(TEST_TABLE);
+  ASSERT_EQUALS_INT(RC_RM_TABLE_IN_USE, rc, "deleting an open table");
+  rc = createTable(TEST_TABLE, schema);
+  ASSERT_EQUALS_INT(RC_RM_TABLE_IN_USE, rc, "creating an open table again");
+
+  TEST_CHECK(closeTable(table));
+  TEST_CHECK(deleteTable(TEST_TABLE));
+  TEST_CHECK(shutdownRecordManager());
+  freeSchema(schema);
+  free(table);
+  TEST_DONE();
+}
+
+// ************************************************************
+// a schema (a INT, b STRING of `stringLength` characters) with key a
+Schema *
+testSchema (int stringLength)
+{
+  char **names = (char **) malloc(sizeof(char *) * 2);
+  DataType *dataTypes = (DataType *) malloc(sizeof(DataType) * 2);
+  int *sizes = (int *) malloc(sizeof(int) * 2);
+  int *keys = (int *) malloc(sizeof(int));
+
+  names[0] = strdup("a");
+  names[1] = strdup("b");
+  dataTypes[0] = DT_INT;
+  dataTypes[1] = DT_STRING;
+  sizes[0] = 0;
+  sizes[1] = stringLength;
+  keys[0] = 0;
+
+  return createSchema(2, names, dataTypes, sizes, 1, keys);
+}
+
+Record *
+testRecord (Schema *schema, int a, char *b)
+{
+  Record *result;
+  Value *value;
+
+  TEST_CHECK(createRecord(&result, schema));
+
+  MAKE_VALUE(value, DT_INT, a);
+  TEST_CHECK(setAttr(result, schema, 0, value));
+  freeVal(value);
+
+  MAKE_STRING_VALUE(value, b);
+  TEST_CHECK(setAttr(result, schema, 1, value));
+  freeVal(value);
+
+  return result;
+}
+
+// a string of `length` times `c`
+char *
+repeatedString (char c, int length)
+{
+  char *result = (char *) malloc(length + 1);
+
+  memset(result, c, length);
+  result[length] = '\0';
+  return result;
+}
+
+// reads the record `id` and compares its attributes
+void
+checkRecord (RM_TableData *table, RID id, int a, char *b)
+{
+  Record *r;
+  Value *value;
+
+  TEST_CHECK(createRecord(&r, table->schema));
+  TEST_CHECK(getRecord(table, id, r));
+  ASSERT_EQUALS_RID(id, r->id, "the record has the id it was read with");
+
+  TEST_CHECK(getAttr(r, table->schema, 0, &value));
+  ASSERT_EQUALS_INT(a, value->v.intV, "attribute a");
+  freeVal(value);
+
+  TEST_CHECK(getAttr(r, table->schema, 1, &value));
+  ASSERT_TRUE(strcmp(b, value->v.stringV) == 0, "attribute b");
+  freeVal(value);
+
+  freeRecord(r);
+}
+
+// the number of records a scan without a condition returns
+int
+countRecords (RM_TableData *table)
+{
+  RM_ScanHandle *scan = (RM_ScanHandle *) malloc(sizeof(RM_ScanHandle));
+  Expr *all;
+  Record *r;
+  RC rc;
+  int count = 0;
+
+  MAKE_CONS(all, stringToValue("btrue"));
+  TEST_CHECK(createRecord(&r, table->schema));
+  TEST_CHECK(startScan(table, scan, all));
+  while ((rc = next(scan, r)) == RC_OK)
+    count++;
+  ASSERT_EQUALS_INT(RC_RM_NO_MORE_TUPLES, rc, "the scan ends without an error");
+  TEST_CHECK(closeScan(scan));
+
+  freeRecord(r);
+  freeExpr(all);
+  free(scan);
+  return count;
+}
@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dberror.h"
+#include "storage_mgr.h"
+#include "buffer_mgr.h"
+#include "page_trace.h"
+#include "test_helper.h"
+
+#define TEST_FILE "testtrace.bin"
+#define TRACE_FILE "testtrace.trace"
+#define TRACE_SIM "./trace_sim"
+#define NUM_STRATEGIES 6 // FIFO, LRU, CLOCK, LFU, LRU-2 and ARC, the columns trace_sim prints
+#define MAX_LINE 1024
+#define POOL_PAGES 8
+#define SCANNED_PAGES 20
+#define SCANS 2
+
+// test methods
+static void testKnownMissCounts (void);
+static void testTraceOfPool (void);
+
+// helper methods
+static void writeTrace (const PageNumber *pageNums, int n);
+static int simulate (const char *sizes, long misses[][NUM_STRATEGIES], long *pins, int *pages);
+
+// test name
+char *testName;
+
+// main method
+int
+main (void)
+{
+  testName = "";
+
+  initStorageManager();
+
+  testKnownMissCounts();
+  testTraceOfPool();
+
+  return 0;
+}
+
+// ************************************************************
+void
+testKnownMissCounts (void)
+{
+  // Belady's reference string, FIFO misses more with 4 frames than with 3
+  PageNumber pageNums[] = { 1, 2, 3, 4, 1, 2, 5, 1, 2, 3, 4, 5 };
+  long expected[2][NUM_STRATEGIES] = {
+    { 9, 10, 10, 10, 10, 10 },
+    { 10, 8, 8, 8, 8, 7 }
+  };
+  long misses[2][NUM_STRATEGIES], pins;
+  int pages, numSizes, size, s;
+  testName = "Replaying a fixed trace gives the known misses of each strategy";
+
+  writeTrace(pageNums, 12);
+  numSizes = simulate("3,4", misses, &pins, &pages);
+  ASSERT_EQUALS_INT(2, numSizes, "a line per pool size");
+  ASSERT_EQUALS_INT(12, (int) pins, "pins of the trace");
+  ASSERT_EQUALS_INT(5, pages, "pages of the trace");
+
+  for (size = 0; size < 2; size++)
+    for (s = 0; s < NUM_STRATEGIES; s++)
+      ASSERT_EQUALS_INT((int) expected[size][s], (int) misses[size][s], "misses of a strategy");
+
+  remove(TRACE_FILE);
+  TEST_DONE();
+}
+
+// ************************************************************
+void
+testTraceOfPool (void)
+{
+  BM_BufferPool *bm = MAKE_POOL();
+  BM_PageHandle *h = MAKE_PAGE_HANDLE();
+  SM_FileHandle fh;
+  BM_PoolStats stats;
+  long misses[1][NUM_STRATEGIES], pins;
+  int pages, numSizes, scan, i;
+  testName = "trace_sim reads the trace startPageTrace writes";
+
+  TEST_CHECK(createPageFile(TEST_FILE));
+  TEST_CHECK(openPageFile(TEST_FILE, &fh));
+  TEST_CHECK(ensureCapacity(SCANNED_PAGES, &fh));
+  TEST_CHECK(closePageFile(&fh));
+
+  TEST_CHECK(initBufferPool(bm, TEST_FILE, POOL_PAGES, RS_LRU, NULL));
+  TEST_CHECK(startPageTrace(bm, TRACE_FILE, 4 * SCANS * SCANNED_PAGES));
+  for (scan = 0; scan < SCANS; scan++)
+    for (i = 0; i < SCANNED_PAGES; i++)
+      {
+        TEST_CHECK(pinPage(bm, h, i));
+        TEST_CHECK(unpinPage(bm, h));
+      }
+  TEST_CHECK(stopPageTrace(bm));
+  TEST_CHECK(getPoolStats(bm, &stats));
+
+  // scans of more pages than the pool holds miss on every pin, in the pool and under LRU
+  numSizes = simulate("8", misses, &pins, &pages);
+  ASSERT_EQUALS_INT(1, numSizes, "a line for the pool size");
+  ASSERT_EQUALS_INT(SCANS * SCANNED_PAGES, (int) pins, "every pin is in the trace");
+  ASSERT_EQUALS_INT(SCANNED_PAGES, pages, "every page is in the trace");
+  ASSERT_EQUALS_INT((int) stats.misses, (int) misses[0][1], "LRU misses as often as the pool did");
+
+  TEST_CHECK(shutdownBufferPool(bm));
+  TEST_CHECK(destroyPageFile(TEST_FILE));
+  remove(TRACE_FILE);
+  free(bm);
+  free(h);
+  TEST_DONE();
+}
+
+// ************************************************************
+// writes TRACE_FILE with a pin of each of the pages, as startPageTrace would
+void
+writeTrace (const PageNumber *pageNums, int n)
+{
+  FILE *out = fopen(TRACE_FILE, "wb");
+  PageTraceHeader header;
+  PageTraceEvent event;
+  int i;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = PAGE_TRACE_MAGIC;
+  header.version = PAGE_TRACE_VERSION;
+  header.capacity = n;
+  header.numFrames = 3;
+  header.numEvents = n;
+  fwrite(&header, sizeof(header), 1, out);
+
+  for (i = 0; i < n; i++)
+    {
+      memset(&event, 0, sizeof(event));
+      event.time = i;
+      event.pageNum = pageNums[i];
+      event.kind = PAGE_TRACE_MISS;
+      fwrite(&event, sizeof(event), 1, out);
+    }
+  fclose(out);
+}
+
+// runs trace_sim on TRACE_FILE for the pool sizes `sizes`, returns the number of sizes it printed
+int
+simulate (const char *sizes, long misses[][NUM_STRATEGIES], long *pins, int *pages)
+{
+  char command[MAX_LINE], line[MAX_LINE];
+  int numSizes = 0, frames, status;
+  FILE *in;
+
+  sprintf(command, "%s -c -s %s %s", TRACE_SIM, sizes, TRACE_FILE);
+  in = popen(command, "r");
+  ASSERT_TRUE(in != NULL, "trace_sim runs");
+
+  *pins = -1;
+  *pages = -1;
+  while (fgets(line, sizeof(line), in) != NULL)
+    {
+      long *row = misses[numSizes];
+      if (sscanf(line, "# " TRACE_FILE ": %ld pins of %d pages", pins, pages) == 2)
+        continue;
+      if (sscanf(line, "%d %ld %ld %ld %ld %ld %ld", &frames, &row[0], &row[1], &row[2],
+                 &row[3], &row[4], &row[5]) == NUM_STRATEGIES + 1)
+        numSizes++;
+    }
+  status = pclose(in);
+  ASSERT_EQUALS_INT(0, status, "trace_sim ends without an error");
+  return numSizes;
+}
@@ -0,0 +1,675 @@
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<math.h>
+#include "page_trace.h"
+
+/*
+ * trace_sim - replays a page trace written by startPageTrace() against several replacement
+ * strategies and pool sizes.
+ *
+ *     trace_sim [-c] [-s frames,frames,...] [-w windows] [-b buckets] traceFile
+ *
+ * For every pool size it prints the miss ratio of FIFO, LRU, CLOCK, LFU, LRU-2 and ARC, one
+ * line per size, so the columns are the miss ratio curves of the strategies. With -c it prints
+ * the number of misses instead, e.g. to compare against known counts. Without -s the
+ * sizes are the powers of two up to the number of distinct pages. After the curves it prints a
+ * heat map per page file: one row per time window, one column per range of pages, darker
+ * characters for more pins.
+ *
+ * Only pins are replayed, the simulated pools never hold a page back because it is pinned.
+ */
+
+#define DEFAULT_HEAT_WINDOWS 20
+#define DEFAULT_HEAT_BUCKETS 64
+#define MAX_SIZES 64
+#define NO_PAGE_ID -1
+
+static const char HEAT_SHADES[] = " .:-=+*#%@";
+
+// the pins of a trace, pages renumbered 0..numPages-1 in order of their first pin
+typedef struct Trace {
+	int *refs;
+	uint64_t *times;
+	long numRefs;
+	long tracedMisses;
+	int numPages;
+	int *pageFile;
+	int *pageNum;
+	uint32_t tracedFrames;
+} Trace;
+
+/* ==================================================== */
+
+// (fileId, pageNum) -> page id, open addressing
+typedef struct PageMap {
+	uint64_t *keys;
+	int *ids;
+	long size;
+} PageMap;
+
+static uint64_t pageKey(int fileId, int32_t pageNum) {
+	return ((uint64_t) fileId << 32) | (uint32_t) pageNum;
+}
+
+static long slotOf(PageMap *map, uint64_t key) {
+	long slot = (long) ((key * 0x9E3779B97F4A7C15ULL) >> 20) & (map->size - 1);
+	while (map->ids[slot] != NO_PAGE_ID && map->keys[slot] != key) {
+		slot = (slot + 1) & (map->size - 1);
+	}
+	return slot;
+}
+
+/**
+ * Description:
+ * Reads the pins of a trace file in the order they were recorded, oldest first.
+ *
+ * @return 0, or -1 after printing why the file could not be read.
+ */
+static int readTrace(const char *fileName, Trace *trace) {
+	FILE *file = fopen(fileName, "rb");
+	if (file == NULL) {
+		fprintf(stderr, "trace_sim: can not open %s\n", fileName);
+		return -1;
+	}
+
+	PageTraceHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != PAGE_TRACE_MAGIC
+			|| header.version != PAGE_TRACE_VERSION || header.capacity == 0) {
+		fprintf(stderr, "trace_sim: %s is not a page trace\n", fileName);
+		fclose(file);
+		return -1;
+	}
+
+	uint64_t numEvents = header.numEvents < header.capacity ? header.numEvents : header.capacity;
+	uint64_t first = header.numEvents < header.capacity ? 0 : header.numEvents % header.capacity;
+
+	PageTraceEvent *events = malloc(header.capacity * sizeof(PageTraceEvent));
+	if (events == NULL || fread(events, sizeof(PageTraceEvent), header.capacity, file) != header.capacity) {
+		fprintf(stderr, "trace_sim: %s is truncated\n", fileName);
+		free(events);
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+
+	PageMap map;
+	map.size = 1;
+	while (map.size < 2 * (long) numEvents + 2) {
+		map.size *= 2;
+	}
+	map.keys = malloc(map.size * sizeof(uint64_t));
+	map.ids = malloc(map.size * sizeof(int));
+	for (long i = 0; i < map.size; i++) {
+		map.ids[i] = NO_PAGE_ID;
+	}
+
+	memset(trace, 0, sizeof(Trace));
+	trace->refs = malloc((numEvents + 1) * sizeof(int));
+	trace->times = malloc((numEvents + 1) * sizeof(uint64_t));
+	trace->pageFile = malloc((numEvents + 1) * sizeof(int));
+	trace->pageNum = malloc((numEvents + 1) * sizeof(int));
+	trace->tracedFrames = header.numFrames;
+
+	for (uint64_t i = 0; i < numEvents; i++) {
+		PageTraceEvent *event = &events[(first + i) % header.capacity];
+		if (event->kind != PAGE_TRACE_HIT && event->kind != PAGE_TRACE_MISS) {
+			continue;
+		}
+
+		uint64_t key = pageKey(event->fileId, event->pageNum);
+		long slot = slotOf(&map, key);
+		if (map.ids[slot] == NO_PAGE_ID) {
+			map.keys[slot] = key;
+			map.ids[slot] = trace->numPages;
+			trace->pageFile[trace->numPages] = event->fileId;
+			trace->pageNum[trace->numPages] = event->pageNum;
+			trace->numPages++;
+		}
+
+		trace->refs[trace->numRefs] = map.ids[slot];
+		trace->times[trace->numRefs] = event->time;
+		trace->numRefs++;
+		if (event->kind == PAGE_TRACE_MISS) {
+			trace->tracedMisses++;
+		}
+	}
+
+	free(map.keys);
+	free(map.ids);
+	free(events);
+	return 0;
+}
+
+/* ==================================================== */
+
+/*
+ * Doubly linked lists over page ids, used by LRU and ARC. A page is in at most one list.
+ * The heads of the lists are the entries after the pages, `list[p]` is the list page p is in.
+ */
+typedef struct PageLists {
+	int *prev;
+	int *next;
+	int *list;
+	int *length;
+	int numPages;
+} PageLists;
+
+#define NOT_LISTED -1
+
+static void initLists(PageLists *lists, int numPages, int numLists) {
+	lists->numPages = numPages;
+	lists->prev = malloc((numPages + numLists) * sizeof(int));
+	lists->next = malloc((numPages + numLists) * sizeof(int));
+	lists->list = malloc(numPages * sizeof(int));
+	lists->length = calloc(numLists, sizeof(int));
+
+	for (int p = 0; p < numPages; p++) {
+		lists->list[p] = NOT_LISTED;
+	}
+	for (int l = 0; l < numLists; l++) {
+		lists->prev[numPages + l] = lists->next[numPages + l] = numPages + l;
+	}
+}
+
+static void freeLists(PageLists *lists) {
+	free(lists->prev);
+	free(lists->next);
+	free(lists->list);
+	free(lists->length);
+}
+
+static void unlinkPage(PageLists *lists, int page) {
+	lists->next[lists->prev[page]] = lists->next[page];
+	lists->prev[lists->next[page]] = lists->prev[page];
+	lists->length[lists->list[page]]--;
+	lists->list[page] = NOT_LISTED;
+}
+
+// puts a page at the most recently used end of a list
+static void pushPage(PageLists *lists, int list, int page) {
+	if (lists->list[page] != NOT_LISTED) {
+		unlinkPage(lists, page);
+	}
+	int head = lists->numPages + list;
+	lists->prev[page] = lists->prev[head];
+	lists->next[page] = head;
+	lists->next[lists->prev[head]] = page;
+	lists->prev[head] = page;
+	lists->list[page] = list;
+	lists->length[list]++;
+}
+
+// takes the least recently used page off a list
+static int popPage(PageLists *lists, int list) {
+	int page = lists->next[lists->numPages + list];
+	unlinkPage(lists, page);
+	return page;
+}
+
+/* ==================================================== */
+
+/*
+ * Binary min heap of the resident pages ordered by (key1, key2), used by LFU and LRU-K.
+ * position[p] is the index of page p in the heap, -1 if it is not resident.
+ */
+typedef struct PageHeap {
+	int *pages;
+	int *position;
+	long *key1;
+	long *key2;
+	int size;
+} PageHeap;
+
+static void initHeap(PageHeap *heap, int numPages, int frames) {
+	heap->pages = malloc(frames * sizeof(int));
+	heap->position = malloc(numPages * sizeof(int));
+	heap->key1 = calloc(numPages, sizeof(long));
+	heap->key2 = calloc(numPages, sizeof(long));
+	heap->size = 0;
+	for (int p = 0; p < numPages; p++) {
+		heap->position[p] = -1;
+	}
+}
+
+static void freeHeap(PageHeap *heap) {
+	free(heap->pages);
+	free(heap->position);
+	free(heap->key1);
+	free(heap->key2);
+}
+
+static int heapLess(PageHeap *heap, int a, int b) {
+	return heap->key1[a] < heap->key1[b] || (heap->key1[a] == heap->key1[b] && heap->key2[a] < heap->key2[b]);
+}
+
+static void heapSwap(PageHeap *heap, int i, int j) {
+	int page = heap->pages[i];
+	heap->pages[i] = heap->pages[j];
+	heap->pages[j] = page;
+	heap->position[heap->pages[i]] = i;
+	heap->position[heap->pages[j]] = j;
+}
+
+static void siftUp(PageHeap *heap, int i) {
+	while (i > 0 && heapLess(heap, heap->pages[i], heap->pages[(i - 1) / 2])) {
+		heapSwap(heap, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+}
+
+static void siftDown(PageHeap *heap, int i) {
+	for (;;) {
+		int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+		if (left < heap->size && heapLess(heap, heap->pages[left], heap->pages[smallest])) {
+			smallest = left;
+		}
+		if (right < heap->size && heapLess(heap, heap->pages[right], heap->pages[smallest])) {
+			smallest = right;
+		}
+		if (smallest == i) {
+			return;
+		}
+		heapSwap(heap, i, smallest);
+		i = smallest;
+	}
+}
+
+static void heapInsert(PageHeap *heap, int page) {
+	heap->pages[heap->size] = page;
+	heap->position[page] = heap->size;
+	heap->size++;
+	siftUp(heap, heap->size - 1);
+}
+
+static int heapPop(PageHeap *heap) {
+	int page = heap->pages[0];
+	heapSwap(heap, 0, heap->size - 1);
+	heap->size--;
+	heap->position[page] = -1;
+	siftDown(heap, 0);
+	return page;
+}
+
+/* ==================================================== */
+
+/**
+ * Description:
+ * FIFO replaces the page that was read in first.
+ *
+ * @return the number of pins that missed.
+ */
+static long simulateFifo(const Trace *trace, int frames) {
+	char *resident = calloc(trace->numPages, 1);
+	int *queue = malloc(frames * sizeof(int));
+	int head = 0, used = 0;
+	long misses = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		if (resident[page]) {
+			continue;
+		}
+		misses++;
+		if (used == frames) {
+			resident[queue[head]] = 0;
+			queue[head] = page;
+			head = (head + 1) % frames;
+		} else {
+			queue[used++] = page;
+		}
+		resident[page] = 1;
+	}
+
+	free(resident);
+	free(queue);
+	return misses;
+}
+
+/**
+ * Description:
+ * LRU replaces the page that was pinned the longest time ago.
+ */
+static long simulateLru(const Trace *trace, int frames) {
+	PageLists lists;
+	initLists(&lists, trace->numPages, 1);
+	long misses = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		if (lists.list[page] == NOT_LISTED) {
+			misses++;
+			if (lists.length[0] == frames) {
+				popPage(&lists, 0);
+			}
+		}
+		pushPage(&lists, 0, page);
+	}
+
+	freeLists(&lists);
+	return misses;
+}
+
+/**
+ * Description:
+ * CLOCK sweeps a hand over the frames and replaces the first page that was not pinned since
+ * the hand last passed it.
+ */
+static long simulateClock(const Trace *trace, int frames) {
+	int *frame = malloc(frames * sizeof(int));
+	char *referenced = calloc(trace->numPages, 1);
+	char *resident = calloc(trace->numPages, 1);
+	int hand = 0, used = 0;
+	long misses = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		if (resident[page]) {
+			referenced[page] = 1;
+			continue;
+		}
+		misses++;
+		if (used < frames) {
+			frame[used++] = page;
+		} else {
+			while (referenced[frame[hand]]) {
+				referenced[frame[hand]] = 0;
+				hand = (hand + 1) % frames;
+			}
+			resident[frame[hand]] = 0;
+			frame[hand] = page;
+			hand = (hand + 1) % frames;
+		}
+		resident[page] = 1;
+		referenced[page] = 0;
+	}
+
+	free(frame);
+	free(referenced);
+	free(resident);
+	return misses;
+}
+
+/**
+ * Description:
+ * LFU replaces the page pinned the fewest times since it was read in, the least recently pinned
+ * one of those.
+ */
+static long simulateLfu(const Trace *trace, int frames) {
+	PageHeap heap;
+	initHeap(&heap, trace->numPages, frames);
+	long misses = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		if (heap.position[page] >= 0) {
+			heap.key1[page]++;
+			heap.key2[page] = i;
+			siftDown(&heap, heap.position[page]);
+			continue;
+		}
+		misses++;
+		if (heap.size == frames) {
+			heapPop(&heap);
+		}
+		heap.key1[page] = 1;
+		heap.key2[page] = i;
+		heapInsert(&heap, page);
+	}
+
+	freeHeap(&heap);
+	return misses;
+}
+
+/**
+ * Description:
+ * LRU-2 replaces the page whose second to last pin is the oldest. Pages pinned only once go
+ * first, in LRU order. The pin history is kept for pages that were replaced as well.
+ */
+static long simulateLru2(const Trace *trace, int frames) {
+	PageHeap heap;
+	initHeap(&heap, trace->numPages, frames);
+	long misses = 0;
+
+	// key1 is the time of the second to last pin (0 for none), key2 that of the last one
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		long now = i + 1;
+
+		if (heap.key2[page] > 0) {
+			heap.key1[page] = heap.key2[page];
+		}
+		heap.key2[page] = now;
+
+		if (heap.position[page] >= 0) {
+			siftDown(&heap, heap.position[page]);
+			continue;
+		}
+		misses++;
+		if (heap.size == frames) {
+			heapPop(&heap);
+		}
+		heapInsert(&heap, page);
+	}
+
+	freeHeap(&heap);
+	return misses;
+}
+
+// the lists of ARC
+enum { ARC_T1, ARC_T2, ARC_B1, ARC_B2, ARC_LISTS };
+
+/**
+ * Description:
+ * ARC (Megiddo and Modha) splits the pool between pages pinned once (T1) and pages pinned
+ * again (T2), and moves the split towards whichever of the two ghost lists of recently
+ * replaced pages (B1, B2) gets pinned.
+ */
+static long simulateArc(const Trace *trace, int frames) {
+	PageLists lists;
+	initLists(&lists, trace->numPages, ARC_LISTS);
+	int *length = lists.length;
+	double target = 0;
+	long misses = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		int list = lists.list[page];
+
+		if (list == ARC_T1 || list == ARC_T2) {
+			pushPage(&lists, ARC_T2, page);
+			continue;
+		}
+		misses++;
+
+		if (list == ARC_B1) {
+			double delta = length[ARC_B1] >= length[ARC_B2] ? 1 : (double) length[ARC_B2] / length[ARC_B1];
+			target = fmin(frames, target + delta);
+		} else if (list == ARC_B2) {
+			double delta = length[ARC_B2] >= length[ARC_B1] ? 1 : (double) length[ARC_B1] / length[ARC_B2];
+			target = fmax(0, target - delta);
+		} else if (length[ARC_T1] + length[ARC_B1] == frames) {
+			if (length[ARC_T1] < frames) {
+				popPage(&lists, ARC_B1);
+			} else {
+				popPage(&lists, ARC_T1);
+			}
+		} else if (length[ARC_T1] + length[ARC_T2] + length[ARC_B1] + length[ARC_B2] == 2 * frames) {
+			popPage(&lists, ARC_B2);
+		}
+
+		// replace a page if the pool is full
+		if (length[ARC_T1] + length[ARC_T2] >= frames) {
+			if (length[ARC_T1] > 0 && (length[ARC_T1] > target || (list == ARC_B2 && length[ARC_T1] == (int) target))) {
+				pushPage(&lists, ARC_B1, popPage(&lists, ARC_T1));
+			} else {
+				pushPage(&lists, ARC_B2, popPage(&lists, ARC_T2));
+			}
+		}
+
+		pushPage(&lists, (list == ARC_B1 || list == ARC_B2) ? ARC_T2 : ARC_T1, page);
+	}
+
+	freeLists(&lists);
+	return misses;
+}
+
+typedef long (*Simulation)(const Trace *trace, int frames);
+
+static const char *STRATEGY_NAMES[] = { "FIFO", "LRU", "CLOCK", "LFU", "LRU-2", "ARC" };
+static const Simulation SIMULATIONS[] = { simulateFifo, simulateLru, simulateClock, simulateLfu, simulateLru2, simulateArc };
+#define NUM_STRATEGIES ((int) (sizeof(SIMULATIONS) / sizeof(SIMULATIONS[0])))
+
+/* ==================================================== */
+
+/**
+ * Description:
+ * Prints the heat map of one page file: pins per time window and range of pages.
+ */
+static void printHeatMap(const Trace *trace, int fileId, int windows, int buckets) {
+	int minPage = -1, maxPage = -1;
+	for (int p = 0; p < trace->numPages; p++) {
+		if (trace->pageFile[p] == fileId) {
+			if (minPage < 0 || trace->pageNum[p] < minPage) {
+				minPage = trace->pageNum[p];
+			}
+			if (trace->pageNum[p] > maxPage) {
+				maxPage = trace->pageNum[p];
+			}
+		}
+	}
+	if (minPage < 0) {
+		return;
+	}
+
+	// threads stamp their events a little before they get a slot, so times are not quite in order
+	uint64_t start = trace->times[0], end = trace->times[0];
+	for (long i = 1; i < trace->numRefs; i++) {
+		start = trace->times[i] < start ? trace->times[i] : start;
+		end = trace->times[i] > end ? trace->times[i] : end;
+	}
+	uint64_t duration = end - start + 1;
+
+	int pagesPerBucket = (maxPage - minPage) / buckets + 1;
+	int columns = (maxPage - minPage) / pagesPerBucket + 1;
+	long *heat = calloc((long) windows * columns, sizeof(long));
+	long hottest = 0;
+
+	for (long i = 0; i < trace->numRefs; i++) {
+		int page = trace->refs[i];
+		if (trace->pageFile[page] != fileId) {
+			continue;
+		}
+		int row = (int) ((trace->times[i] - start) * windows / duration);
+		int column = (trace->pageNum[page] - minPage) / pagesPerBucket;
+		long cell = ++heat[(long) row * columns + column];
+		if (cell > hottest) {
+			hottest = cell;
+		}
+	}
+
+	printf("\n# heat map of file %d, pages %d to %d, %d pages per column, %.3f ms per row, hottest cell %ld pins\n",
+			fileId, minPage, maxPage, pagesPerBucket, duration / 1e6 / windows, hottest);
+	for (int row = 0; row < windows; row++) {
+		putchar('|');
+		for (int column = 0; column < columns; column++) {
+			long cell = heat[(long) row * columns + column];
+			int shade = cell == 0 ? 0 : 1 + (int) (log1p(cell) / log1p(hottest) * (sizeof(HEAT_SHADES) - 3));
+			putchar(HEAT_SHADES[shade]);
+		}
+		printf("|\n");
+	}
+	free(heat);
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: trace_sim [-c] [-s frames,frames,...] [-w windows] [-b buckets] traceFile\n");
+}
+
+int main(int argc, char **argv) {
+	int sizes[MAX_SIZES];
+	int numSizes = 0;
+	int windows = DEFAULT_HEAT_WINDOWS, buckets = DEFAULT_HEAT_BUCKETS;
+	int counts = 0;
+	const char *fileName = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-c") == 0) {
+			counts = 1;
+		} else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+			for (char *size = strtok(argv[++i], ","); size != NULL && numSizes < MAX_SIZES; size = strtok(NULL, ",")) {
+				if (atoi(size) > 0) {
+					sizes[numSizes++] = atoi(size);
+				}
+			}
+		} else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+			windows = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+			buckets = atoi(argv[++i]);
+		} else if (argv[i][0] != '-' && fileName == NULL) {
+			fileName = argv[i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (fileName == NULL || windows < 1 || buckets < 1) {
+		usage();
+		return 1;
+	}
+
+	Trace trace;
+	if (readTrace(fileName, &trace) != 0) {
+		return 1;
+	}
+	if (trace.numRefs == 0) {
+		printf("# %s holds no pins\n", fileName);
+		return 0;
+	}
+
+	if (numSizes == 0) {
+		for (int frames = 1; frames < trace.numPages && numSizes < MAX_SIZES - 1; frames *= 2) {
+			sizes[numSizes++] = frames;
+		}
+		sizes[numSizes++] = trace.numPages;
+	}
+
+	printf("# %s: %ld pins of %d pages, miss ratio %.4f in the traced pool of %u frames\n", fileName,
+			trace.numRefs, trace.numPages, (double) trace.tracedMisses / trace.numRefs, trace.tracedFrames);
+	printf(counts ? "# misses\nframes" : "# miss ratio curves\nframes");
+	for (int s = 0; s < NUM_STRATEGIES; s++) {
+		printf("\t%s", STRATEGY_NAMES[s]);
+	}
+	printf("\n");
+
+	for (int i = 0; i < numSizes; i++) {
+		printf("%d", sizes[i]);
+		for (int s = 0; s < NUM_STRATEGIES; s++) {
+			long misses = SIMULATIONS[s](&trace, sizes[i]);
+			if (counts) {
+				printf("\t%ld", misses);
+			} else {
+				printf("\t%.4f", (double) misses / trace.numRefs);
+			}
+		}
+		printf("\n");
+	}
+
+	char *traced = calloc(UINT16_MAX + 1, 1);
+	for (int p = 0; p < trace.numPages; p++) {
+		traced[trace.pageFile[p]] = 1;
+	}
+	for (int fileId = 0; fileId <= UINT16_MAX; fileId++) {
+		if (traced[fileId]) {
+			printHeatMap(&trace, fileId, windows, buckets);
+		}
+	}
+	free(traced);
+
+	free(trace.refs);
+	free(trace.times);
+	free(trace.pageFile);
+	free(trace.pageNum);
+	return 0;
+}